@@ -0,0 +1,38 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for the Cinema 4D R15 API, the
+ *    subset that the plugins of this repository use
+ */
+
+#ifndef C4D_HEADLESS_C4D_H
+#define C4D_HEADLESS_C4D_H
+
+#include "c4d_system.h"
+#include "c4d_basearray.h"
+#include "c4d_string.h"
+#include "c4d_gedata.h"
+#include "c4d_file.h"
+#include "c4d_nodes.h"
+#include "c4d_plugins.h"
+#include "c4d_gui.h"
+
+#endif /* C4D_HEADLESS_C4D_H */
@@ -0,0 +1,250 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for maxon::BaseArray
+ */
+
+#ifndef C4D_HEADLESS_BASEARRAY_H
+#define C4D_HEADLESS_BASEARRAY_H
+
+#include "c4d_system.h"
+
+namespace maxon {
+
+/**
+ * A dynamic array that reports memory errors through its return
+ * values instead of exceptions. Append() and Insert() return a
+ * pointer to the new element or nullptr, the methods that allocate
+ * return false on a memory error and leave the array unchanged.
+ * Like the real BaseArray it can not be copied, use CopyFrom().
+ */
+template <typename T>
+class BaseArray {
+
+public:
+
+    BaseArray() : m_ptr(nullptr), m_count(0), m_capacity(0) { }
+
+    ~BaseArray() {
+        Reset();
+    }
+
+    BaseArray(BaseArray&& other)
+    : m_ptr(other.m_ptr), m_count(other.m_count), m_capacity(other.m_capacity) {
+        other.m_ptr = nullptr;
+        other.m_count = other.m_capacity = 0;
+    }
+
+    BaseArray& operator = (BaseArray&& other) {
+        if (this != &other) {
+            Reset();
+            SwapWith(other);
+        }
+        return *this;
+    }
+
+    Int GetCount() const {
+        return m_count;
+    }
+
+    Int GetCapacityCount() const {
+        return m_capacity;
+    }
+
+    /**
+     * Returns nullptr if the array is empty.
+     */
+    T* GetFirst() {
+        return m_count > 0 ? m_ptr : nullptr;
+    }
+
+    const T* GetFirst() const {
+        return m_count > 0 ? m_ptr : nullptr;
+    }
+
+    T* GetLast() {
+        return m_count > 0 ? m_ptr + m_count - 1 : nullptr;
+    }
+
+    T& operator [] (Int index) {
+        DebugAssert(index >= 0 && index < m_count);
+        return m_ptr[index];
+    }
+
+    const T& operator [] (Int index) const {
+        DebugAssert(index >= 0 && index < m_count);
+        return m_ptr[index];
+    }
+
+    Bool EnsureCapacity(Int count) {
+        if (count <= m_capacity)
+            return true;
+        return Reallocate(count);
+    }
+
+    /**
+     * Sets the number of elements, new elements are default
+     * constructed.
+     */
+    Bool Resize(Int count) {
+        if (count < 0)
+            return false;
+        if (count > m_capacity && !Grow(count))
+            return false;
+        for (Int i=m_count; i < count; i++)
+            new (m_ptr + i) T();
+        for (Int i=count; i < m_count; i++)
+            m_ptr[i].~T();
+        m_count = count;
+        return true;
+    }
+
+    T* Append() {
+        if (m_count == m_capacity && !Grow(m_count + 1))
+            return nullptr;
+        T* element = new (m_ptr + m_count) T();
+        m_count++;
+        return element;
+    }
+
+    T* Append(const T& value) {
+        if (m_count == m_capacity) {
+            // The value can be an element of this array.
+            T copy(value);
+            if (!Grow(m_count + 1))
+                return nullptr;
+            T* element = new (m_ptr + m_count) T(std::move(copy));
+            m_count++;
+            return element;
+        }
+        T* element = new (m_ptr + m_count) T(value);
+        m_count++;
+        return element;
+    }
+
+    T* Insert(Int position, const T& value) {
+        if (position < 0 || position > m_count)
+            return nullptr;
+        T copy(value);
+        if (m_count == m_capacity && !Grow(m_count + 1))
+            return nullptr;
+        new (m_ptr + m_count) T();
+        m_count++;
+        for (Int i=m_count - 1; i > position; i--)
+            m_ptr[i] = std::move(m_ptr[i - 1]);
+        m_ptr[position] = std::move(copy);
+        return m_ptr + position;
+    }
+
+    /**
+     * Removes *count* elements from *position* on. Returns a pointer
+     * to the element that follows the erased ones, or nullptr if the
+     * range is invalid.
+     */
+    T* Erase(Int position, Int count=1) {
+        if (position < 0 || count < 0 || position + count > m_count)
+            return nullptr;
+        for (Int i=position; i + count < m_count; i++)
+            m_ptr[i] = std::move(m_ptr[i + count]);
+        for (Int i=m_count - count; i < m_count; i++)
+            m_ptr[i].~T();
+        m_count -= count;
+        return m_ptr + position;
+    }
+
+    Bool Pop(T* dst=nullptr) {
+        if (m_count <= 0)
+            return false;
+        if (dst) *dst = std::move(m_ptr[m_count - 1]);
+        m_ptr[--m_count].~T();
+        return true;
+    }
+
+    Bool CopyFrom(const BaseArray& other) {
+        if (this == &other)
+            return true;
+        BaseArray temp;
+        if (!temp.Reallocate(other.m_count))
+            return false;
+        for (Int i=0; i < other.m_count; i++)
+            new (temp.m_ptr + i) T(other.m_ptr[i]);
+        temp.m_count = other.m_count;
+        SwapWith(temp);
+        return true;
+    }
+
+    void SwapWith(BaseArray& other) {
+        std::swap(m_ptr, other.m_ptr);
+        std::swap(m_count, other.m_count);
+        std::swap(m_capacity, other.m_capacity);
+    }
+
+    /**
+     * Removes all elements but keeps the memory.
+     */
+    void Flush() {
+        for (Int i=0; i < m_count; i++)
+            m_ptr[i].~T();
+        m_count = 0;
+    }
+
+    /**
+     * Removes all elements and releases the memory.
+     */
+    void Reset() {
+        Flush();
+        std::free(m_ptr);
+        m_ptr = nullptr;
+        m_capacity = 0;
+    }
+
+private:
+
+    BaseArray(const BaseArray&);
+    BaseArray& operator = (const BaseArray&);
+
+    Bool Grow(Int count) {
+        return Reallocate(Max(count, m_capacity + m_capacity / 2 + 4));
+    }
+
+    Bool Reallocate(Int capacity) {
+        T* ptr = (T*) std::malloc((size_t) Max<Int>(capacity, 1) * sizeof(T));
+        if (ptr == nullptr)
+            return false;
+        for (Int i=0; i < m_count; i++) {
+            new (ptr + i) T(std::move(m_ptr[i]));
+            m_ptr[i].~T();
+        }
+        std::free(m_ptr);
+        m_ptr = ptr;
+        m_capacity = capacity;
+        return true;
+    }
+
+    T* m_ptr;
+    Int m_count;
+    Int m_capacity;
+
+};
+
+} // namespace maxon
+
+#endif /* C4D_HEADLESS_BASEARRAY_H */
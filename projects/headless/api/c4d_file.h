@@ -0,0 +1,305 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for BaseFile, HyperFile and the
+ *    AutoAlloc helpers
+ */
+
+#ifndef C4D_HEADLESS_FILE_H
+#define C4D_HEADLESS_FILE_H
+
+#include <cstdio>
+#include <vector>
+#include "c4d_gedata.h"
+
+class BaseDocument;
+
+enum FILEOPEN {
+    FILEOPEN_APPEND,
+    FILEOPEN_READ,
+    FILEOPEN_WRITE,
+    FILEOPEN_READWRITE,
+    FILEOPEN_READ_NOCACHE,
+    FILEOPEN_SHAREDREAD,
+    FILEOPEN_SHAREDWRITE,
+};
+
+enum FILEDIALOG {
+    FILEDIALOG_NONE,
+    FILEDIALOG_ANY,
+    FILEDIALOG_IGNOREOPEN,
+};
+
+enum FILESEEK {
+    FILESEEK_START,
+    FILESEEK_RELATIVE,
+};
+
+/**
+ * Allocates an object with T::Alloc() and frees it with T::Free()
+ * when going out of scope.
+ */
+template <typename T>
+class AutoAlloc {
+
+public:
+
+    AutoAlloc() : m_ptr(T::Alloc()) { }
+    explicit AutoAlloc(Int32 id) : m_ptr(T::Alloc(id)) { }
+    ~AutoAlloc() { T::Free(m_ptr); }
+
+    operator T* () const { return m_ptr; }
+    T* operator -> () const { return m_ptr; }
+    T& operator * () const { return *m_ptr; }
+
+    T* Release() {
+        T* ptr = m_ptr;
+        m_ptr = nullptr;
+        return ptr;
+    }
+
+private:
+
+    AutoAlloc(const AutoAlloc&);
+    AutoAlloc& operator = (const AutoAlloc&);
+
+    T* m_ptr;
+
+};
+
+/**
+ * Takes ownership of an object and frees it with T::Free().
+ */
+template <typename T>
+class AutoFree {
+
+public:
+
+    AutoFree() : m_ptr(nullptr) { }
+    explicit AutoFree(T* ptr) : m_ptr(ptr) { }
+    ~AutoFree() { Free(); }
+
+    void Set(T* ptr) {
+        Free();
+        m_ptr = ptr;
+    }
+
+    void Free() {
+        if (m_ptr) T::Free(m_ptr);
+        m_ptr = nullptr;
+    }
+
+    operator T* () const { return m_ptr; }
+    T* operator -> () const { return m_ptr; }
+    T& operator * () const { return *m_ptr; }
+
+    T* Release() {
+        T* ptr = m_ptr;
+        m_ptr = nullptr;
+        return ptr;
+    }
+
+private:
+
+    AutoFree(const AutoFree&);
+    AutoFree& operator = (const AutoFree&);
+
+    T* m_ptr;
+
+};
+
+/**
+ * A block of memory that a Filename in memory write mode writes to.
+ */
+class MemoryFileStruct {
+
+public:
+
+    static MemoryFileStruct* Alloc() { return NewObj(MemoryFileStruct); }
+    static void Free(MemoryFileStruct*& mfs) { DeleteObj(mfs); }
+
+    /**
+     * Returns the written bytes. With *release*, the memory is handed
+     * over to the caller, who frees it with DeleteMem().
+     */
+    void GetData(void*& data, Int& size, Bool release=false);
+
+    /**
+     * Stand-in only: the buffer the BaseFile writes to.
+     */
+    std::vector<UChar>& GetBuffer() {
+        return m_buffer;
+    }
+
+private:
+
+    std::vector<UChar> m_buffer;
+
+};
+
+/**
+ * A file on the disk or, with a Filename in memory mode, a block
+ * of memory.
+ */
+class BaseFile {
+
+public:
+
+    static BaseFile* Alloc() { return NewObj(BaseFile); }
+    static void Free(BaseFile*& file) { DeleteObj(file); }
+
+    BaseFile() : m_file(nullptr), m_write(nullptr), m_read(nullptr), m_size(0), m_pos(0),
+        m_writing(false), m_error(false) { }
+    ~BaseFile() { Close(); }
+
+    Bool Open(const Filename& name, FILEOPEN mode=FILEOPEN_READ,
+              FILEDIALOG error_dialog=FILEDIALOG_IGNOREOPEN);
+
+    /**
+     * Closes the file. Returns false if any read or write failed.
+     */
+    Bool Close();
+
+    Bool WriteBytes(const void* data, Int len);
+
+    /**
+     * Reads *len* bytes and returns the number of bytes read. Unless
+     * *just_try* is set, reading less than *len* bytes is an error.
+     */
+    Int ReadBytes(void* data, Int len, Bool just_try=false);
+
+    Int GetLength() const;
+    Int GetPosition() const { return m_pos; }
+    Bool Seek(Int pos, FILESEEK mode=FILESEEK_RELATIVE);
+
+private:
+
+    BaseFile(const BaseFile&);
+    BaseFile& operator = (const BaseFile&);
+
+    std::FILE* m_file;
+    MemoryFileStruct* m_write;
+    const UChar* m_read;
+    Int m_size;
+    Int m_pos;
+    Bool m_writing;
+    Bool m_error;
+
+};
+
+/**
+ * A file of tagged values, the format Cinema stores documents in.
+ * Every value is read back with the method of the same type it was
+ * written with, reading another type fails.
+ */
+class HyperFile {
+
+public:
+
+    static HyperFile* Alloc() { return NewObj(HyperFile); }
+    static void Free(HyperFile*& hf) { DeleteObj(hf); }
+
+    HyperFile() : m_doc(nullptr), m_ident(0), m_open(false), m_writing(false) { }
+    ~HyperFile() { Close(); }
+
+    /**
+     * Opens the file, *ident* must be the same for reading and
+     * writing.
+     */
+    Bool Open(Int32 ident, const Filename& filename, FILEOPEN mode, FILEDIALOG error_dialog);
+    Bool Close();
+
+    /**
+     * The document that is read or written, or nullptr.
+     */
+    BaseDocument* GetDocument() const {
+        return m_doc;
+    }
+
+    /**
+     * Stand-in only: sets the document returned by GetDocument().
+     */
+    void SetDocument(BaseDocument* doc) {
+        m_doc = doc;
+    }
+
+    Bool WriteChar(Char v);
+    Bool WriteUChar(UChar v);
+    Bool WriteInt16(Int16 v);
+    Bool WriteInt32(Int32 v);
+    Bool WriteUInt32(UInt32 v);
+    Bool WriteInt64(Int64 v);
+    Bool WriteUInt64(UInt64 v);
+    Bool WriteFloat(Float v);
+    Bool WriteFloat32(Float32 v);
+    Bool WriteFloat64(Float64 v);
+    Bool WriteBool(Bool v);
+    Bool WriteVector(const Vector& v);
+    Bool WriteString(const String& v);
+    Bool WriteFilename(const Filename& v);
+    Bool WriteMemory(const void* data, Int count);
+    Bool WriteContainer(const BaseContainer& v);
+    Bool WriteGeData(const GeData& v);
+
+    Bool ReadChar(Char* v);
+    Bool ReadUChar(UChar* v);
+    Bool ReadInt16(Int16* v);
+    Bool ReadInt32(Int32* v);
+    Bool ReadUInt32(UInt32* v);
+    Bool ReadInt64(Int64* v);
+    Bool ReadUInt64(UInt64* v);
+    Bool ReadFloat(Float* v);
+    Bool ReadFloat32(Float32* v);
+    Bool ReadFloat64(Float64* v);
+    Bool ReadBool(Bool* v);
+    Bool ReadVector(Vector* v);
+    Bool ReadString(String* v);
+    Bool ReadFilename(Filename* v);
+
+    /**
+     * Reads a block written with WriteMemory(). The memory is
+     * allocated with NewMem() and must be freed by the caller.
+     */
+    Bool ReadMemory(void** data, Int* size);
+    Bool ReadContainer(BaseContainer* v, Bool flush);
+    Bool ReadGeData(GeData* v);
+
+private:
+
+    HyperFile(const HyperFile&);
+    HyperFile& operator = (const HyperFile&);
+
+    Bool WriteTag(UChar tag);
+    Bool ReadTag(UChar tag);
+    Bool WriteRaw(const void* data, Int size);
+    Bool ReadRaw(void* data, Int size);
+    Bool WriteGeDataValue(const GeData& v);
+    Bool ReadGeDataValue(GeData* v);
+
+    BaseFile m_file;
+    BaseDocument* m_doc;
+    Int32 m_ident;
+    Bool m_open;
+    Bool m_writing;
+
+};
+
+#endif /* C4D_HEADLESS_FILE_H */
@@ -0,0 +1,527 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for GeData, BaseContainer and the
+ *    description classes
+ */
+
+#ifndef C4D_HEADLESS_GEDATA_H
+#define C4D_HEADLESS_GEDATA_H
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+#include "c4d_string.h"
+
+class BaseContainer;
+class BaseList2D;
+class HyperFile;
+class AtomArray;
+
+/**
+ * The base of the data of custom datatypes. The datatype plugin
+ * allocates, copies and frees it, see CustomDataTypeClass.
+ */
+class CustomDataType { };
+
+enum {
+    DA_NIL = 0,
+    DA_VOID = 14,
+    DA_LONG = 15,
+    DA_LLONG = 17,
+    DA_REAL = 19,
+    DA_TIME = 22,
+    DA_VECTOR = 23,
+    DA_MATRIX = 25,
+    DA_BYTEARRAY = 128,
+    DA_STRING = 130,
+    DA_FILENAME = 131,
+    DA_CONTAINER = 132,
+    DA_ALIASLINK = 133,
+};
+
+/**
+ * Stores a value of one of the DA_ types or of a custom datatype,
+ * whose type ID is the ID of the datatype plugin.
+ */
+class GeData {
+
+public:
+
+    GeData() : m_type(DA_NIL), m_int(0), m_float(0.0), m_container(nullptr),
+        m_custom(nullptr), m_link(nullptr) { }
+    GeData(Int32 value) : GeData() { SetInt32(value); }
+    GeData(Int64 value) : GeData() { SetInt64(value); }
+    GeData(Float value) : GeData() { SetFloat(value); }
+    GeData(const Vector& value) : GeData() { SetVector(value); }
+    GeData(const String& value) : GeData() { SetString(value); }
+    GeData(const Char* value) : GeData() { SetString(value); }
+    GeData(const Filename& value) : GeData() { SetFilename(value); }
+    GeData(const BaseContainer& value) : GeData() { SetContainer(value); }
+    GeData(Int32 type, const CustomDataType& data) : GeData() { SetCustomDataType(type, data); }
+    GeData(const GeData& other) : GeData() { CopyData(other); }
+    ~GeData() { Free(); }
+
+    GeData& operator = (const GeData& other) {
+        if (this != &other) CopyData(other);
+        return *this;
+    }
+
+    /**
+     * Moving hands the custom data over instead of copying it, so
+     * containers can grow without copying their custom data, which
+     * would lose the state that CopyData() of a datatype leaves out.
+     */
+    GeData(GeData&& other) noexcept : GeData() { MoveFrom(other); }
+
+    GeData& operator = (GeData&& other) noexcept {
+        if (this != &other) {
+            Free();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    /**
+     * Compares the type and value, custom data is compared with the
+     * Compare() method of its datatype.
+     */
+    Bool operator == (const GeData& other) const;
+    Bool operator != (const GeData& other) const {
+        return !(*this == other);
+    }
+
+    Int32 GetType() const {
+        return m_type;
+    }
+
+    void Free();
+    Bool CopyData(const GeData& other);
+
+    Int32 GetInt32() const { return (Int32) m_int; }
+    Int64 GetInt64() const { return m_int; }
+    Bool GetBool() const { return m_int != 0; }
+    Float GetFloat() const { return m_float; }
+    const Vector& GetVector() const { return m_vector; }
+    const String& GetString() const { return m_string; }
+    const Filename& GetFilename() const { return m_filename; }
+    BaseContainer* GetContainer() const { return m_container; }
+    BaseList2D* GetLink() const { return m_link; }
+
+    /**
+     * Returns the custom data if it is of *type*, nullptr otherwise.
+     */
+    CustomDataType* GetCustomDataType(Int32 type) const {
+        return m_type == type ? m_custom : nullptr;
+    }
+
+    void SetInt32(Int32 value) { Set(DA_LONG); m_int = value; m_float = value; }
+    void SetInt64(Int64 value) { Set(DA_LLONG); m_int = value; m_float = (Float) value; }
+    void SetFloat(Float value) { Set(DA_REAL); m_float = value; m_int = (Int64) value; }
+    void SetVector(const Vector& value) { Set(DA_VECTOR); m_vector = value; }
+    void SetString(const String& value) { Set(DA_STRING); m_string = value; }
+    void SetFilename(const Filename& value) { Set(DA_FILENAME); m_filename = value; }
+    void SetBaseList2D(BaseList2D* link) { Set(DA_ALIASLINK); m_link = link; }
+    Bool SetContainer(const BaseContainer& value);
+
+    /**
+     * Copies *data* with the CopyData() method of the datatype
+     * *type*. Returns false if the datatype is not registered or
+     * the data could not be copied.
+     */
+    Bool SetCustomDataType(Int32 type, const CustomDataType& data);
+
+private:
+
+    friend class HyperFile;
+
+    void Set(Int32 type) {
+        Free();
+        m_type = type;
+    }
+
+    void MoveFrom(GeData& other) {
+        m_type = other.m_type;
+        m_int = other.m_int;
+        m_float = other.m_float;
+        m_vector = other.m_vector;
+        m_string = other.m_string;
+        m_filename = other.m_filename;
+        m_container = other.m_container;
+        m_custom = other.m_custom;
+        m_link = other.m_link;
+        other.m_container = nullptr;
+        other.m_custom = nullptr;
+        other.Free();
+    }
+
+    Int32 m_type;
+    Int64 m_int;
+    Float m_float;
+    Vector m_vector;
+    String m_string;
+    Filename m_filename;
+    BaseContainer* m_container;
+    CustomDataType* m_custom;
+    BaseList2D* m_link;
+
+};
+
+/**
+ * Stores GeData values by ID. The entries keep the order in which
+ * they were added.
+ */
+class BaseContainer {
+
+public:
+
+    BaseContainer(Int32 id=0) : m_id(id) { }
+    BaseContainer(const BaseContainer& other) : m_id(other.m_id), m_entries(other.m_entries) { }
+
+    BaseContainer& operator = (const BaseContainer& other) {
+        m_id = other.m_id;
+        m_entries = other.m_entries;
+        return *this;
+    }
+
+    Bool operator == (const BaseContainer& other) const;
+    Bool operator != (const BaseContainer& other) const {
+        return !(*this == other);
+    }
+
+    Int32 GetId() const { return m_id; }
+    void SetId(Int32 id) { m_id = id; }
+
+    void FlushAll() {
+        m_entries.clear();
+    }
+
+    /**
+     * Returns the data of *id* or an empty GeData.
+     */
+    const GeData& GetData(Int32 id) const;
+    const GeData* GetDataPointer(Int32 id) const;
+    void SetData(Int32 id, const GeData& data);
+    Bool RemoveData(Int32 id);
+
+    Int32 GetIndexId(Int32 index) const {
+        return index >= 0 && index < (Int32) m_entries.size() ? m_entries[index].id : NOTOK;
+    }
+
+    const GeData* GetIndexData(Int32 index) const {
+        return index >= 0 && index < (Int32) m_entries.size() ? &m_entries[index].data : nullptr;
+    }
+
+    Bool GetBool(Int32 id, Bool preset=false) const;
+    Int32 GetInt32(Int32 id, Int32 preset=0) const;
+    Int64 GetInt64(Int32 id, Int64 preset=0) const;
+    Float GetFloat(Int32 id, Float preset=0.0) const;
+    Vector GetVector(Int32 id, const Vector& preset=Vector()) const;
+    String GetString(Int32 id, const String& preset=String()) const;
+    Filename GetFilename(Int32 id, const Filename& preset=Filename()) const;
+    BaseContainer GetContainer(Int32 id) const;
+    BaseContainer* GetContainerInstance(Int32 id) const;
+
+    void SetBool(Int32 id, Bool value) { SetData(id, GeData((Int32) value)); }
+    void SetInt32(Int32 id, Int32 value) { SetData(id, GeData(value)); }
+    void SetInt64(Int32 id, Int64 value) { SetData(id, GeData(value)); }
+    void SetFloat(Int32 id, Float value) { SetData(id, GeData(value)); }
+    void SetVector(Int32 id, const Vector& value) { SetData(id, GeData(value)); }
+    void SetString(Int32 id, const String& value) { SetData(id, GeData(value)); }
+    void SetFilename(Int32 id, const Filename& value) { SetData(id, GeData(value)); }
+    void SetContainer(Int32 id, const BaseContainer& value) { SetData(id, GeData(value)); }
+
+    /**
+     * Copies all entries to *dest* and replaces its entries.
+     */
+    Bool CopyTo(BaseContainer* dest) const {
+        if (dest) *dest = *this;
+        return dest != nullptr;
+    }
+
+private:
+
+    friend class HyperFile;
+
+    struct Entry {
+        Int32 id;
+        GeData data;
+    };
+
+    GeData* Find(Int32 id);
+    const GeData* Find(Int32 id) const;
+
+    Int32 m_id;
+    std::vector<Entry> m_entries;
+
+};
+
+/**
+ * Returns the default description of a parameter of *type*.
+ */
+BaseContainer GetCustomDataTypeDefault(Int32 type);
+
+/**
+ * One level of a DescID, the ID of the parameter or subchannel and
+ * the type of its data.
+ */
+struct DescLevel {
+    Int32 id;
+    Int32 dtype;
+    Int32 creator;
+
+    DescLevel(Int32 id_=0) : id(id_), dtype(0), creator(0) { }
+    DescLevel(Int32 id_, Int32 dtype_, Int32 creator_) : id(id_), dtype(dtype_), creator(creator_) { }
+
+    /**
+     * Levels compare by their ID, the type is only compared if it
+     * is set in both levels.
+     */
+    Bool operator == (const DescLevel& other) const {
+        return id == other.id && (dtype == 0 || other.dtype == 0 || dtype == other.dtype);
+    }
+    Bool operator != (const DescLevel& other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * The ID of a parameter. The first level is the parameter, further
+ * levels address subchannels of its data.
+ */
+class DescID {
+
+public:
+
+    DescID() { }
+    DescID(Int32 id1) { PushId(DescLevel(id1)); }
+    DescID(const DescLevel& id1) { PushId(id1); }
+    DescID(const DescLevel& id1, const DescLevel& id2) { PushId(id1); PushId(id2); }
+    DescID(const DescLevel& id1, const DescLevel& id2, const DescLevel& id3) {
+        PushId(id1); PushId(id2); PushId(id3);
+    }
+
+    Int32 GetDepth() const {
+        return (Int32) m_levels.size();
+    }
+
+    const DescLevel& operator [] (Int32 pos) const {
+        return m_levels[pos];
+    }
+
+    void PushId(const DescLevel& level) {
+        m_levels.push_back(level);
+    }
+
+    void PopId() {
+        if (!m_levels.empty()) m_levels.pop_back();
+    }
+
+    void SetId(const DescLevel& level) {
+        m_levels.clear();
+        m_levels.push_back(level);
+    }
+
+    /**
+     * Returns the ID without its first *skip* levels.
+     */
+    DescID GetSubID(Int32 skip) const;
+
+    Bool operator == (const DescID& other) const {
+        return m_levels.size() == other.m_levels.size()
+            && std::equal(m_levels.begin(), m_levels.end(), other.m_levels.begin());
+    }
+    Bool operator != (const DescID& other) const {
+        return !(*this == other);
+    }
+
+    /**
+     * Stand-in only: a hash of the level IDs. The types are left
+     * out, equal IDs may differ in them (see DescLevel).
+     */
+    UInt32 GetHash() const;
+
+    Bool Read(HyperFile* hf);
+    Bool Write(HyperFile* hf) const;
+
+private:
+
+    std::vector<DescLevel> m_levels;
+
+};
+
+extern const DescID DESCID_ROOT;
+
+enum {
+    DESC_NAME = 1,
+    DESC_SHORT_NAME = 2,
+    DESC_MIN = 5,
+    DESC_MAX = 6,
+    DESC_STEP = 9,
+    DESC_ANIMATE = 10,
+    DESC_UNIT = 12,
+    DESC_PARENTGROUP = 13,
+    DESC_HIDE = 15,
+    DESC_DEFAULT = 16,
+    DESC_CUSTOMGUI = 21,
+
+    DESC_ANIMATE_OFF = 0,
+    DESC_ANIMATE_ON = 1,
+    DESC_ANIMATE_MIX = 2,
+
+    DESC_UNIT_FLOAT = 1,
+    DESC_UNIT_PERCENT = 2,
+    DESC_UNIT_DEGREE = 3,
+    DESC_UNIT_METER = 4,
+
+    CUSTOMGUI_REAL = 1000014,
+    CUSTOMGUI_REALSLIDER = 1000017,
+};
+
+enum DESCFLAGS_GET {
+    DESCFLAGS_GET_0 = 0,
+    DESCFLAGS_GET_PARAM_GET = 1 << 1,
+    DESCFLAGS_GET_NO_GLOBALDATA = 1 << 4,
+};
+
+enum DESCFLAGS_SET {
+    DESCFLAGS_SET_0 = 0,
+    DESCFLAGS_SET_PARAM_SET = 1 << 1,
+    DESCFLAGS_SET_USERINTERACTION = 1 << 2,
+    DESCFLAGS_SET_DONTCHECKMINMAX = 1 << 3,
+};
+
+enum DESCFLAGS_DESC {
+    DESCFLAGS_DESC_0 = 0,
+    DESCFLAGS_DESC_LOADED = 1 << 1,
+    DESCFLAGS_DESC_RECURSIONLOCK = 1 << 2,
+};
+
+#define C4D_HEADLESS_FLAGS(T) \
+    inline T operator | (T a, T b) { return (T) ((Int32) a | (Int32) b); } \
+    inline T operator & (T a, T b) { return (T) ((Int32) a & (Int32) b); } \
+    inline T& operator |= (T& a, T b) { return a = a | b; } \
+    inline T& operator &= (T& a, T b) { return a = a & b; } \
+    inline T operator ~ (T a) { return (T) ~(Int32) a; }
+
+C4D_HEADLESS_FLAGS(DESCFLAGS_GET)
+C4D_HEADLESS_FLAGS(DESCFLAGS_SET)
+C4D_HEADLESS_FLAGS(DESCFLAGS_DESC)
+
+/**
+ * The parameters of a node, filled by the node and its datatypes.
+ */
+class Description {
+
+public:
+
+    static Description* Alloc() { return NewObj(Description); }
+    static void Free(Description*& desc) { DeleteObj(desc); }
+
+    /**
+     * Adds or replaces the parameter *id*.
+     */
+    Bool SetParameter(const DescID& id, const BaseContainer& param, const DescID& groupid);
+
+    /**
+     * Returns the parameter *id* or nullptr.
+     */
+    const BaseContainer* GetParameterI(const DescID& id, AtomArray* ar) const;
+
+    /**
+     * The ID of the parameter that the description is requested
+     * for, or nullptr if all parameters are requested.
+     */
+    const DescID* GetSingleDescID() const {
+        return m_single.GetDepth() > 0 ? &m_single : nullptr;
+    }
+
+    /**
+     * Stand-in only: sets the ID returned by GetSingleDescID(),
+     * nullptr requests all parameters.
+     */
+    void SetSingleDescID(const DescID* id) {
+        m_single = id ? *id : DescID();
+    }
+
+    Int32 GetCount() const {
+        return (Int32) m_params.size();
+    }
+
+    void* BrowseInit();
+    Bool GetNext(void* handle, const BaseContainer** bc, DescID& id, DescID& groupid);
+    void BrowseFree(void*& handle);
+
+private:
+
+    struct Param {
+        DescID id;
+        DescID groupid;
+        BaseContainer bc;
+    };
+
+    /**
+     * Returns the index of the parameter *id* in m_params, or -1.
+     */
+    Int FindIndex(const DescID& id) const;
+
+    std::vector<Param> m_params;
+
+    // The indices of m_params by DescID::GetHash(), so that adding
+    // many parameters does not search all of them every time.
+    std::unordered_multimap<UInt32, size_t> m_index;
+    DescID m_single;
+
+};
+
+/**
+ * Collects the values of a parameter of multiple nodes. GetTri()
+ * is true if they are not all equal.
+ */
+template <typename T>
+class TriState {
+
+public:
+
+    TriState() : m_populated(false), m_tri(false) { }
+
+    void Add(const T& value) {
+        if (!m_populated) {
+            m_value = value;
+            m_populated = true;
+        }
+        else if (!(m_value == value))
+            m_tri = true;
+    }
+
+    Bool IsPopulated() const { return m_populated; }
+    Bool GetTri() const { return m_tri; }
+    const T& GetValue() const { return m_value; }
+
+private:
+
+    T m_value;
+    Bool m_populated;
+    Bool m_tri;
+
+};
+
+#endif /* C4D_HEADLESS_GEDATA_H */
@@ -0,0 +1,226 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for dialogs, custom GUIs and the
+ *    input state
+ */
+
+#ifndef C4D_HEADLESS_GUI_H
+#define C4D_HEADLESS_GUI_H
+
+#include <map>
+#include "c4d_plugins.h"
+
+enum {
+    BFH_CENTER = 0,
+    BFH_LEFT = 1 << 0,
+    BFH_RIGHT = 1 << 1,
+    BFH_FIT = BFH_LEFT | BFH_RIGHT,
+    BFH_SCALE = 1 << 2,
+    BFH_SCALEFIT = BFH_SCALE | BFH_FIT,
+    BFV_CENTER = 0,
+    BFV_TOP = 1 << 3,
+    BFV_BOTTOM = 1 << 4,
+    BFV_FIT = BFV_TOP | BFV_BOTTOM,
+    BFV_SCALE = 1 << 5,
+    BFV_SCALEFIT = BFV_SCALE | BFV_FIT,
+
+    BORDER_NONE = 0,
+    BORDER_THIN_IN = 1,
+    BORDER_ROUND = 10,
+
+    BFM_INPUT = 'BIin',
+    BFM_ACTION = 'BAct',
+    BFM_ACTION_ID = 1,
+    BFM_ACTION_VALUE = 2,
+    BFM_ACTION_INDRAG = 4,
+    BFM_INPUT_DEVICE = 1001,
+    BFM_INPUT_CHANNEL = 1002,
+    BFM_INPUT_VALUE = 1003,
+    BFM_INPUT_QUALIFIER = 1004,
+    BFM_INPUT_MOUSE = 'Mous',
+    BFM_INPUT_KEYBOARD = 'Keyb',
+    BFM_INPUT_MOUSEWHEEL = 100,
+
+    QSHIFT = 1 << 0,
+    QCTRL = 1 << 1,
+    QALT = 1 << 2,
+};
+
+/**
+ * The dialog behind a GeDialog, opaque to plugins.
+ */
+class CDialog;
+
+/**
+ * A dialog. The stand-in does not display anything, it keeps the
+ * widgets that are added with their values and visibility, so that
+ * the values can be read and set like in Cinema.
+ */
+class GeDialog {
+
+public:
+
+    GeDialog() : m_timer(0) { }
+    virtual ~GeDialog() { }
+
+    virtual Bool CreateLayout() { return true; }
+    virtual Bool InitValues() { return true; }
+    virtual Bool Command(Int32 id, const BaseContainer& msg) { return true; }
+    virtual Bool CoreMessage(Int32 id, const BaseContainer& msg) { return true; }
+    virtual Int32 Message(const BaseContainer& msg, BaseContainer& result) { return 0; }
+    virtual void Timer(const BaseContainer& msg) { }
+
+    CDialog* Get() { return reinterpret_cast<CDialog*>(this); }
+
+    Bool GroupBegin(Int32 id, Int32 flags, Int32 cols, Int32 rows, const String& title,
+                    Int32 groupflags, Int32 initw=0, Int32 inith=0);
+    Bool GroupEnd() { return true; }
+    Bool GroupBorderNoTitle(Int32 type) { return true; }
+    Bool GroupBorderSpace(Int32 left, Int32 top, Int32 right, Int32 bottom) { return true; }
+
+    Bool AddStaticText(Int32 id, Int32 flags, Int32 initw, Int32 inith, const String& name,
+                       Int32 borderstyle);
+    Bool AddButton(Int32 id, Int32 flags, Int32 initw, Int32 inith, const String& name);
+    Bool AddSlider(Int32 id, Int32 flags, Int32 initw=0, Int32 inith=0);
+    Bool AddEditSlider(Int32 id, Int32 flags, Int32 initw=0, Int32 inith=0);
+    Bool AddEditNumber(Int32 id, Int32 flags, Int32 initw=0, Int32 inith=0);
+    Bool AddCheckbox(Int32 id, Int32 flags, Int32 initw, Int32 inith, const String& name);
+
+    /**
+     * Removes all widgets, the stand-in does not track which group
+     * they were added to.
+     */
+    Bool LayoutFlushGroup(Int32 id);
+    Bool LayoutChanged(Int32 id) { return true; }
+    Bool HideElement(Int32 id, Bool hide);
+
+    Bool SetString(Int32 id, const String& value);
+    Bool SetInt32(Int32 id, Int32 value, Int32 min=LIMIT<Int32>::MIN,
+                  Int32 max=LIMIT<Int32>::MAX, Int32 step=1, Bool tristate=false);
+    Bool SetFloat(Int32 id, Float value, Float min=-1e20, Float max=1e20, Float step=1.0,
+                  Bool tristate=false);
+    Bool SetPercent(Int32 id, Float value, Float min=0.0, Float max=100.0, Float step=1.0,
+                    Bool tristate=false);
+    Bool SetBool(Int32 id, Bool value);
+
+    Bool GetString(Int32 id, String& value) const;
+    Bool GetInt32(Int32 id, Int32& value) const;
+    Bool GetFloat(Int32 id, Float& value) const;
+    Bool GetBool(Int32 id, Bool& value) const;
+
+    void SetTimer(Int32 ms) { m_timer = ms; }
+
+    /**
+     * Opens the dialog. Without a GUI, only the layout is created
+     * and the values initialized.
+     */
+    Bool Open(Int32 xpos=-1, Int32 ypos=-1, Int32 defaultw=0, Int32 defaulth=0);
+
+    /**
+     * Stand-in only: whether the widget *id* exists and is shown,
+     * and the interval of the timer.
+     */
+    Bool HasElement(Int32 id) const { return m_widgets.count(id) != 0; }
+    Bool IsHidden(Int32 id) const;
+    Int32 GetTimer() const { return m_timer; }
+
+private:
+
+    struct Widget {
+        Bool hidden;
+        Bool tristate;
+        GeData value;
+    };
+
+    Bool AddWidget(Int32 id, const GeData& value);
+    Bool SetValue(Int32 id, const GeData& value, Bool tristate=false);
+    const Widget* Find(Int32 id) const;
+
+    std::map<Int32, Widget> m_widgets;
+    Int32 m_timer;
+
+};
+
+class SubDialog : public GeDialog {
+
+public:
+
+    /**
+     * Sends *msg* to the parent of the dialog. The stand-in passes
+     * it to the handler set with SetParentMessageHandler().
+     */
+    Bool SendParentMessage(const BaseContainer& msg);
+
+    /**
+     * Stand-in only: receives the messages of SendParentMessage().
+     */
+    typedef Bool ParentMessageHandler(const BaseContainer& msg, void* userdata);
+    void SetParentMessageHandler(ParentMessageHandler* fn, void* userdata) {
+        m_parentFn = fn;
+        m_parentData = userdata;
+    }
+
+private:
+
+    ParentMessageHandler* m_parentFn = nullptr;
+    void* m_parentData = nullptr;
+
+};
+
+/**
+ * The dialog of a custom GUI, allocated by its CustomGuiData.
+ */
+class iCustomGui : public SubDialog {
+
+public:
+
+    iCustomGui(const BaseContainer& settings, CUSTOMGUIPLUGIN* plugin)
+    : m_settings(settings), m_plugin(plugin), m_id(settings.GetId()) { }
+
+    virtual Bool SetData(const TriState<GeData>& tristate) { return true; }
+    virtual TriState<GeData> GetData() { return TriState<GeData>(); }
+
+    Int32 GetId() const { return m_id; }
+
+private:
+
+    BaseContainer m_settings;
+    CUSTOMGUIPLUGIN* m_plugin;
+    Int32 m_id;
+
+};
+
+/**
+ * There is no user to answer, so MessageDialog() prints the text
+ * and RenameDialog() returns false as if it was cancelled.
+ */
+void MessageDialog(const String& str);
+Bool QuestionDialog(const String& str);
+Bool RenameDialog(String* str);
+
+/**
+ * Fills *res* with the state of *askchannel*. The stand-in only
+ * knows the qualifiers, see headless::SetQualifiers().
+ */
+Bool GetInputState(Int32 askdevice, Int32 askchannel, BaseContainer& res);
+
+#endif /* C4D_HEADLESS_GUI_H */
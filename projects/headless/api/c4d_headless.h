@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: functions of the headless stand-in that have no
+ *    counterpart in the Cinema 4D API, used by its host and tests
+ */
+
+#ifndef C4D_HEADLESS_H
+#define C4D_HEADLESS_H
+
+#include "c4d.h"
+
+namespace headless {
+
+    /**
+     * Starts the plugin like Cinema does: sends C4DPL_INIT_SYS,
+     * calls PluginStart(), sends the command line with
+     * C4DPL_COMMANDLINEARGS and, once an empty active document
+     * exists, C4DPL_PROGRAM_STARTED. Returns false if PluginStart()
+     * or C4DPL_INIT_SYS failed.
+     *
+     * The stand-in handles two arguments itself:
+     * `-headless-points <count>` makes an object with *count*
+     * random points the active object, and `-headless-ctrl` holds
+     * the Ctrl key.
+     */
+    Bool Startup(Int32 argc, char** argv);
+
+    /**
+     * Sends C4DPL_ENDACTIVITY, frees the documents, calls
+     * PluginEnd() and frees the plugins.
+     */
+    void Shutdown();
+
+    /**
+     * True once IDM_QUIT (12104) was called.
+     */
+    Bool IsQuitRequested();
+
+    /**
+     * Sets the qualifier keys (QSHIFT, QCTRL, QALT) that are held
+     * according to GetInputState().
+     */
+    void SetQualifiers(Int32 qualifiers);
+
+    /**
+     * Prints the text of GePrint() to stdout if *echo* is true (the
+     * default). The last line is kept either way.
+     */
+    void SetConsoleEcho(Bool echo);
+    String GetLastConsoleLine();
+
+}
+
+#endif /* C4D_HEADLESS_H */
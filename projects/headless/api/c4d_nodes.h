@@ -0,0 +1,855 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for the node classes, documents,
+ *    selections, tracks and threads
+ */
+
+#ifndef C4D_HEADLESS_NODES_H
+#define C4D_HEADLESS_NODES_H
+
+#include <thread>
+#include <vector>
+#include "c4d_file.h"
+
+class NodeData;
+class GeListNode;
+class BaseList2D;
+class BaseObject;
+class BaseTag;
+class BaseDocument;
+class CTrack;
+
+enum {
+    Obase = 5155,
+    Opoint = 5168,
+    Opolygon = 5100,
+    Onull = 5140,
+    Ocube = 5159,
+    Osphere = 5160,
+    Tbase = 5612 - 1,
+    Tphong = 5612,
+    Tbaselist2d = 110050,
+    CTbase = 5350,
+    Tbasedocument = 110059,
+    Tbasescenehook = 110065,
+
+    PRIM_CUBE_LEN = 1100,
+    PRIM_SPHERE_RAD = 1110,
+    PRIM_SPHERE_SUB = 1111,
+};
+
+enum {
+    MSG_POINTS_CHANGED = 1,
+    MSG_POLYGONS_CHANGED = 2,
+    MSG_UPDATE = 3,
+    MSG_MENUPREPARE = 7,
+    MSG_DESCRIPTION_VALIDATE = 1022,
+    MSG_DOCUMENTINFO = 1019,
+
+    MSG_DOCUMENTINFO_TYPE_SETACTIVE = 1000,
+    MSG_DOCUMENTINFO_TYPE_LOAD = 1003,
+    MSG_DOCUMENTINFO_TYPE_SAVE_BEFORE = 1004,
+    MSG_DOCUMENTINFO_TYPE_SAVE_AFTER = 1005,
+    MSG_DOCUMENTINFO_TYPE_SAVEPROJECT_BEFORE = 1022,
+    MSG_DOCUMENTINFO_TYPE_SAVEPROJECT_AFTER = 1023,
+
+    EVMSG_CHANGE = 604,
+
+    BIT_ACTIVE = 1 << 1,
+};
+
+struct DocumentInfoData {
+    Int32 type;
+    BaseDocument* doc;
+    Filename filename;
+};
+
+enum COPYFLAGS {
+    COPYFLAGS_0 = 0,
+    COPYFLAGS_NO_HIERARCHY = 1 << 2,
+    COPYFLAGS_NO_ANIMATION = 1 << 3,
+};
+
+enum UNDOTYPE {
+    UNDOTYPE_CHANGE,
+    UNDOTYPE_CHANGE_NOCHILDREN,
+    UNDOTYPE_CHANGE_SMALL,
+    UNDOTYPE_CHANGE_SELECTION,
+    UNDOTYPE_NEW,
+    UNDOTYPE_DELETE,
+    UNDOTYPE_BITS,
+};
+
+enum GETACTIVEOBJECTFLAGS {
+    GETACTIVEOBJECTFLAGS_0 = 0,
+    GETACTIVEOBJECTFLAGS_CHILDREN = 1 << 0,
+};
+
+enum SELECTION {
+    SELECTION_NEW,
+    SELECTION_ADD,
+    SELECTION_SUB,
+};
+
+enum THREADMODE {
+    THREADMODE_SYNCHRONOUS,
+    THREADMODE_ASYNC,
+};
+
+enum THREADPRIORITY {
+    THREADPRIORITY_NORMAL,
+    THREADPRIORITY_ABOVE,
+    THREADPRIORITY_BELOW,
+    THREADPRIORITY_LOWEST,
+};
+
+enum BUILDFLAGS {
+    BUILDFLAGS_0 = 0,
+    BUILDFLAGS_INTERNALRENDERER = 1 << 1,
+};
+
+enum SAVEDOCUMENTFLAGS {
+    SAVEDOCUMENTFLAGS_0 = 0,
+    SAVEDOCUMENTFLAGS_DONTADDTORECENTLIST = 1 << 1,
+};
+
+enum SCENEFILTER {
+    SCENEFILTER_0 = 0,
+    SCENEFILTER_OBJECTS = 1 << 0,
+    SCENEFILTER_MATERIALS = 1 << 1,
+};
+
+enum {
+    FORMAT_C4DEXPORT = 1026370,
+};
+
+C4D_HEADLESS_FLAGS(COPYFLAGS)
+C4D_HEADLESS_FLAGS(GETACTIVEOBJECTFLAGS)
+C4D_HEADLESS_FLAGS(SAVEDOCUMENTFLAGS)
+C4D_HEADLESS_FLAGS(SCENEFILTER)
+
+/**
+ * Maps the links between copied nodes. The stand-in does not
+ * translate any links.
+ */
+class AliasTrans {
+
+public:
+
+    static AliasTrans* Alloc() { return NewObj(AliasTrans); }
+    static void Free(AliasTrans*& trans) { DeleteObj(trans); }
+
+    Bool Init(const BaseDocument* doc) { return true; }
+    void Translate(Bool connect_old) { }
+
+};
+
+class BaseTime {
+
+public:
+
+    BaseTime() : m_seconds(0.0) { }
+    explicit BaseTime(Float seconds) : m_seconds(seconds) { }
+    BaseTime(Float z, Float n) : m_seconds(n != 0.0 ? z / n : 0.0) { }
+
+    Float Get() const { return m_seconds; }
+    Int32 GetFrame(Float fps) const { return (Int32) Floor(m_seconds * fps + 0.5); }
+
+    Bool operator == (const BaseTime& other) const { return m_seconds == other.m_seconds; }
+    Bool operator != (const BaseTime& other) const { return m_seconds != other.m_seconds; }
+    Bool operator < (const BaseTime& other) const { return m_seconds < other.m_seconds; }
+
+private:
+
+    Float m_seconds;
+
+};
+
+/**
+ * The base of all nodes.
+ */
+class C4DAtom {
+
+public:
+
+    virtual ~C4DAtom() { }
+
+    Int32 GetType() const {
+        return m_type;
+    }
+
+    virtual Bool IsInstanceOf(Int32 id) const {
+        return id == m_type;
+    }
+
+    /**
+     * Returns a copy of the node, of its children too unless
+     * COPYFLAGS_NO_HIERARCHY is set. nullptr on a memory error.
+     */
+    virtual C4DAtom* GetClone(COPYFLAGS flags, AliasTrans* trn) = 0;
+
+    virtual Bool Message(Int32 type, void* data=nullptr) {
+        return true;
+    }
+
+    virtual Bool GetParameter(const DescID& id, GeData& t_data, DESCFLAGS_GET flags) {
+        return false;
+    }
+
+    virtual Bool SetParameter(const DescID& id, const GeData& t_data, DESCFLAGS_SET flags) {
+        return false;
+    }
+
+    virtual Bool GetDescription(Description* desc, DESCFLAGS_DESC flags) {
+        return false;
+    }
+
+protected:
+
+    C4DAtom(Int32 type) : m_type(type) { }
+
+private:
+
+    C4DAtom(const C4DAtom&);
+    C4DAtom& operator = (const C4DAtom&);
+
+    Int32 m_type;
+
+};
+
+/**
+ * A list of nodes that belong to *owner*, like the objects of a
+ * document or the tags of an object.
+ */
+struct GeListHead {
+    GeListNode* first;
+    GeListNode* owner;
+
+    GeListHead(GeListNode* owner_) : first(nullptr), owner(owner_) { }
+};
+
+/**
+ * A node in a hierarchy.
+ */
+class GeListNode : public C4DAtom {
+
+public:
+
+    virtual ~GeListNode();
+
+    GeListNode* GetNext() const { return m_next; }
+    GeListNode* GetPred() const { return m_pred; }
+    GeListNode* GetUp() const { return m_up; }
+    GeListNode* GetDown() const { return m_down; }
+    GeListNode* GetDownLast() const;
+
+    void InsertBefore(GeListNode* bl);
+    void InsertAfter(GeListNode* bl);
+    void InsertUnder(GeListNode* bl);
+    void InsertUnderLast(GeListNode* bl);
+
+    /**
+     * Stand-in only: inserts the node as the first or, after *pred*,
+     * as a following node of *head*.
+     */
+    void InsertHead(GeListHead* head, GeListNode* pred=nullptr);
+
+    void Remove();
+
+    /**
+     * Returns the document that the node is part of, or nullptr.
+     */
+    BaseDocument* GetDocument() const;
+
+    NodeData* GetNodeData(Int32 index=0) const {
+        return m_nodeData;
+    }
+
+protected:
+
+    GeListNode(Int32 type) : C4DAtom(type), m_next(nullptr), m_pred(nullptr), m_up(nullptr),
+        m_down(nullptr), m_head(nullptr), m_nodeData(nullptr) { }
+
+    /**
+     * Frees the children and the plugin data, called by the
+     * destructors of the derived classes.
+     */
+    void FreeNode();
+
+    /**
+     * Allocates the NodeData of the plugin *id* and calls its
+     * Init(). Returns false if the plugin is not registered.
+     */
+    Bool InitNodeData(Int32 id);
+
+    GeListNode* m_next;
+    GeListNode* m_pred;
+    GeListNode* m_up;
+    GeListNode* m_down;
+    GeListHead* m_head;
+    NodeData* m_nodeData;
+
+};
+
+/**
+ * A node with a name, parameters, bits and animation tracks.
+ */
+class BaseList2D : public GeListNode {
+
+public:
+
+    virtual ~BaseList2D();
+
+    BaseList2D* GetNext() const { return static_cast<BaseList2D*>(m_next); }
+    BaseList2D* GetPred() const { return static_cast<BaseList2D*>(m_pred); }
+
+    String GetName() const { return m_name; }
+    void SetName(const String& name) { m_name = name; }
+
+    BaseContainer GetData() const { return m_data; }
+    void SetData(const BaseContainer& bc) { m_data = bc; }
+    BaseContainer* GetDataInstance() { return &m_data; }
+
+    void SetBit(Int32 mask) { m_bits |= mask; }
+    void DelBit(Int32 mask) { m_bits &= ~mask; }
+    Bool GetBit(Int32 mask) const { return (m_bits & mask) != 0; }
+
+    /**
+     * The parameters are the entries of the data container. IDs
+     * with more than one level address the subchannels of custom
+     * data, which are read and written by its datatype.
+     */
+    virtual Bool GetParameter(const DescID& id, GeData& t_data, DESCFLAGS_GET flags);
+    virtual Bool SetParameter(const DescID& id, const GeData& t_data, DESCFLAGS_SET flags);
+
+    /**
+     * Describes each entry of the data container as a parameter
+     * named after its ID.
+     */
+    virtual Bool GetDescription(Description* desc, DESCFLAGS_DESC flags);
+
+    virtual Bool Message(Int32 type, void* data=nullptr);
+
+    CTrack* GetFirstCTrack() const;
+    CTrack* FindCTrack(const DescID& id) const;
+    void InsertTrackSorted(CTrack* track);
+
+protected:
+
+    BaseList2D(Int32 type);
+
+    /**
+     * Copies the name, parameters, tracks and plugin data to *dest*.
+     */
+    Bool CopyBaseTo(BaseList2D* dest, COPYFLAGS flags, AliasTrans* trn);
+
+    friend class BaseLink;
+
+    String m_name;
+    BaseContainer m_data;
+    Int32 m_bits;
+    GeListHead m_tracks;
+    UInt64 m_serial;
+
+};
+
+/**
+ * Returns the node that *serial* was given to if it still exists.
+ */
+BaseList2D* C4DHeadless_FindNode(UInt64 serial);
+
+class BaseTag : public BaseList2D {
+
+public:
+
+    static BaseTag* Alloc(Int32 type);
+    static void Free(BaseTag*& tag);
+
+    BaseTag* GetNext() const { return static_cast<BaseTag*>(m_next); }
+    BaseObject* GetObject() const;
+
+    virtual Bool IsInstanceOf(Int32 id) const {
+        return id == Tbase || BaseList2D::IsInstanceOf(id);
+    }
+
+    virtual C4DAtom* GetClone(COPYFLAGS flags, AliasTrans* trn);
+
+protected:
+
+    BaseTag(Int32 type) : BaseList2D(type) { }
+
+};
+
+class BaseObject : public BaseList2D {
+
+public:
+
+    static BaseObject* Alloc(Int32 type);
+    static void Free(BaseObject*& op);
+
+    virtual ~BaseObject();
+
+    BaseObject* GetNext() const { return static_cast<BaseObject*>(m_next); }
+    BaseObject* GetPred() const { return static_cast<BaseObject*>(m_pred); }
+    BaseObject* GetUp() const { return static_cast<BaseObject*>(m_up); }
+    BaseObject* GetDown() const { return static_cast<BaseObject*>(m_down); }
+
+    Matrix GetMl() const { return m_ml; }
+    void SetMl(const Matrix& m) { m_ml = m; }
+    Matrix GetMg() const;
+    void SetMg(const Matrix& m);
+    Matrix GetUpMg() const;
+
+    BaseTag* GetFirstTag() const { return static_cast<BaseTag*>(m_tags.first); }
+    BaseTag* GetTag(Int32 type, Int32 nr=0) const;
+    void InsertTag(BaseTag* tag, BaseTag* pred=nullptr);
+
+    virtual Bool IsInstanceOf(Int32 id) const {
+        return id == Obase || BaseList2D::IsInstanceOf(id);
+    }
+
+    virtual Bool Message(Int32 type, void* data=nullptr);
+    virtual C4DAtom* GetClone(COPYFLAGS flags, AliasTrans* trn);
+
+protected:
+
+    BaseObject(Int32 type);
+
+    /**
+     * Returns an empty object of the same type.
+     */
+    virtual BaseObject* AllocSame() const;
+
+    /**
+     * Copies the data of the object itself, the hierarchy is copied
+     * by GetClone().
+     */
+    virtual Bool CopyObjectTo(BaseObject* dest, COPYFLAGS flags, AliasTrans* trn);
+
+    friend class BaseTag;
+
+    Matrix m_ml;
+    GeListHead m_tags;
+
+};
+
+/**
+ * Stores a selection as sorted ranges of elements.
+ */
+class BaseSelect {
+
+public:
+
+    static BaseSelect* Alloc() { return NewObj(BaseSelect); }
+    static void Free(BaseSelect*& bs) { DeleteObj(bs); }
+
+    /**
+     * Returns the number of selected elements.
+     */
+    Int32 GetCount() const;
+    Int32 GetSegments() const { return (Int32) m_ranges.size(); }
+
+    Bool Select(Int32 num) { return SelectAll(num, num); }
+    Bool SelectAll(Int32 min, Int32 max);
+    Bool Deselect(Int32 num);
+    Bool DeselectAll() { m_ranges.clear(); return true; }
+    Bool Toggle(Int32 num);
+    Bool IsSelected(Int32 num) const;
+
+    /**
+     * Returns the range *seg* in *a* to *b*, limited to elements
+     * below *maxElements*. Returns false after the last range.
+     */
+    Bool GetRange(Int32 seg, Int32 maxElements, Int32* a, Int32* b) const;
+
+    Bool CopyTo(BaseSelect* dest) const {
+        if (dest) dest->m_ranges = m_ranges;
+        return dest != nullptr;
+    }
+
+private:
+
+    struct Range {
+        Int32 a, b;
+    };
+
+    std::vector<Range> m_ranges;
+
+};
+
+struct CPolygon {
+    Int32 a, b, c, d;
+
+    CPolygon() : a(0), b(0), c(0), d(0) { }
+    CPolygon(Int32 a_, Int32 b_, Int32 c_) : a(a_), b(b_), c(c_), d(c_) { }
+    CPolygon(Int32 a_, Int32 b_, Int32 c_, Int32 d_) : a(a_), b(b_), c(c_), d(d_) { }
+};
+
+class PointObject : public BaseObject {
+
+public:
+
+    static void Free(PointObject*& op) {
+        BaseObject* ptr = op;
+        BaseObject::Free(ptr);
+        op = nullptr;
+    }
+
+    Int32 GetPointCount() const { return (Int32) m_points.size(); }
+    const Vector* GetPointR() const { return m_points.empty() ? nullptr : &m_points[0]; }
+    Vector* GetPointW() { return m_points.empty() ? nullptr : &m_points[0]; }
+    BaseSelect* GetPointS() { return &m_pointSelection; }
+    const BaseSelect* GetPointS() const { return &m_pointSelection; }
+
+    virtual Bool ResizeObject(Int32 pcnt);
+
+    virtual Bool IsInstanceOf(Int32 id) const {
+        return id == Opoint || BaseObject::IsInstanceOf(id);
+    }
+
+protected:
+
+    PointObject(Int32 type) : BaseObject(type) { }
+
+    virtual Bool CopyObjectTo(BaseObject* dest, COPYFLAGS flags, AliasTrans* trn);
+
+    std::vector<Vector> m_points;
+    BaseSelect m_pointSelection;
+
+};
+
+class PolygonObject : public PointObject {
+
+public:
+
+    static PolygonObject* Alloc(Int32 pcnt, Int32 vcnt);
+    static void Free(PolygonObject*& op) {
+        BaseObject* ptr = op;
+        BaseObject::Free(ptr);
+        op = nullptr;
+    }
+
+    Int32 GetPolygonCount() const { return (Int32) m_polygons.size(); }
+    const CPolygon* GetPolygonR() const { return m_polygons.empty() ? nullptr : &m_polygons[0]; }
+    CPolygon* GetPolygonW() { return m_polygons.empty() ? nullptr : &m_polygons[0]; }
+
+    Bool ResizeObject(Int32 pcnt, Int32 vcnt);
+    virtual Bool ResizeObject(Int32 pcnt) { return ResizeObject(pcnt, GetPolygonCount()); }
+
+protected:
+
+    PolygonObject() : PointObject(Opolygon) { }
+
+    virtual BaseObject* AllocSame() const;
+    virtual Bool CopyObjectTo(BaseObject* dest, COPYFLAGS flags, AliasTrans* trn);
+
+    std::vector<CPolygon> m_polygons;
+
+};
+
+/**
+ * An animation track of a parameter. Tracks of plugins have their
+ * plugin ID as the ID of the first level.
+ */
+class CTrack : public BaseList2D {
+
+public:
+
+    static CTrack* Alloc(BaseList2D* bl, const DescID& id);
+    static void Free(CTrack*& track);
+
+    CTrack* GetNext() const { return static_cast<CTrack*>(m_next); }
+    BaseList2D* GetObject() const;
+    DescID GetDescriptionID() const { return m_id; }
+
+    virtual Bool IsInstanceOf(Int32 id) const {
+        return id == CTbase || BaseList2D::IsInstanceOf(id);
+    }
+
+    virtual C4DAtom* GetClone(COPYFLAGS flags, AliasTrans* trn);
+
+private:
+
+    CTrack(Int32 type, const DescID& id) : BaseList2D(type), m_id(id) { }
+
+    DescID m_id;
+
+};
+
+/**
+ * Passed to CTrackData::Animate().
+ */
+struct CAnimInfo {
+    BaseDocument* doc;
+    BaseList2D* op;
+    BaseTime otime;
+    Float xtime;
+    Float fac;
+    Float rel;
+};
+
+class AtomArray {
+
+public:
+
+    static AtomArray* Alloc() { return NewObj(AtomArray); }
+    static void Free(AtomArray*& ar) { DeleteObj(ar); }
+
+    Int32 GetCount() const { return (Int32) m_atoms.size(); }
+    C4DAtom* GetIndex(Int32 idx) const {
+        return idx >= 0 && idx < GetCount() ? m_atoms[idx] : nullptr;
+    }
+    Bool Append(C4DAtom* obj) { m_atoms.push_back(obj); return true; }
+    void Flush() { m_atoms.clear(); }
+    Int32 Find(C4DAtom* obj) const;
+    Bool Remove(C4DAtom* obj);
+
+private:
+
+    std::vector<C4DAtom*> m_atoms;
+
+};
+
+/**
+ * A link to a node that does not keep the node alive. GetLink()
+ * returns nullptr once the node was freed.
+ */
+class BaseLink {
+
+public:
+
+    static BaseLink* Alloc() { return NewObj(BaseLink); }
+    static void Free(BaseLink*& link) { DeleteObj(link); }
+
+    BaseLink() : m_serial(0) { }
+
+    void SetLink(BaseList2D* node) { m_serial = node ? node->m_serial : 0; }
+
+    /**
+     * Returns the node if it still exists and, if *doc* is not
+     * nullptr, is part of *doc*.
+     */
+    BaseList2D* GetLink(const BaseDocument* doc, Int32 instanceof=0) const;
+
+private:
+
+    UInt64 m_serial;
+
+};
+
+/**
+ * The node of a scene hook plugin. Every document has one for each
+ * scene hook that was registered before the document was allocated.
+ */
+class BaseSceneHook : public BaseList2D {
+
+public:
+
+    BaseSceneHook* GetNext() const { return static_cast<BaseSceneHook*>(m_next); }
+
+    virtual Bool IsInstanceOf(Int32 id) const {
+        return id == Tbasescenehook || BaseList2D::IsInstanceOf(id);
+    }
+
+    virtual C4DAtom* GetClone(COPYFLAGS flags, AliasTrans* trn);
+
+private:
+
+    friend class BaseDocument;
+
+    BaseSceneHook(Int32 type) : BaseList2D(type) { }
+
+};
+
+class BaseDocument : public BaseList2D {
+
+public:
+
+    static BaseDocument* Alloc();
+    static void Free(BaseDocument*& doc);
+
+    virtual ~BaseDocument();
+
+    BaseObject* GetFirstObject() const { return static_cast<BaseObject*>(m_objects.first); }
+
+    /**
+     * Inserts *op* under *parent* after *pred*. Without a parent it
+     * is inserted as a top level object.
+     */
+    void InsertObject(BaseObject* op, BaseObject* parent, BaseObject* pred, Bool checknames=false);
+
+    /**
+     * Returns the active object, nullptr if none or multiple objects
+     * are selected.
+     */
+    BaseObject* GetActiveObject() const;
+    void SetActiveObject(BaseObject* op, SELECTION mode=SELECTION_NEW);
+
+    /**
+     * Fills *selection* with the active objects. Without
+     * GETACTIVEOBJECTFLAGS_CHILDREN, active children of active
+     * objects are left out.
+     */
+    void GetActiveObjects(AtomArray& selection, GETACTIVEOBJECTFLAGS flags) const;
+    void GetActiveTags(AtomArray& selection) const;
+    void GetActiveMaterials(AtomArray& selection) const { selection.Flush(); }
+
+    /**
+     * The stand-in has no undo, the calls only check that they are
+     * balanced.
+     */
+    Bool StartUndo();
+    Bool EndUndo();
+    Bool AddUndo(UNDOTYPE type, void* data);
+
+    BaseTime GetTime() const { return m_time; }
+    void SetTime(const BaseTime& time) { m_time = time; }
+    Int32 GetFps() const { return 30; }
+
+    /**
+     * Evaluates the tracks of all objects, tags and the document at
+     * the current time. Caches and expressions are not supported.
+     */
+    Bool ExecutePasses(void* bt, Bool animation, Bool expressions, Bool caches, BUILDFLAGS flags);
+
+    /**
+     * Returns the node of the scene hook plugin *id*, nullptr if it
+     * is not registered.
+     */
+    BaseSceneHook* FindSceneHook(Int32 id) const;
+
+    virtual C4DAtom* GetClone(COPYFLAGS flags, AliasTrans* trn);
+
+private:
+
+    BaseDocument();
+
+    /**
+     * Adds a node for every registered scene hook.
+     */
+    Bool InitSceneHooks();
+
+    GeListHead m_objects;
+    GeListHead m_hooks;
+    BaseTime m_time;
+    Int32 m_undoDepth;
+
+};
+
+BaseDocument* GetActiveDocument();
+void SetActiveDocument(BaseDocument* doc);
+void InsertBaseDocument(BaseDocument* doc);
+
+/**
+ * Saves *doc* to *name*. The scene hooks of the document receive
+ * MSG_DOCUMENTINFO before and after the document is written. The
+ * stand-in only supports FORMAT_C4DEXPORT and stores the hierarchy,
+ * names, matrices, tags and parameters of the objects, but not the
+ * points, polygons or tracks.
+ */
+Bool SaveDocument(BaseDocument* doc, const Filename& name, SAVEDOCUMENTFLAGS saveflags, Int32 format);
+
+/**
+ * Loads a document saved with SaveDocument(). The document is not
+ * inserted with InsertBaseDocument(). Returns nullptr if the file
+ * can not be read, *thread* is ignored.
+ */
+BaseDocument* LoadDocument(const Filename& name, SCENEFILTER loadflags, void* thread);
+
+/**
+ * Stand-in only: frees the documents passed to InsertBaseDocument().
+ */
+void C4DHeadless_FreeDocuments();
+
+/**
+ * Tells the GUI to redraw, nothing to do for the stand-in.
+ */
+inline void EventAdd(Int32 flags=0) { }
+
+enum {
+    MCOMMAND_CURRENTSTATETOOBJECT = 12233,
+    MCOMMAND_MAKEEDITABLE = 12236,
+};
+
+enum MODELINGCOMMANDMODE {
+    MODELINGCOMMANDMODE_ALL,
+    MODELINGCOMMANDMODE_POINTSELECTION,
+    MODELINGCOMMANDMODE_POLYGONSELECTION,
+    MODELINGCOMMANDMODE_EDGESELECTION,
+};
+
+enum MODELINGCOMMANDFLAGS {
+    MODELINGCOMMANDFLAGS_0 = 0,
+    MODELINGCOMMANDFLAGS_CREATEUNDO = 1 << 0,
+};
+
+/**
+ * The arguments and result of SendModelingCommand(). The objects in
+ * *result* belong to the caller, the array is freed with the data.
+ */
+struct ModelingCommandData {
+    BaseDocument* doc;
+    BaseObject* op;
+    BaseContainer* bc;
+    MODELINGCOMMANDMODE mode;
+    MODELINGCOMMANDFLAGS flags;
+    AtomArray* result;
+
+    ModelingCommandData() : doc(nullptr), op(nullptr), bc(nullptr),
+        mode(MODELINGCOMMANDMODE_ALL), flags(MODELINGCOMMANDFLAGS_0), result(nullptr) { }
+    ~ModelingCommandData() { AtomArray::Free(result); }
+};
+
+/**
+ * Supports MCOMMAND_CURRENTSTATETOOBJECT for spheres, which become
+ * UV spheres with PRIM_SPHERE_SUB segments and a phong tag, and for
+ * all other objects, which are copied.
+ */
+Bool SendModelingCommand(Int32 command, ModelingCommandData& data);
+
+class C4DThread {
+
+public:
+
+    C4DThread() : m_thread(nullptr), m_break(false) { }
+    virtual ~C4DThread() { End(true); }
+
+    Bool Start(THREADMODE mode=THREADMODE_ASYNC, THREADPRIORITY priority=THREADPRIORITY_NORMAL);
+    void End(Bool wait=true);
+    void Wait(Bool checkevents=true);
+    Bool TestBreak() { return m_break; }
+    Bool IsRunning() const { return m_thread != nullptr; }
+
+    virtual void Main() = 0;
+    virtual const Char* GetThreadName() = 0;
+
+private:
+
+    C4DThread(const C4DThread&);
+    C4DThread& operator = (const C4DThread&);
+
+    std::thread* m_thread;
+    Bool m_break;
+
+};
+
+#endif /* C4D_HEADLESS_NODES_H */
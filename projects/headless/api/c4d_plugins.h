@@ -0,0 +1,308 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for the plugin classes, their
+ *    registration, commands and resources
+ */
+
+#ifndef C4D_HEADLESS_PLUGINS_H
+#define C4D_HEADLESS_PLUGINS_H
+
+#include "c4d_nodes.h"
+
+class BaseBitmap;
+class CDialog;
+struct CUSTOMGUIPLUGIN;
+
+#define INSTANCEOF(X, Y) \
+    public: \
+        typedef Y super; \
+    private:
+
+/**
+ * The plugin data of a node.
+ */
+class NodeData {
+
+public:
+
+    virtual ~NodeData() { }
+
+    virtual Bool Init(GeListNode* node) { return true; }
+    virtual void Free(GeListNode* node) { }
+    virtual Bool Read(GeListNode* node, HyperFile* hf, Int32 level) { return true; }
+    virtual Bool Write(GeListNode* node, HyperFile* hf) { return true; }
+    virtual Bool CopyTo(NodeData* dest, GeListNode* snode, GeListNode* dnode,
+                        COPYFLAGS flags, AliasTrans* trn) { return true; }
+    virtual Bool Message(GeListNode* node, Int32 type, void* data) { return true; }
+
+    /**
+     * Returns the node that the data belongs to.
+     */
+    GeListNode* Get() const { return m_node; }
+
+private:
+
+    friend class GeListNode;
+
+    GeListNode* m_node = nullptr;
+
+};
+
+typedef NodeData* DataAllocator();
+
+class CTrackData : public NodeData {
+
+public:
+
+    virtual Bool Animate(CTrack* track, const CAnimInfo* info, Bool* chg, void* data) {
+        return true;
+    }
+
+};
+
+/**
+ * The plugin data of a scene hook, which exists once per document
+ * and receives the messages sent to it.
+ */
+class SceneHookData : public NodeData { };
+
+static const Int32 CMD_ENABLED = 1 << 1;
+static const Int32 CMD_VALUE = 1 << 2;
+
+class CommandData {
+
+public:
+
+    virtual ~CommandData() { }
+
+    virtual Bool Execute(BaseDocument* doc) { return true; }
+    virtual Int32 GetState(BaseDocument* doc) { return CMD_ENABLED; }
+    virtual Bool ExecuteSubID(BaseDocument* doc, Int32 subid) { return true; }
+    virtual Bool ExecuteOptionID(BaseDocument* doc, Int32 plugid, Int32 subid) { return true; }
+
+};
+
+enum {
+    PLUGINFLAG_HIDE = 1 << 29,
+    PLUGINFLAG_HIDEPLUGINMENU = 1 << 28,
+    PLUGINFLAG_COMMAND_HOTKEY = 1 << 25,
+    PLUGINFLAG_COMMAND_OPTION_DIALOG = 1 << 24,
+
+    CUSTOMDATATYPE_INFO_HASSUBDESCRIPTION = 1 << 0,
+    CUSTOMDATATYPE_INFO_NEEDDATAFORSUBDESC = 1 << 1,
+    CUSTOMDATATYPE_INFO_TOGGLEDISPLAY = 1 << 2,
+};
+
+/**
+ * The plugin of a custom datatype.
+ */
+class CustomDataTypeClass {
+
+public:
+
+    virtual ~CustomDataTypeClass() { }
+
+    virtual Int32 GetId() = 0;
+    virtual CustomDataType* AllocData() = 0;
+    virtual void FreeData(CustomDataType* data) = 0;
+    virtual Bool CopyData(const CustomDataType* src, CustomDataType* dest, AliasTrans* aliastrans) = 0;
+    virtual Int32 Compare(const CustomDataType* d1, const CustomDataType* d2) = 0;
+    virtual Bool WriteData(const CustomDataType* d, HyperFile* hf) = 0;
+    virtual Bool ReadData(CustomDataType* d, HyperFile* hf, Int32 level) = 0;
+    virtual const Char* GetResourceSym() = 0;
+    virtual void GetDefaultProperties(BaseContainer& data) { }
+
+    virtual Bool _GetDescription(const CustomDataType* data, Description& desc,
+                                 DESCFLAGS_DESC& flags, const BaseContainer& parentdescription,
+                                 DescID* singledescid) {
+        return true;
+    }
+
+    virtual Bool GetParameter(const CustomDataType* data, const DescID& id, GeData& t_data,
+                              DESCFLAGS_GET& flags) {
+        return true;
+    }
+
+    virtual Bool SetDParameter(CustomDataType* data, const DescID& id, const GeData& t_data,
+                               DESCFLAGS_SET& flags) {
+        return true;
+    }
+
+};
+
+CustomDataTypeClass* FindCustomDataTypePlugin(Int32 type);
+
+/**
+ * Stand-in only: the disk level the datatype *type* was registered
+ * with, 0 if it is not registered.
+ */
+Int32 C4DHeadless_GetDataTypeLevel(Int32 type);
+
+enum {
+    CUSTOMTYPE_END = 0,
+    CUSTOMTYPE_FLAG = 1,
+    CUSTOMTYPE_LONG = 2,
+    CUSTOMTYPE_REAL = 3,
+    CUSTOMTYPE_STRING = 4,
+};
+
+struct CustomProperty {
+    Int32 type;
+    Int32 id;
+    const Char* ident;
+};
+
+/**
+ * The plugin of a custom GUI.
+ */
+class CustomGuiData {
+
+public:
+
+    virtual ~CustomGuiData() { }
+
+    virtual Int32 GetId() = 0;
+    virtual CDialog* Alloc(const BaseContainer& settings) = 0;
+    virtual void Free(CDialog* dlg, void* userdata) = 0;
+    virtual const Char* GetResourceSym() = 0;
+    virtual CustomProperty* GetProperties() { return nullptr; }
+    virtual Int32 GetResourceDataType(Int32*& table) = 0;
+
+    CUSTOMGUIPLUGIN* GetPlugin() const { return m_plugin; }
+
+private:
+
+    friend Bool RegisterCustomGuiPlugin(const String& str, Int32 info, CustomGuiData* dat);
+
+    CUSTOMGUIPLUGIN* m_plugin = nullptr;
+
+};
+
+CustomGuiData* FindCustomGuiPlugin(Int32 id);
+
+/**
+ * The libraries of the API, which a plugin can install for others.
+ */
+struct C4DLibrary {
+    Int32 size;
+    Int32 version;
+};
+
+struct BaseCustomGuiLib : public C4DLibrary {
+    void* fn[8];
+};
+
+void FillBaseCustomGui(BaseCustomGuiLib& lib);
+Bool InstallLibrary(Int32 id, C4DLibrary* lib, Int32 version, Int32 size);
+
+Bool RegisterCommandPlugin(Int32 id, const String& str, Int32 info, BaseBitmap* icon,
+                           const String& help, CommandData* dat);
+Bool RegisterCTrackPlugin(Int32 id, const String& str, Int32 info, DataAllocator* g,
+                          const String& description, Int32 disklevel);
+Bool RegisterSceneHookPlugin(Int32 id, const String& str, Int32 info, DataAllocator* g,
+                             Int32 priority, Int32 disklevel);
+Bool RegisterCustomDataTypePlugin(const String& str, Int32 info, CustomDataTypeClass* dat,
+                                  Int32 disklevel);
+Bool RegisterCustomGuiPlugin(const String& str, Int32 info, CustomGuiData* dat);
+
+/**
+ * Stand-in only: allocates the NodeData of the track or scene hook
+ * plugin *id*, nullptr if it is not registered.
+ */
+NodeData* C4DHeadless_AllocNodeData(Int32 id);
+Bool C4DHeadless_IsNodePlugin(Int32 id);
+
+/**
+ * Stand-in only: the IDs of the registered scene hooks in the order
+ * of their priority, highest first.
+ */
+std::vector<Int32> C4DHeadless_GetSceneHooks();
+
+/**
+ * Executes the command *id* with the active document if its
+ * GetState() has CMD_ENABLED. The commands of Cinema itself that
+ * the stand-in knows are IDM_QUIT (12104), which ends the host, and
+ * the console (12305), which is always shown.
+ */
+void CallCommand(Int32 id, Int32 subid=0);
+Bool IsCommandEnabled(Int32 id);
+
+enum {
+    C4DPL_INIT_SYS = 3,
+    C4DPL_MESSAGE = 4,
+    C4DPL_BUILDMENU = 5,
+    C4DPL_STARTACTIVITY = 6,
+    C4DPL_ENDACTIVITY = 7,
+    C4DPL_COMMANDLINEARGS = 200,
+    C4DPL_PROGRAM_STARTED = 1107,
+};
+
+struct C4DPL_CommandLineArgs {
+    Int32 argc;
+    char** argv;
+};
+
+/**
+ * The strings of the plugin, loaded from
+ * `res/strings_us/c4d_strings.str` with the IDs from
+ * `res/c4d_symbols.h`.
+ */
+class GeResource {
+
+public:
+
+    /**
+     * Loads the resource of the plugin in GeGetPluginPath().
+     */
+    Bool Init();
+    Bool Init(const Filename& path);
+    void Free();
+
+    const String& LoadString(Int32 id) const;
+
+private:
+
+    std::vector<std::pair<Int32, String>> m_strings;
+
+};
+
+extern GeResource resource;
+
+/**
+ * Returns the string *id* of the plugin resource with each '#'
+ * replaced by the next argument.
+ */
+String GeLoadString(Int32 id);
+String GeLoadString(Int32 id, const String& p1);
+String GeLoadString(Int32 id, const String& p1, const String& p2);
+String GeLoadString(Int32 id, const String& p1, const String& p2, const String& p3);
+String GeLoadString(Int32 id, const String& p1, const String& p2, const String& p3,
+                    const String& p4);
+
+/**
+ * Implemented by the plugin.
+ */
+Bool PluginStart();
+Bool PluginMessage(Int32 id, void* data);
+void PluginEnd();
+
+#endif /* C4D_HEADLESS_PLUGINS_H */
@@ -0,0 +1,256 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for the String and Filename classes
+ */
+
+#ifndef C4D_HEADLESS_STRING_H
+#define C4D_HEADLESS_STRING_H
+
+#include <string>
+#include "c4d_system.h"
+
+enum STRINGENCODING {
+    STRINGENCODING_XBIT,
+    STRINGENCODING_8BIT,
+    STRINGENCODING_7BIT,
+    STRINGENCODING_7BITHEX,
+    STRINGENCODING_UTF8,
+    STRINGENCODING_HTML,
+};
+
+/**
+ * A Unicode string. The stand-in keeps the characters as UTF-8,
+ * lengths and positions are counted in characters like in Cinema.
+ * All conversions to C strings produce UTF-8, whatever encoding is
+ * requested.
+ */
+class String {
+
+public:
+
+    String() { }
+    String(const Char* cstr) : m_utf8(cstr ? cstr : "") { }
+    String(const Char* cstr, STRINGENCODING type) : m_utf8(cstr ? cstr : "") { }
+    String(const String& other) : m_utf8(other.m_utf8) { }
+
+    String& operator = (const String& other) {
+        m_utf8 = other.m_utf8;
+        return *this;
+    }
+
+    Bool Content() const {
+        return !m_utf8.empty();
+    }
+
+    /**
+     * Returns the number of characters.
+     */
+    Int GetLength() const;
+
+    Int32 Compare(const String& other) const {
+        Int32 result = m_utf8.compare(other.m_utf8);
+        return result < 0 ? -1 : (result > 0 ? 1 : 0);
+    }
+
+    Bool operator == (const String& other) const { return m_utf8 == other.m_utf8; }
+    Bool operator != (const String& other) const { return m_utf8 != other.m_utf8; }
+    Bool operator < (const String& other) const { return m_utf8 < other.m_utf8; }
+
+    String& operator += (const String& other) {
+        m_utf8 += other.m_utf8;
+        return *this;
+    }
+
+    /**
+     * Returns the number of bytes of the string in *type* without a
+     * terminating null byte.
+     */
+    Int GetCStringLen(STRINGENCODING type=STRINGENCODING_XBIT) const {
+        return (Int) m_utf8.size();
+    }
+
+    /**
+     * Copies the string with a terminating null byte to *cstr*,
+     * which has room for *maxlen* bytes. Longer strings are cut.
+     */
+    Int GetCString(Char* cstr, Int maxlen, STRINGENCODING type=STRINGENCODING_XBIT) const;
+
+    /**
+     * Returns a copy of the string to be freed with DeleteMem(), or
+     * nullptr on a memory error.
+     */
+    Char* GetCStringCopy(STRINGENCODING type=STRINGENCODING_XBIT) const;
+
+    void SetCString(const Char* cstr, Int count=-1, STRINGENCODING type=STRINGENCODING_XBIT) {
+        if (!cstr) m_utf8.clear();
+        else if (count < 0) m_utf8.assign(cstr);
+        else m_utf8.assign(cstr, (size_t) count);
+    }
+
+    Bool FindFirst(const String& str, Int* pos, Int start=0) const;
+    String SubStr(Int start, Int count) const;
+    String ToUpper() const;
+    String ToLower() const;
+
+    Int32 ToInt32(Bool* error=nullptr) const;
+    Float ToFloat(Bool* error=nullptr) const;
+
+    static String IntToString(Int32 value);
+    static String IntToString(Int64 value);
+    static String UIntToString(UInt64 value);
+
+    /**
+     * Formats *value* with *vvk* digits before and *nnk* after the
+     * decimal point. -1 for *vvk* uses as many as needed, a negative
+     * *nnk* uses up to -nnk digits and removes trailing zeros.
+     */
+    static String FloatToString(Float value, Int32 vvk=-1, Int32 nnk=-3);
+
+    static String HexToString(UInt64 value, Bool prefix=true);
+
+    /**
+     * Stand-in only: the UTF-8 bytes of the string.
+     */
+    const std::string& GetUtf8() const {
+        return m_utf8;
+    }
+
+private:
+
+    std::string m_utf8;
+
+};
+
+inline String operator + (const String& a, const String& b) {
+    String result(a);
+    result += b;
+    return result;
+}
+
+class MemoryFileStruct;
+
+/**
+ * A path on the disk or, in memory mode, a MemoryFileStruct or a
+ * block of memory that a HyperFile or BaseFile reads from.
+ */
+class Filename {
+
+public:
+
+    Filename() : m_memoryWrite(nullptr), m_memoryRead(nullptr), m_memorySize(0) { }
+    Filename(const String& path)
+    : m_path(path), m_memoryWrite(nullptr), m_memoryRead(nullptr), m_memorySize(0) { }
+    Filename(const Char* path)
+    : m_path(path), m_memoryWrite(nullptr), m_memoryRead(nullptr), m_memorySize(0) { }
+
+    Bool Content() const {
+        return m_path.Content() || IsMemoryMode();
+    }
+
+    String GetString() const {
+        return m_path;
+    }
+
+    void SetString(const String& path) {
+        m_path = path;
+    }
+
+    Filename GetDirectory() const;
+    Filename GetFile() const;
+    String GetFileString() const;
+
+    /**
+     * Returns the suffix without the dot, or an empty string.
+     */
+    String GetSuffix() const;
+
+    /**
+     * Replaces the suffix of the file name with *suffix*, or adds
+     * it if the name has none.
+     */
+    void SetSuffix(const String& suffix);
+    void ClearSuffix();
+    Bool CheckSuffix(const String& suffix) const;
+
+    void SetMemoryWriteMode(MemoryFileStruct* mfs) {
+        m_memoryWrite = mfs;
+        m_memoryRead = nullptr;
+        m_memorySize = 0;
+    }
+
+    void SetMemoryReadMode(void* data, Int size, Bool autofree=false) {
+        m_memoryWrite = nullptr;
+        m_memoryRead = data;
+        m_memorySize = size;
+    }
+
+    Bool IsMemoryMode() const {
+        return m_memoryWrite != nullptr || m_memoryRead != nullptr;
+    }
+
+    /**
+     * Stand-in only: the memory of a Filename in memory mode.
+     */
+    MemoryFileStruct* GetMemoryWrite() const { return m_memoryWrite; }
+    void* GetMemoryRead() const { return m_memoryRead; }
+    Int GetMemorySize() const { return m_memorySize; }
+
+    /**
+     * Appends *other* as a path component.
+     */
+    Filename operator + (const Filename& other) const;
+    Filename& operator += (const Filename& other);
+
+    Bool operator == (const Filename& other) const;
+    Bool operator != (const Filename& other) const {
+        return !(*this == other);
+    }
+
+private:
+
+    String m_path;
+    MemoryFileStruct* m_memoryWrite;
+    void* m_memoryRead;
+    Int m_memorySize;
+
+};
+
+void GePrint(const String& str);
+
+Bool GeFExist(const Filename& name, Bool isdir=false);
+Bool GeFKill(const Filename& name, Int32 flags=0);
+Bool GeFCreateDir(const Filename& name);
+
+/**
+ * The folder for user data, the directory in the
+ * C4D_HEADLESS_USER environment variable or the current directory.
+ */
+Filename GeGetStartupWritePath();
+
+/**
+ * The folder of the plugin, the directory in the
+ * C4D_HEADLESS_PLUGIN environment variable or the root of the
+ * repository the stand-in was built from.
+ */
+Filename GeGetPluginPath();
+
+#endif /* C4D_HEADLESS_STRING_H */
@@ -0,0 +1,257 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for the base types, memory, math and
+ *    threading functions of the Cinema 4D R15 API
+ */
+
+#ifndef C4D_HEADLESS_SYSTEM_H
+#define C4D_HEADLESS_SYSTEM_H
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+typedef bool Bool;
+typedef char Char;
+typedef unsigned char UChar;
+typedef int16_t Int16;
+typedef uint16_t UInt16;
+typedef int32_t Int32;
+typedef uint32_t UInt32;
+typedef int64_t Int64;
+typedef uint64_t UInt64;
+typedef Int64 Int;
+typedef UInt64 UInt;
+typedef float Float32;
+typedef double Float64;
+typedef double Float;
+
+static const Int32 NOTOK = -1;
+
+template <typename T> struct LIMIT;
+
+template <> struct LIMIT<Int32> {
+    static const Int32 MIN = INT32_MIN;
+    static const Int32 MAX = INT32_MAX;
+};
+
+template <> struct LIMIT<Int64> {
+    static const Int64 MIN = INT64_MIN;
+    static const Int64 MAX = INT64_MAX;
+};
+
+template <> struct LIMIT<UInt32> {
+    static const UInt32 MIN = 0;
+    static const UInt32 MAX = UINT32_MAX;
+};
+
+/**
+ * Math
+ */
+
+template <typename T> inline T Min(T a, T b) { return a < b ? a : b; }
+template <typename T> inline T Max(T a, T b) { return a > b ? a : b; }
+template <typename T> inline T Abs(T a) { return a < 0 ? -a : a; }
+template <typename T> inline T ClampValue(T value, T lo, T hi) {
+    return value < lo ? lo : (value > hi ? hi : value);
+}
+
+inline Float Floor(Float x) { return std::floor(x); }
+inline Float Ceil(Float x) { return std::ceil(x); }
+inline Float Sqrt(Float x) { return std::sqrt(x); }
+inline Float Sin(Float x) { return std::sin(x); }
+inline Float Cos(Float x) { return std::cos(x); }
+
+static const Float PI = 3.1415926535897932384626433832795;
+
+struct Vector {
+    Float x, y, z;
+
+    Vector() : x(0.0), y(0.0), z(0.0) { }
+    explicit Vector(Float v) : x(v), y(v), z(v) { }
+    Vector(Float x_, Float y_, Float z_) : x(x_), y(y_), z(z_) { }
+
+    Vector& operator += (const Vector& v) { x += v.x; y += v.y; z += v.z; return *this; }
+    Vector& operator -= (const Vector& v) { x -= v.x; y -= v.y; z -= v.z; return *this; }
+    Vector operator + (const Vector& v) const { return Vector(x + v.x, y + v.y, z + v.z); }
+    Vector operator - (const Vector& v) const { return Vector(x - v.x, y - v.y, z - v.z); }
+    Vector operator - () const { return Vector(-x, -y, -z); }
+    Vector operator * (Float s) const { return Vector(x * s, y * s, z * s); }
+    Bool operator == (const Vector& v) const { return x == v.x && y == v.y && z == v.z; }
+    Bool operator != (const Vector& v) const { return !(*this == v); }
+};
+
+/**
+ * An affine transformation, *off* is the position and *v1* to *v3*
+ * are the axes.
+ */
+struct Matrix {
+    Vector off, v1, v2, v3;
+
+    Matrix() : off(), v1(1.0, 0.0, 0.0), v2(0.0, 1.0, 0.0), v3(0.0, 0.0, 1.0) { }
+    Matrix(const Vector& off_, const Vector& v1_, const Vector& v2_, const Vector& v3_)
+    : off(off_), v1(v1_), v2(v2_), v3(v3_) { }
+
+    Vector operator * (const Vector& v) const {
+        return off + v1 * v.x + v2 * v.y + v3 * v.z;
+    }
+
+    Matrix operator * (const Matrix& m) const {
+        return Matrix(*this * m.off, v1 * m.v1.x + v2 * m.v1.y + v3 * m.v1.z,
+                      v1 * m.v2.x + v2 * m.v2.y + v3 * m.v2.z,
+                      v1 * m.v3.x + v2 * m.v3.y + v3 * m.v3.z);
+    }
+
+    Bool operator == (const Matrix& m) const {
+        return off == m.off && v1 == m.v1 && v2 == m.v2 && v3 == m.v3;
+    }
+};
+
+Matrix operator ~ (const Matrix& m);
+
+/**
+ * Memory
+ *
+ * Memory from NewMem() is released with DeleteMem(), objects from
+ * NewObj() with DeleteObj(). Both return nullptr instead of throwing
+ * when the memory can not be allocated, and the release functions
+ * set the pointer to nullptr.
+ */
+
+void* C4DHeadless_Alloc(Int size, Bool clear);
+
+#define NewMem(T, count) ((T*) C4DHeadless_Alloc((Int) sizeof(T) * (Int) (count), false))
+#define NewMemClear(T, count) ((T*) C4DHeadless_Alloc((Int) sizeof(T) * (Int) (count), true))
+#define NewObj(T, ...) (new (std::nothrow) T(__VA_ARGS__))
+#define NewObjClear(T, ...) (new (std::nothrow) T(__VA_ARGS__))
+
+template <typename T> inline void DeleteMem(T*& ptr) {
+    std::free((void*) ptr);
+    ptr = nullptr;
+}
+
+// A macro like in Cinema, so that classes with a private destructor
+// can delete their instances.
+#define DeleteObj(obj) do { delete (obj); (obj) = nullptr; } while (0)
+
+inline void CopyMem(const void* src, void* dst, Int size) {
+    if (size > 0) std::memmove(dst, src, (size_t) size);
+}
+
+inline void ClearMem(void* dst, Int size, Int32 value=0) {
+    if (size > 0) std::memset(dst, value, (size_t) size);
+}
+
+/**
+ * Debugging. The assertions are only checked in builds with
+ * C4D_DEBUG defined, like the debug builds of Cinema.
+ */
+
+void C4DHeadless_DebugStop(const Char* file, Int32 line);
+
+#ifdef C4D_DEBUG
+    #define DebugAssert(x) do { if (!(x)) C4DHeadless_DebugStop(__FILE__, __LINE__); } while (0)
+    #define DebugStop() C4DHeadless_DebugStop(__FILE__, __LINE__)
+#else
+    #define DebugAssert(x) ((void) 0)
+    #define DebugStop() ((void) 0)
+#endif
+
+/**
+ * Threading and timers
+ */
+
+class GeSpinlock {
+
+public:
+
+    GeSpinlock() : m_state(0) { }
+
+    void Lock() {
+        for (;;) {
+            Int32 expected = 0;
+            if (m_state.compare_exchange_weak(expected, 1, std::memory_order_acquire))
+                return;
+        }
+    }
+
+    Bool AttemptLock() {
+        Int32 expected = 0;
+        return m_state.compare_exchange_strong(expected, 1, std::memory_order_acquire);
+    }
+
+    void Unlock() {
+        m_state.store(0, std::memory_order_release);
+    }
+
+private:
+
+    GeSpinlock(const GeSpinlock&);
+    GeSpinlock& operator = (const GeSpinlock&);
+
+    std::atomic<Int32> m_state;
+
+};
+
+UInt GeGetCurrentThreadId();
+Int32 GeGetCurrentThreadCount();
+
+/**
+ * Milliseconds since the start of the process, GeGetMilliSeconds()
+ * with sub-millisecond precision.
+ */
+Float64 GeGetMilliSeconds();
+Int32 GeGetTimer();
+
+/**
+ * A linear congruential random number generator.
+ */
+class Random {
+
+public:
+
+    Random() : m_seed(0) { }
+
+    void Init(UInt32 seed) {
+        m_seed = seed;
+    }
+
+    Float Get01() {
+        m_seed = m_seed * 1664525u + 1013904223u;
+        return (Float) (m_seed >> 8) / (Float) (1u << 24);
+    }
+
+    Float Get11() {
+        return Get01() * 2.0 - 1.0;
+    }
+
+private:
+
+    UInt32 m_seed;
+
+};
+
+#endif /* C4D_HEADLESS_SYSTEM_H */
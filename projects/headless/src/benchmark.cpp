@@ -0,0 +1,36 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: runs the Floatlist benchmark without Cinema, the same
+ *    as the "Floatlist Benchmark" command with the arguments of the
+ *    benchmark (`-floatlist-benchmark-sizes`, `-floatlist-benchmark-out`)
+ */
+
+#include <c4d_headless.h>
+
+extern Bool Run_FloatlistBenchmark(BaseDocument* doc); // floatlist-benchmark.cpp
+
+int main(int argc, char** argv) {
+    Bool ok = headless::Startup((Int32) argc, argv)
+        && Run_FloatlistBenchmark(GetActiveDocument());
+    headless::Shutdown();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,454 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for BaseFile and HyperFile
+ */
+
+#include <c4d.h>
+
+/**
+ * MemoryFileStruct
+ */
+
+void MemoryFileStruct::GetData(void*& data, Int& size, Bool release) {
+    size = (Int) m_buffer.size();
+    if (!release) {
+        data = m_buffer.empty() ? nullptr : &m_buffer[0];
+        return;
+    }
+    UChar* copy = NewMem(UChar, size);
+    if (copy) CopyMem(m_buffer.data(), copy, size);
+    else size = 0;
+    data = copy;
+    m_buffer.clear();
+}
+
+/**
+ * BaseFile
+ */
+
+Bool BaseFile::Open(const Filename& name, FILEOPEN mode, FILEDIALOG error_dialog) {
+    Close();
+    m_error = false;
+    m_pos = 0;
+    m_writing = mode == FILEOPEN_WRITE || mode == FILEOPEN_APPEND || mode == FILEOPEN_SHAREDWRITE;
+
+    if (name.GetMemoryWrite()) {
+        if (!m_writing) return false;
+        m_write = name.GetMemoryWrite();
+        if (mode != FILEOPEN_APPEND) m_write->GetBuffer().clear();
+        m_pos = (Int) m_write->GetBuffer().size();
+        return true;
+    }
+    if (name.GetMemoryRead()) {
+        if (m_writing) return false;
+        m_read = static_cast<const UChar*>(name.GetMemoryRead());
+        m_size = name.GetMemorySize();
+        return true;
+    }
+
+    const Char* fmode = "rb";
+    if (mode == FILEOPEN_WRITE || mode == FILEOPEN_SHAREDWRITE) fmode = "wb";
+    else if (mode == FILEOPEN_APPEND) fmode = "ab";
+    else if (mode == FILEOPEN_READWRITE) fmode = "r+b";
+    m_file = std::fopen(name.GetString().GetUtf8().c_str(), fmode);
+    if (!m_file) return false;
+    if (mode == FILEOPEN_APPEND) m_pos = GetLength();
+    return true;
+}
+
+Bool BaseFile::Close() {
+    Bool ok = !m_error;
+    if (m_file && std::fclose(m_file) != 0)
+        ok = false;
+    m_file = nullptr;
+    m_write = nullptr;
+    m_read = nullptr;
+    m_size = 0;
+    m_pos = 0;
+    m_error = false;
+    return ok;
+}
+
+Bool BaseFile::WriteBytes(const void* data, Int len) {
+    if (len < 0 || (len > 0 && !data) || m_error) {
+        m_error = true;
+        return false;
+    }
+    if (m_write) {
+        std::vector<UChar>& buffer = m_write->GetBuffer();
+        const UChar* bytes = static_cast<const UChar*>(data);
+        buffer.insert(buffer.end(), bytes, bytes + len);
+        m_pos += len;
+        return true;
+    }
+    if (!m_file || !m_writing || std::fwrite(data, 1, (size_t) len, m_file) != (size_t) len) {
+        m_error = true;
+        return false;
+    }
+    m_pos += len;
+    return true;
+}
+
+Int BaseFile::ReadBytes(void* data, Int len, Bool just_try) {
+    Int count = 0;
+    if (len > 0 && data && !m_writing) {
+        if (m_read) {
+            count = Min(len, m_size - m_pos);
+            CopyMem(m_read + m_pos, data, count);
+        }
+        else if (m_file)
+            count = (Int) std::fread(data, 1, (size_t) len, m_file);
+    }
+    m_pos += count;
+    if (count != len && !just_try)
+        m_error = true;
+    return count;
+}
+
+Int BaseFile::GetLength() const {
+    if (m_write) return (Int) m_write->GetBuffer().size();
+    if (m_read) return m_size;
+    if (!m_file) return 0;
+    long pos = std::ftell(m_file);
+    std::fseek(m_file, 0, SEEK_END);
+    long length = std::ftell(m_file);
+    std::fseek(m_file, pos, SEEK_SET);
+    return (Int) length;
+}
+
+Bool BaseFile::Seek(Int pos, FILESEEK mode) {
+    Int target = mode == FILESEEK_START ? pos : m_pos + pos;
+    if (target < 0 || (m_write && target != m_pos)) return false;
+    if (m_read && target > m_size) return false;
+    if (m_file && std::fseek(m_file, (long) target, SEEK_SET) != 0) return false;
+    m_pos = target;
+    return true;
+}
+
+/**
+ * HyperFile
+ *
+ * The file starts with a magic number and the ident passed to
+ * Open(). Every value is a tag byte followed by the data in the
+ * byte order of the machine.
+ */
+
+static const UInt32 HYPERFILE_MAGIC = 0x48344443; // "C4DH"
+
+enum {
+    TAG_CHAR = 1,
+    TAG_UCHAR,
+    TAG_INT16,
+    TAG_INT32,
+    TAG_UINT32,
+    TAG_INT64,
+    TAG_UINT64,
+    TAG_FLOAT,
+    TAG_FLOAT32,
+    TAG_FLOAT64,
+    TAG_BOOL,
+    TAG_VECTOR,
+    TAG_STRING,
+    TAG_FILENAME,
+    TAG_MEMORY,
+    TAG_CONTAINER,
+    TAG_GEDATA,
+};
+
+Bool HyperFile::Open(Int32 ident, const Filename& filename, FILEOPEN mode, FILEDIALOG error_dialog) {
+    Close();
+    m_writing = mode == FILEOPEN_WRITE;
+    if (!m_file.Open(filename, m_writing ? FILEOPEN_WRITE : FILEOPEN_READ, error_dialog))
+        return false;
+
+    m_ident = ident;
+    if (m_writing)
+        m_open = WriteRaw(&HYPERFILE_MAGIC, sizeof(UInt32)) && WriteRaw(&ident, sizeof(Int32));
+    else {
+        UInt32 magic = 0;
+        Int32 fileIdent = 0;
+        m_open = ReadRaw(&magic, sizeof(UInt32)) && ReadRaw(&fileIdent, sizeof(Int32))
+              && magic == HYPERFILE_MAGIC && fileIdent == ident;
+    }
+    if (!m_open)
+        m_file.Close();
+    return m_open;
+}
+
+Bool HyperFile::Close() {
+    if (!m_open) return true;
+    m_open = false;
+    return m_file.Close();
+}
+
+Bool HyperFile::WriteRaw(const void* data, Int size) {
+    return m_file.WriteBytes(data, size);
+}
+
+Bool HyperFile::ReadRaw(void* data, Int size) {
+    return m_file.ReadBytes(data, size) == size;
+}
+
+Bool HyperFile::WriteTag(UChar tag) {
+    return m_open && m_writing && WriteRaw(&tag, 1);
+}
+
+Bool HyperFile::ReadTag(UChar tag) {
+    UChar found = 0;
+    return m_open && !m_writing && ReadRaw(&found, 1) && found == tag;
+}
+
+#define HYPERFILE_VALUE(Name, Type, TAG) \
+    Bool HyperFile::Write##Name(Type v) { \
+        return WriteTag(TAG) && WriteRaw(&v, sizeof(Type)); \
+    } \
+    Bool HyperFile::Read##Name(Type* v) { \
+        return v && ReadTag(TAG) && ReadRaw(v, sizeof(Type)); \
+    }
+
+HYPERFILE_VALUE(Char, Char, TAG_CHAR)
+HYPERFILE_VALUE(UChar, UChar, TAG_UCHAR)
+HYPERFILE_VALUE(Int16, Int16, TAG_INT16)
+HYPERFILE_VALUE(Int32, Int32, TAG_INT32)
+HYPERFILE_VALUE(UInt32, UInt32, TAG_UINT32)
+HYPERFILE_VALUE(Int64, Int64, TAG_INT64)
+HYPERFILE_VALUE(UInt64, UInt64, TAG_UINT64)
+HYPERFILE_VALUE(Float, Float, TAG_FLOAT)
+HYPERFILE_VALUE(Float32, Float32, TAG_FLOAT32)
+HYPERFILE_VALUE(Float64, Float64, TAG_FLOAT64)
+
+#undef HYPERFILE_VALUE
+
+Bool HyperFile::WriteBool(Bool v) {
+    UChar byte = v ? 1 : 0;
+    return WriteTag(TAG_BOOL) && WriteRaw(&byte, 1);
+}
+
+Bool HyperFile::ReadBool(Bool* v) {
+    UChar byte = 0;
+    if (!v || !ReadTag(TAG_BOOL) || !ReadRaw(&byte, 1)) return false;
+    *v = byte != 0;
+    return true;
+}
+
+Bool HyperFile::WriteVector(const Vector& v) {
+    return WriteTag(TAG_VECTOR) && WriteRaw(&v.x, sizeof(Float)) && WriteRaw(&v.y, sizeof(Float))
+        && WriteRaw(&v.z, sizeof(Float));
+}
+
+Bool HyperFile::ReadVector(Vector* v) {
+    return v && ReadTag(TAG_VECTOR) && ReadRaw(&v->x, sizeof(Float)) && ReadRaw(&v->y, sizeof(Float))
+        && ReadRaw(&v->z, sizeof(Float));
+}
+
+/**
+ * Strings and memory blocks are stored with their size in bytes.
+ */
+static Bool ReadBlock(BaseFile& file, std::string& out) {
+    Int64 size = 0;
+    if (file.ReadBytes(&size, sizeof(Int64)) != sizeof(Int64) || size < 0
+            || size > file.GetLength() - file.GetPosition())
+        return false;
+    out.resize((size_t) size);
+    return size == 0 || file.ReadBytes(&out[0], size) == size;
+}
+
+static Bool WriteBlock(BaseFile& file, const void* data, Int size) {
+    Int64 size64 = size;
+    return file.WriteBytes(&size64, sizeof(Int64)) && (size == 0 || file.WriteBytes(data, size));
+}
+
+Bool HyperFile::WriteString(const String& v) {
+    return WriteTag(TAG_STRING) && WriteBlock(m_file, v.GetUtf8().data(), (Int) v.GetUtf8().size());
+}
+
+Bool HyperFile::ReadString(String* v) {
+    std::string bytes;
+    if (!v || !ReadTag(TAG_STRING) || !ReadBlock(m_file, bytes)) return false;
+    v->SetCString(bytes.data(), (Int) bytes.size());
+    return true;
+}
+
+Bool HyperFile::WriteFilename(const Filename& v) {
+    String path = v.GetString();
+    return WriteTag(TAG_FILENAME) && WriteBlock(m_file, path.GetUtf8().data(), (Int) path.GetUtf8().size());
+}
+
+Bool HyperFile::ReadFilename(Filename* v) {
+    std::string bytes;
+    if (!v || !ReadTag(TAG_FILENAME) || !ReadBlock(m_file, bytes)) return false;
+    String path;
+    path.SetCString(bytes.data(), (Int) bytes.size());
+    *v = Filename(path);
+    return true;
+}
+
+Bool HyperFile::WriteMemory(const void* data, Int count) {
+    return WriteTag(TAG_MEMORY) && WriteBlock(m_file, data, count);
+}
+
+Bool HyperFile::ReadMemory(void** data, Int* size) {
+    if (!data || !size || !ReadTag(TAG_MEMORY)) return false;
+    Int64 count = 0;
+    if (!ReadRaw(&count, sizeof(Int64)) || count < 0
+            || count > m_file.GetLength() - m_file.GetPosition())
+        return false;
+    UChar* memory = NewMem(UChar, count);
+    if (!memory) return false;
+    if (count > 0 && !ReadRaw(memory, count)) {
+        DeleteMem(memory);
+        return false;
+    }
+    *data = memory;
+    *size = (Int) count;
+    return true;
+}
+
+Bool HyperFile::WriteContainer(const BaseContainer& v) {
+    if (!WriteTag(TAG_CONTAINER)) return false;
+    Int32 id = v.GetId();
+    Int32 count = 0;
+    while (v.GetIndexId(count) != NOTOK) count++;
+    if (!WriteRaw(&id, sizeof(Int32)) || !WriteRaw(&count, sizeof(Int32))) return false;
+    for (Int32 i=0; i < count; i++) {
+        Int32 entry = v.GetIndexId(i);
+        if (!WriteRaw(&entry, sizeof(Int32)) || !WriteGeDataValue(*v.GetIndexData(i)))
+            return false;
+    }
+    return true;
+}
+
+Bool HyperFile::ReadContainer(BaseContainer* v, Bool flush) {
+    Int32 id, count;
+    if (!v || !ReadTag(TAG_CONTAINER) || !ReadRaw(&id, sizeof(Int32)) || !ReadRaw(&count, sizeof(Int32))
+            || count < 0)
+        return false;
+    if (flush) v->FlushAll();
+    v->SetId(id);
+    for (Int32 i=0; i < count; i++) {
+        // The value is read into the container, copying it would
+        // drop the state that custom data does not copy.
+        Int32 entry;
+        if (!ReadRaw(&entry, sizeof(Int32))) return false;
+        v->SetData(entry, GeData());
+        if (!ReadGeDataValue(v->Find(entry))) return false;
+    }
+    return true;
+}
+
+Bool HyperFile::WriteGeData(const GeData& v) {
+    return WriteTag(TAG_GEDATA) && WriteGeDataValue(v);
+}
+
+Bool HyperFile::ReadGeData(GeData* v) {
+    return v && ReadTag(TAG_GEDATA) && ReadGeDataValue(v);
+}
+
+Bool HyperFile::WriteGeDataValue(const GeData& v) {
+    Int32 type = v.GetType();
+    if (!WriteRaw(&type, sizeof(Int32))) return false;
+    switch (type) {
+        case DA_NIL:
+        case DA_VOID:
+            return true;
+        case DA_LONG:
+        case DA_LLONG:
+            return WriteInt64(v.GetInt64());
+        case DA_REAL:
+            return WriteFloat(v.GetFloat());
+        case DA_VECTOR:
+            return WriteVector(v.GetVector());
+        case DA_STRING:
+            return WriteString(v.GetString());
+        case DA_FILENAME:
+            return WriteFilename(v.GetFilename());
+        case DA_CONTAINER:
+            return WriteContainer(*v.GetContainer());
+        case DA_ALIASLINK:
+            return false; // links are not supported
+    }
+
+    // Custom data is written by its datatype together with the disk
+    // level, which is passed to ReadData().
+    CustomDataTypeClass* plugin = FindCustomDataTypePlugin(type);
+    Int32 level = C4DHeadless_GetDataTypeLevel(type);
+    return plugin && WriteRaw(&level, sizeof(Int32))
+        && plugin->WriteData(v.GetCustomDataType(type), this);
+}
+
+Bool HyperFile::ReadGeDataValue(GeData* v) {
+    Int32 type;
+    if (!ReadRaw(&type, sizeof(Int32))) return false;
+    switch (type) {
+        case DA_NIL:
+        case DA_VOID:
+            *v = GeData();
+            return true;
+        case DA_LONG:
+        case DA_LLONG: {
+            Int64 value;
+            if (!ReadInt64(&value)) return false;
+            if (type == DA_LONG) v->SetInt32((Int32) value);
+            else v->SetInt64(value);
+            return true;
+        }
+        case DA_REAL: {
+            Float value;
+            if (!ReadFloat(&value)) return false;
+            v->SetFloat(value);
+            return true;
+        }
+        case DA_VECTOR: {
+            Vector value;
+            if (!ReadVector(&value)) return false;
+            v->SetVector(value);
+            return true;
+        }
+        case DA_STRING: {
+            String value;
+            if (!ReadString(&value)) return false;
+            v->SetString(value);
+            return true;
+        }
+        case DA_FILENAME: {
+            Filename value;
+            if (!ReadFilename(&value)) return false;
+            v->SetFilename(value);
+            return true;
+        }
+        case DA_CONTAINER: {
+            BaseContainer value;
+            return ReadContainer(&value, true) && v->SetContainer(value);
+        }
+        case DA_ALIASLINK:
+            return false;
+    }
+
+    Int32 level;
+    CustomDataTypeClass* plugin = FindCustomDataTypePlugin(type);
+    if (!plugin || !ReadRaw(&level, sizeof(Int32))) return false;
+    CustomDataType* data = plugin->AllocData();
+    if (!data) return false;
+    v->Set(type);
+    v->m_custom = data;
+    return plugin->ReadData(data, this, level);
+}
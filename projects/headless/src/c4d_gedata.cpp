@@ -0,0 +1,339 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for GeData, BaseContainer and the
+ *    description classes
+ */
+
+#include <c4d.h>
+
+/**
+ * GeData
+ */
+
+void GeData::Free() {
+    if (m_custom) {
+        CustomDataTypeClass* type = FindCustomDataTypePlugin(m_type);
+        if (type) type->FreeData(m_custom);
+        m_custom = nullptr;
+    }
+    DeleteObj(m_container);
+    m_type = DA_NIL;
+    m_int = 0;
+    m_float = 0.0;
+    m_vector = Vector();
+    m_string = String();
+    m_filename = Filename();
+    m_link = nullptr;
+}
+
+Bool GeData::CopyData(const GeData& other) {
+    if (other.m_custom)
+        return SetCustomDataType(other.m_type, *other.m_custom);
+    if (other.m_container)
+        return SetContainer(*other.m_container);
+
+    Free();
+    m_type = other.m_type;
+    m_int = other.m_int;
+    m_float = other.m_float;
+    m_vector = other.m_vector;
+    m_string = other.m_string;
+    m_filename = other.m_filename;
+    m_link = other.m_link;
+    return true;
+}
+
+Bool GeData::operator == (const GeData& other) const {
+    if (m_type != other.m_type)
+        return false;
+    switch (m_type) {
+        case DA_NIL:
+        case DA_VOID:
+            return true;
+        case DA_LONG:
+        case DA_LLONG:
+            return m_int == other.m_int;
+        case DA_REAL:
+            return m_float == other.m_float;
+        case DA_VECTOR:
+            return m_vector == other.m_vector;
+        case DA_STRING:
+            return m_string == other.m_string;
+        case DA_FILENAME:
+            return m_filename == other.m_filename;
+        case DA_ALIASLINK:
+            return m_link == other.m_link;
+        case DA_CONTAINER:
+            return m_container && other.m_container && *m_container == *other.m_container;
+    }
+    if (!m_custom || !other.m_custom)
+        return m_custom == other.m_custom;
+    CustomDataTypeClass* type = FindCustomDataTypePlugin(m_type);
+    return type && type->Compare(m_custom, other.m_custom) == 0;
+}
+
+Bool GeData::SetContainer(const BaseContainer& value) {
+    BaseContainer* copy = NewObj(BaseContainer, value);
+    if (!copy) return false;
+    Set(DA_CONTAINER);
+    m_container = copy;
+    return true;
+}
+
+Bool GeData::SetCustomDataType(Int32 type, const CustomDataType& data) {
+    CustomDataTypeClass* plugin = FindCustomDataTypePlugin(type);
+    if (!plugin) {
+        Free();
+        return false;
+    }
+    CustomDataType* copy = plugin->AllocData();
+    if (!copy || !plugin->CopyData(&data, copy, nullptr)) {
+        if (copy) plugin->FreeData(copy);
+        Free();
+        return false;
+    }
+    Set(type);
+    m_custom = copy;
+    return true;
+}
+
+/**
+ * BaseContainer
+ */
+
+GeData* BaseContainer::Find(Int32 id) {
+    for (Entry& entry : m_entries) {
+        if (entry.id == id) return &entry.data;
+    }
+    return nullptr;
+}
+
+const GeData* BaseContainer::Find(Int32 id) const {
+    for (const Entry& entry : m_entries) {
+        if (entry.id == id) return &entry.data;
+    }
+    return nullptr;
+}
+
+Bool BaseContainer::operator == (const BaseContainer& other) const {
+    if (m_id != other.m_id || m_entries.size() != other.m_entries.size())
+        return false;
+    for (const Entry& entry : m_entries) {
+        const GeData* data = other.Find(entry.id);
+        if (!data || *data != entry.data) return false;
+    }
+    return true;
+}
+
+const GeData& BaseContainer::GetData(Int32 id) const {
+    static const GeData empty;
+    const GeData* data = Find(id);
+    return data ? *data : empty;
+}
+
+const GeData* BaseContainer::GetDataPointer(Int32 id) const {
+    return Find(id);
+}
+
+void BaseContainer::SetData(Int32 id, const GeData& data) {
+    GeData* existing = Find(id);
+    if (existing) {
+        *existing = data;
+        return;
+    }
+    Entry entry;
+    entry.id = id;
+    entry.data = data;
+    m_entries.push_back(entry);
+}
+
+Bool BaseContainer::RemoveData(Int32 id) {
+    for (size_t i=0; i < m_entries.size(); i++) {
+        if (m_entries[i].id == id) {
+            m_entries.erase(m_entries.begin() + i);
+            return true;
+        }
+    }
+    return false;
+}
+
+Bool BaseContainer::GetBool(Int32 id, Bool preset) const {
+    const GeData* data = Find(id);
+    return data ? data->GetBool() : preset;
+}
+
+Int32 BaseContainer::GetInt32(Int32 id, Int32 preset) const {
+    const GeData* data = Find(id);
+    return data ? data->GetInt32() : preset;
+}
+
+Int64 BaseContainer::GetInt64(Int32 id, Int64 preset) const {
+    const GeData* data = Find(id);
+    return data ? data->GetInt64() : preset;
+}
+
+Float BaseContainer::GetFloat(Int32 id, Float preset) const {
+    const GeData* data = Find(id);
+    return data ? data->GetFloat() : preset;
+}
+
+Vector BaseContainer::GetVector(Int32 id, const Vector& preset) const {
+    const GeData* data = Find(id);
+    return data && data->GetType() == DA_VECTOR ? data->GetVector() : preset;
+}
+
+String BaseContainer::GetString(Int32 id, const String& preset) const {
+    const GeData* data = Find(id);
+    return data && data->GetType() == DA_STRING ? data->GetString() : preset;
+}
+
+Filename BaseContainer::GetFilename(Int32 id, const Filename& preset) const {
+    const GeData* data = Find(id);
+    return data && data->GetType() == DA_FILENAME ? data->GetFilename() : preset;
+}
+
+BaseContainer BaseContainer::GetContainer(Int32 id) const {
+    BaseContainer* bc = GetContainerInstance(id);
+    return bc ? *bc : BaseContainer();
+}
+
+BaseContainer* BaseContainer::GetContainerInstance(Int32 id) const {
+    const GeData* data = Find(id);
+    return data ? data->GetContainer() : nullptr;
+}
+
+BaseContainer GetCustomDataTypeDefault(Int32 type) {
+    BaseContainer bc(type);
+    bc.SetInt32(DESC_ANIMATE, DESC_ANIMATE_ON);
+    if (type == DA_REAL) {
+        bc.SetFloat(DESC_MIN, -1e20);
+        bc.SetFloat(DESC_MAX, 1e20);
+        bc.SetFloat(DESC_STEP, 1.0);
+        bc.SetInt32(DESC_UNIT, DESC_UNIT_FLOAT);
+        bc.SetInt32(DESC_CUSTOMGUI, CUSTOMGUI_REAL);
+        return bc;
+    }
+
+    // Custom datatypes add their own defaults.
+    CustomDataTypeClass* plugin = FindCustomDataTypePlugin(type);
+    if (plugin) plugin->GetDefaultProperties(bc);
+    return bc;
+}
+
+/**
+ * DescID
+ */
+
+const DescID DESCID_ROOT(DescLevel(1000491, 0, 0));
+
+DescID DescID::GetSubID(Int32 skip) const {
+    DescID result;
+    for (Int32 i=skip; i < GetDepth(); i++)
+        result.PushId(m_levels[i]);
+    return result;
+}
+
+UInt32 DescID::GetHash() const {
+    UInt32 hash = 2166136261u;
+    for (const DescLevel& level : m_levels)
+        hash = (hash ^ (UInt32) level.id) * 16777619u;
+    return hash;
+}
+
+Bool DescID::Read(HyperFile* hf) {
+    m_levels.clear();
+    Int32 depth;
+    if (!hf->ReadInt32(&depth) || depth < 0) return false;
+    for (Int32 i=0; i < depth; i++) {
+        DescLevel level;
+        if (!hf->ReadInt32(&level.id) || !hf->ReadInt32(&level.dtype)
+                || !hf->ReadInt32(&level.creator))
+            return false;
+        PushId(level);
+    }
+    return true;
+}
+
+Bool DescID::Write(HyperFile* hf) const {
+    if (!hf->WriteInt32(GetDepth())) return false;
+    for (const DescLevel& level : m_levels) {
+        if (!hf->WriteInt32(level.id) || !hf->WriteInt32(level.dtype)
+                || !hf->WriteInt32(level.creator))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Description
+ */
+
+Int Description::FindIndex(const DescID& id) const {
+    auto range = m_index.equal_range(id.GetHash());
+    for (auto it = range.first; it != range.second; ++it) {
+        if (m_params[it->second].id == id)
+            return (Int) it->second;
+    }
+    return -1;
+}
+
+Bool Description::SetParameter(const DescID& id, const BaseContainer& param, const DescID& groupid) {
+    Int index = FindIndex(id);
+    if (index >= 0) {
+        m_params[index].bc = param;
+        m_params[index].groupid = groupid;
+        return true;
+    }
+    Param p;
+    p.id = id;
+    p.groupid = groupid;
+    p.bc = param;
+    m_params.push_back(std::move(p));
+    m_index.emplace(id.GetHash(), m_params.size() - 1);
+    return true;
+}
+
+const BaseContainer* Description::GetParameterI(const DescID& id, AtomArray* ar) const {
+    Int index = FindIndex(id);
+    return index >= 0 ? &m_params[index].bc : nullptr;
+}
+
+void* Description::BrowseInit() {
+    return NewObj(size_t, 0);
+}
+
+Bool Description::GetNext(void* handle, const BaseContainer** bc, DescID& id, DescID& groupid) {
+    size_t* index = static_cast<size_t*>(handle);
+    if (!index || *index >= m_params.size())
+        return false;
+    const Param& p = m_params[(*index)++];
+    if (bc) *bc = &p.bc;
+    id = p.id;
+    groupid = p.groupid;
+    return true;
+}
+
+void Description::BrowseFree(void*& handle) {
+    size_t* index = static_cast<size_t*>(handle);
+    DeleteObj(index);
+    handle = nullptr;
+}
@@ -0,0 +1,190 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for dialogs, custom GUIs and the
+ *    input state
+ */
+
+#include <c4d.h>
+#include <c4d_headless.h>
+
+/**
+ * GeDialog
+ */
+
+Bool GeDialog::AddWidget(Int32 id, const GeData& value) {
+    Widget& widget = m_widgets[id];
+    widget.hidden = false;
+    widget.tristate = false;
+    widget.value = value;
+    return true;
+}
+
+Bool GeDialog::SetValue(Int32 id, const GeData& value, Bool tristate) {
+    auto it = m_widgets.find(id);
+    if (it == m_widgets.end()) return false;
+    it->second.value = value;
+    it->second.tristate = tristate;
+    return true;
+}
+
+const GeDialog::Widget* GeDialog::Find(Int32 id) const {
+    auto it = m_widgets.find(id);
+    return it != m_widgets.end() ? &it->second : nullptr;
+}
+
+Bool GeDialog::GroupBegin(Int32 id, Int32 flags, Int32 cols, Int32 rows, const String& title,
+                          Int32 groupflags, Int32 initw, Int32 inith) {
+    return AddWidget(id, GeData());
+}
+
+Bool GeDialog::AddStaticText(Int32 id, Int32 flags, Int32 initw, Int32 inith, const String& name,
+                             Int32 borderstyle) {
+    return AddWidget(id, GeData(name));
+}
+
+Bool GeDialog::AddButton(Int32 id, Int32 flags, Int32 initw, Int32 inith, const String& name) {
+    return AddWidget(id, GeData(name));
+}
+
+Bool GeDialog::AddSlider(Int32 id, Int32 flags, Int32 initw, Int32 inith) {
+    return AddWidget(id, GeData(0.0));
+}
+
+Bool GeDialog::AddEditSlider(Int32 id, Int32 flags, Int32 initw, Int32 inith) {
+    return AddWidget(id, GeData(0.0));
+}
+
+Bool GeDialog::AddEditNumber(Int32 id, Int32 flags, Int32 initw, Int32 inith) {
+    return AddWidget(id, GeData(0.0));
+}
+
+Bool GeDialog::AddCheckbox(Int32 id, Int32 flags, Int32 initw, Int32 inith, const String& name) {
+    return AddWidget(id, GeData((Int32) 0));
+}
+
+Bool GeDialog::LayoutFlushGroup(Int32 id) {
+    m_widgets.clear();
+    return true;
+}
+
+Bool GeDialog::HideElement(Int32 id, Bool hide) {
+    auto it = m_widgets.find(id);
+    if (it == m_widgets.end()) return false;
+    it->second.hidden = hide;
+    return true;
+}
+
+Bool GeDialog::IsHidden(Int32 id) const {
+    const Widget* widget = Find(id);
+    return widget && widget->hidden;
+}
+
+Bool GeDialog::SetString(Int32 id, const String& value) {
+    return SetValue(id, GeData(value));
+}
+
+Bool GeDialog::SetInt32(Int32 id, Int32 value, Int32 min, Int32 max, Int32 step, Bool tristate) {
+    return SetValue(id, GeData(value), tristate);
+}
+
+Bool GeDialog::SetFloat(Int32 id, Float value, Float min, Float max, Float step, Bool tristate) {
+    return SetValue(id, GeData(value), tristate);
+}
+
+Bool GeDialog::SetPercent(Int32 id, Float value, Float min, Float max, Float step, Bool tristate) {
+    return SetValue(id, GeData(value / 100.0), tristate);
+}
+
+Bool GeDialog::SetBool(Int32 id, Bool value) {
+    return SetValue(id, GeData((Int32) value));
+}
+
+Bool GeDialog::GetString(Int32 id, String& value) const {
+    const Widget* widget = Find(id);
+    if (!widget) return false;
+    value = widget->value.GetString();
+    return true;
+}
+
+Bool GeDialog::GetInt32(Int32 id, Int32& value) const {
+    const Widget* widget = Find(id);
+    if (!widget) return false;
+    value = widget->value.GetInt32();
+    return true;
+}
+
+Bool GeDialog::GetFloat(Int32 id, Float& value) const {
+    const Widget* widget = Find(id);
+    if (!widget) return false;
+    value = widget->value.GetFloat();
+    return true;
+}
+
+Bool GeDialog::GetBool(Int32 id, Bool& value) const {
+    const Widget* widget = Find(id);
+    if (!widget) return false;
+    value = widget->value.GetBool();
+    return true;
+}
+
+Bool GeDialog::Open(Int32 xpos, Int32 ypos, Int32 defaultw, Int32 defaulth) {
+    m_widgets.clear();
+    return CreateLayout() && InitValues();
+}
+
+Bool SubDialog::SendParentMessage(const BaseContainer& msg) {
+    return m_parentFn ? m_parentFn(msg, m_parentData) : false;
+}
+
+/**
+ * Dialogs and input
+ */
+
+void MessageDialog(const String& str) {
+    GePrint(str);
+}
+
+Bool QuestionDialog(const String& str) {
+    GePrint(str);
+    return false;
+}
+
+Bool RenameDialog(String* str) {
+    return false;
+}
+
+static Int32 g_qualifiers = 0;
+
+void headless::SetQualifiers(Int32 qualifiers) {
+    g_qualifiers = qualifiers;
+}
+
+Bool GetInputState(Int32 askdevice, Int32 askchannel, BaseContainer& res) {
+    if (askdevice != BFM_INPUT_KEYBOARD && askdevice != BFM_INPUT_MOUSE)
+        return false;
+    res.FlushAll();
+    res.SetInt32(BFM_INPUT_DEVICE, askdevice);
+    res.SetInt32(BFM_INPUT_CHANNEL, askchannel);
+    res.SetInt32(BFM_INPUT_VALUE, 0);
+    res.SetInt32(BFM_INPUT_QUALIFIER, g_qualifiers);
+    return true;
+}
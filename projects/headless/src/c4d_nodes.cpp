@@ -0,0 +1,1041 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for the node classes, documents,
+ *    selections, tracks and threads
+ */
+
+#include <algorithm>
+#include <unordered_map>
+#include <c4d.h>
+
+/**
+ * GeListNode
+ */
+
+GeListNode::~GeListNode() {
+    DebugAssert(m_down == nullptr && m_nodeData == nullptr);
+}
+
+GeListNode* GeListNode::GetDownLast() const {
+    GeListNode* node = m_down;
+    while (node && node->m_next) node = node->m_next;
+    return node;
+}
+
+void GeListNode::InsertBefore(GeListNode* bl) {
+    if (!bl || bl == this) return;
+    Remove();
+    m_up = bl->m_up;
+    m_head = bl->m_head;
+    m_pred = bl->m_pred;
+    m_next = bl;
+    if (m_pred) m_pred->m_next = this;
+    else if (m_up) m_up->m_down = this;
+    else if (m_head) m_head->first = this;
+    bl->m_pred = this;
+}
+
+void GeListNode::InsertAfter(GeListNode* bl) {
+    if (!bl || bl == this) return;
+    Remove();
+    m_up = bl->m_up;
+    m_head = bl->m_head;
+    m_pred = bl;
+    m_next = bl->m_next;
+    if (m_next) m_next->m_pred = this;
+    bl->m_next = this;
+}
+
+void GeListNode::InsertUnder(GeListNode* bl) {
+    if (!bl || bl == this) return;
+    Remove();
+    m_up = bl;
+    m_next = bl->m_down;
+    if (m_next) m_next->m_pred = this;
+    bl->m_down = this;
+}
+
+void GeListNode::InsertUnderLast(GeListNode* bl) {
+    if (!bl || bl == this) return;
+    GeListNode* last = bl->GetDownLast();
+    if (last) InsertAfter(last);
+    else InsertUnder(bl);
+}
+
+void GeListNode::InsertHead(GeListHead* head, GeListNode* pred) {
+    if (!head) return;
+    if (pred) {
+        InsertAfter(pred);
+        return;
+    }
+    Remove();
+    m_head = head;
+    m_next = head->first;
+    if (m_next) m_next->m_pred = this;
+    head->first = this;
+}
+
+void GeListNode::Remove() {
+    if (m_pred) m_pred->m_next = m_next;
+    else if (m_up) m_up->m_down = m_next;
+    else if (m_head && m_head->first == this) m_head->first = m_next;
+    if (m_next) m_next->m_pred = m_pred;
+    m_next = m_pred = m_up = nullptr;
+    m_head = nullptr;
+}
+
+BaseDocument* GeListNode::GetDocument() const {
+    const GeListNode* node = this;
+    while (node->m_up) node = node->m_up;
+    if (node->GetType() == Tbasedocument)
+        return static_cast<BaseDocument*>(const_cast<GeListNode*>(node));
+    if (node->m_head && node->m_head->owner)
+        return node->m_head->owner->GetDocument();
+    return nullptr;
+}
+
+void GeListNode::FreeNode() {
+    Remove();
+    while (m_down) {
+        GeListNode* child = m_down;
+        child->Remove();
+        delete child;
+    }
+    if (m_nodeData) {
+        m_nodeData->Free(this);
+        delete m_nodeData;
+        m_nodeData = nullptr;
+    }
+}
+
+Bool GeListNode::InitNodeData(Int32 id) {
+    m_nodeData = C4DHeadless_AllocNodeData(id);
+    if (!m_nodeData) return false;
+    m_nodeData->m_node = this;
+    return m_nodeData->Init(this);
+}
+
+/**
+ * BaseList2D
+ *
+ * Every node gets a serial number that is never reused, BaseLinks
+ * look the node up by it.
+ */
+
+static GeSpinlock g_nodesLock;
+static std::unordered_map<UInt64, BaseList2D*> g_nodes;
+static UInt64 g_nextSerial = 1;
+
+BaseList2D::BaseList2D(Int32 type)
+: GeListNode(type), m_bits(0), m_tracks(this), m_serial(0) {
+    g_nodesLock.Lock();
+    m_serial = g_nextSerial++;
+    g_nodes[m_serial] = this;
+    g_nodesLock.Unlock();
+}
+
+BaseList2D::~BaseList2D() {
+    while (m_tracks.first) {
+        GeListNode* track = m_tracks.first;
+        track->Remove();
+        delete track;
+    }
+    g_nodesLock.Lock();
+    g_nodes.erase(m_serial);
+    g_nodesLock.Unlock();
+    FreeNode();
+}
+
+BaseList2D* C4DHeadless_FindNode(UInt64 serial) {
+    g_nodesLock.Lock();
+    auto it = g_nodes.find(serial);
+    BaseList2D* node = it != g_nodes.end() ? it->second : nullptr;
+    g_nodesLock.Unlock();
+    return node;
+}
+
+Bool BaseList2D::GetParameter(const DescID& id, GeData& t_data, DESCFLAGS_GET flags) {
+    if (id.GetDepth() <= 0) return false;
+    const GeData* data = m_data.GetDataPointer(id[0].id);
+    if (!data) return false;
+    if (id.GetDepth() == 1) {
+        t_data = *data;
+        return true;
+    }
+
+    CustomDataTypeClass* plugin = FindCustomDataTypePlugin(data->GetType());
+    if (!plugin) return false;
+    return plugin->GetParameter(data->GetCustomDataType(data->GetType()), id.GetSubID(1), t_data, flags);
+}
+
+Bool BaseList2D::SetParameter(const DescID& id, const GeData& t_data, DESCFLAGS_SET flags) {
+    if (id.GetDepth() <= 0) return false;
+    if (id.GetDepth() == 1) {
+        m_data.SetData(id[0].id, t_data);
+        return true;
+    }
+
+    const GeData* data = m_data.GetDataPointer(id[0].id);
+    CustomDataTypeClass* plugin = data ? FindCustomDataTypePlugin(data->GetType()) : nullptr;
+    if (!plugin) return false;
+    return plugin->SetDParameter(data->GetCustomDataType(data->GetType()), id.GetSubID(1), t_data, flags);
+}
+
+Bool BaseList2D::GetDescription(Description* desc, DESCFLAGS_DESC flags) {
+    if (!desc) return false;
+    for (Int32 i=0; m_data.GetIndexId(i) != NOTOK; i++) {
+        Int32 id = m_data.GetIndexId(i);
+        Int32 type = m_data.GetIndexData(i)->GetType();
+        BaseContainer bc = GetCustomDataTypeDefault(type);
+        bc.SetString(DESC_NAME, String::IntToString(id));
+        if (!desc->SetParameter(DescID(DescLevel(id, type, 0)), bc, DESCID_ROOT))
+            return false;
+    }
+    return true;
+}
+
+Bool BaseList2D::Message(Int32 type, void* data) {
+    return m_nodeData ? m_nodeData->Message(this, type, data) : true;
+}
+
+CTrack* BaseList2D::GetFirstCTrack() const {
+    return static_cast<CTrack*>(m_tracks.first);
+}
+
+CTrack* BaseList2D::FindCTrack(const DescID& id) const {
+    for (CTrack* track = GetFirstCTrack(); track; track = track->GetNext()) {
+        if (track->GetDescriptionID() == id)
+            return track;
+    }
+    return nullptr;
+}
+
+void BaseList2D::InsertTrackSorted(CTrack* track) {
+    if (!track) return;
+    GeListNode* last = m_tracks.first;
+    while (last && last->GetNext()) last = last->GetNext();
+    track->InsertHead(&m_tracks, last != track ? last : nullptr);
+}
+
+Bool BaseList2D::CopyBaseTo(BaseList2D* dest, COPYFLAGS flags, AliasTrans* trn) {
+    dest->m_name = m_name;
+    dest->m_data = m_data;
+    dest->m_bits = m_bits;
+
+    if (!(flags & COPYFLAGS_NO_ANIMATION)) {
+        CTrack* pred = nullptr;
+        for (CTrack* track = GetFirstCTrack(); track; track = track->GetNext()) {
+            CTrack* clone = static_cast<CTrack*>(track->GetClone(flags, trn));
+            if (!clone) return false;
+            clone->InsertHead(&dest->m_tracks, pred);
+            pred = clone;
+        }
+    }
+
+    if (!m_nodeData) return true;
+    if (!dest->m_nodeData && !dest->InitNodeData(GetType())) return false;
+    return m_nodeData->CopyTo(dest->m_nodeData, this, dest, flags, trn);
+}
+
+/**
+ * BaseTag
+ */
+
+BaseTag* BaseTag::Alloc(Int32 type) {
+    BaseTag* tag = NewObj(BaseTag, type);
+    if (tag && type == Tphong) tag->SetName("Phong");
+    return tag;
+}
+
+void BaseTag::Free(BaseTag*& tag) {
+    if (tag) tag->Remove();
+    DeleteObj(tag);
+}
+
+BaseObject* BaseTag::GetObject() const {
+    return m_head ? static_cast<BaseObject*>(m_head->owner) : nullptr;
+}
+
+C4DAtom* BaseTag::GetClone(COPYFLAGS flags, AliasTrans* trn) {
+    BaseTag* clone = NewObj(BaseTag, GetType());
+    if (clone && !CopyBaseTo(clone, flags, trn))
+        DeleteObj(clone);
+    return clone;
+}
+
+/**
+ * BaseObject
+ */
+
+BaseObject::BaseObject(Int32 type) : BaseList2D(type), m_tags(this) { }
+
+BaseObject::~BaseObject() {
+    while (m_tags.first) {
+        GeListNode* tag = m_tags.first;
+        tag->Remove();
+        delete tag;
+    }
+}
+
+BaseObject* BaseObject::Alloc(Int32 type) {
+    if (type == Opolygon)
+        return PolygonObject::Alloc(0, 0);
+
+    BaseObject* op = NewObj(BaseObject, type);
+    if (!op) return nullptr;
+    switch (type) {
+        case Ocube:
+            op->SetName("Cube");
+            op->m_data.SetVector(PRIM_CUBE_LEN, Vector(200.0));
+            break;
+        case Osphere:
+            op->SetName("Sphere");
+            op->m_data.SetFloat(PRIM_SPHERE_RAD, 100.0);
+            op->m_data.SetInt32(PRIM_SPHERE_SUB, 24);
+            break;
+        case Onull:
+            op->SetName("Null");
+            break;
+        default:
+            op->SetName("Object");
+            break;
+    }
+    return op;
+}
+
+void BaseObject::Free(BaseObject*& op) {
+    if (op) op->Remove();
+    DeleteObj(op);
+}
+
+Matrix BaseObject::GetMg() const {
+    return GetUpMg() * m_ml;
+}
+
+void BaseObject::SetMg(const Matrix& m) {
+    m_ml = ~GetUpMg() * m;
+}
+
+Matrix BaseObject::GetUpMg() const {
+    return GetUp() ? GetUp()->GetMg() : Matrix();
+}
+
+BaseTag* BaseObject::GetTag(Int32 type, Int32 nr) const {
+    for (BaseTag* tag = GetFirstTag(); tag; tag = tag->GetNext()) {
+        if (tag->GetType() == type && nr-- <= 0)
+            return tag;
+    }
+    return nullptr;
+}
+
+void BaseObject::InsertTag(BaseTag* tag, BaseTag* pred) {
+    if (tag) tag->InsertHead(&m_tags, pred);
+}
+
+Bool BaseObject::Message(Int32 type, void* data) {
+    // Like in Cinema, a new sphere adds a phong tag to itself.
+    if (type == MSG_MENUPREPARE && GetType() == Osphere && !GetTag(Tphong)) {
+        BaseTag* phong = BaseTag::Alloc(Tphong);
+        if (phong) InsertTag(phong);
+    }
+    return BaseList2D::Message(type, data);
+}
+
+BaseObject* BaseObject::AllocSame() const {
+    return NewObj(BaseObject, GetType());
+}
+
+Bool BaseObject::CopyObjectTo(BaseObject* dest, COPYFLAGS flags, AliasTrans* trn) {
+    if (!CopyBaseTo(dest, flags, trn)) return false;
+    dest->m_ml = m_ml;
+
+    BaseTag* pred = nullptr;
+    for (BaseTag* tag = GetFirstTag(); tag; tag = tag->GetNext()) {
+        BaseTag* clone = static_cast<BaseTag*>(tag->GetClone(flags, trn));
+        if (!clone) return false;
+        dest->InsertTag(clone, pred);
+        pred = clone;
+    }
+    return true;
+}
+
+C4DAtom* BaseObject::GetClone(COPYFLAGS flags, AliasTrans* trn) {
+    BaseObject* clone = AllocSame();
+    if (!clone) return nullptr;
+    if (!CopyObjectTo(clone, flags, trn)) {
+        DeleteObj(clone);
+        return nullptr;
+    }
+
+    if (!(flags & COPYFLAGS_NO_HIERARCHY)) {
+        for (BaseObject* child = GetDown(); child; child = child->GetNext()) {
+            BaseObject* childClone = static_cast<BaseObject*>(child->GetClone(flags, trn));
+            if (!childClone) {
+                DeleteObj(clone);
+                return nullptr;
+            }
+            childClone->InsertUnderLast(clone);
+        }
+    }
+    return clone;
+}
+
+/**
+ * BaseSelect
+ */
+
+Int32 BaseSelect::GetCount() const {
+    Int32 count = 0;
+    for (const Range& range : m_ranges)
+        count += range.b - range.a + 1;
+    return count;
+}
+
+Bool BaseSelect::SelectAll(Int32 min, Int32 max) {
+    if (min < 0 || min > max) return false;
+
+    // Merge all ranges that overlap or touch the new one.
+    std::vector<Range> ranges;
+    Range added = {min, max};
+    for (const Range& range : m_ranges) {
+        if ((Int64) range.b + 1 < added.a || range.a > (Int64) added.b + 1)
+            ranges.push_back(range);
+        else {
+            added.a = Min(added.a, range.a);
+            added.b = Max(added.b, range.b);
+        }
+    }
+    auto pos = std::lower_bound(ranges.begin(), ranges.end(), added,
+        [](const Range& x, const Range& y) { return x.a < y.a; });
+    ranges.insert(pos, added);
+    m_ranges.swap(ranges);
+    return true;
+}
+
+Bool BaseSelect::Deselect(Int32 num) {
+    for (size_t i=0; i < m_ranges.size(); i++) {
+        Range range = m_ranges[i];
+        if (num < range.a || num > range.b) continue;
+        m_ranges.erase(m_ranges.begin() + i);
+        if (num < range.b) m_ranges.insert(m_ranges.begin() + i, Range{num + 1, range.b});
+        if (num > range.a) m_ranges.insert(m_ranges.begin() + i, Range{range.a, num - 1});
+        return true;
+    }
+    return false;
+}
+
+Bool BaseSelect::Toggle(Int32 num) {
+    return IsSelected(num) ? Deselect(num) : Select(num);
+}
+
+Bool BaseSelect::IsSelected(Int32 num) const {
+    for (const Range& range : m_ranges) {
+        if (num < range.a) return false;
+        if (num <= range.b) return true;
+    }
+    return false;
+}
+
+Bool BaseSelect::GetRange(Int32 seg, Int32 maxElements, Int32* a, Int32* b) const {
+    if (seg < 0 || seg >= (Int32) m_ranges.size() || m_ranges[seg].a >= maxElements)
+        return false;
+    *a = m_ranges[seg].a;
+    *b = Min(m_ranges[seg].b, maxElements - 1);
+    return true;
+}
+
+/**
+ * PointObject and PolygonObject
+ */
+
+Bool PointObject::ResizeObject(Int32 pcnt) {
+    if (pcnt < 0) return false;
+    try {
+        m_points.resize(pcnt);
+    }
+    catch (const std::bad_alloc&) {
+        return false;
+    }
+    return true;
+}
+
+Bool PointObject::CopyObjectTo(BaseObject* dest_, COPYFLAGS flags, AliasTrans* trn) {
+    PointObject* dest = static_cast<PointObject*>(dest_);
+    if (!BaseObject::CopyObjectTo(dest, flags, trn)) return false;
+    try {
+        dest->m_points = m_points;
+    }
+    catch (const std::bad_alloc&) {
+        return false;
+    }
+    return m_pointSelection.CopyTo(&dest->m_pointSelection);
+}
+
+PolygonObject* PolygonObject::Alloc(Int32 pcnt, Int32 vcnt) {
+    PolygonObject* op = NewObj(PolygonObject);
+    if (!op) return nullptr;
+    op->SetName("Polygon");
+    if (!op->ResizeObject(pcnt, vcnt)) {
+        DeleteObj(op);
+        return nullptr;
+    }
+    return op;
+}
+
+Bool PolygonObject::ResizeObject(Int32 pcnt, Int32 vcnt) {
+    if (pcnt < 0 || vcnt < 0) return false;
+    try {
+        m_points.resize(pcnt);
+        m_polygons.resize(vcnt);
+    }
+    catch (const std::bad_alloc&) {
+        return false;
+    }
+    return true;
+}
+
+BaseObject* PolygonObject::AllocSame() const {
+    return NewObj(PolygonObject);
+}
+
+Bool PolygonObject::CopyObjectTo(BaseObject* dest, COPYFLAGS flags, AliasTrans* trn) {
+    if (!PointObject::CopyObjectTo(dest, flags, trn)) return false;
+    try {
+        static_cast<PolygonObject*>(dest)->m_polygons = m_polygons;
+    }
+    catch (const std::bad_alloc&) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * CTrack
+ */
+
+CTrack* CTrack::Alloc(BaseList2D* bl, const DescID& id) {
+    // Tracks of plugins are identified by the plugin ID, all other
+    // tracks are value tracks.
+    Int32 type = CTbase;
+    if (id.GetDepth() > 0 && C4DHeadless_IsNodePlugin(id[0].id))
+        type = id[0].id;
+
+    CTrack* track = NewObj(CTrack, type, id);
+    if (track && type != CTbase && !track->InitNodeData(type))
+        DeleteObj(track);
+    return track;
+}
+
+void CTrack::Free(CTrack*& track) {
+    if (track) track->Remove();
+    DeleteObj(track);
+}
+
+BaseList2D* CTrack::GetObject() const {
+    return m_head ? static_cast<BaseList2D*>(m_head->owner) : nullptr;
+}
+
+C4DAtom* CTrack::GetClone(COPYFLAGS flags, AliasTrans* trn) {
+    CTrack* clone = NewObj(CTrack, GetType(), m_id);
+    if (clone && !CopyBaseTo(clone, flags, trn))
+        DeleteObj(clone);
+    return clone;
+}
+
+/**
+ * AtomArray and BaseLink
+ */
+
+Int32 AtomArray::Find(C4DAtom* obj) const {
+    auto it = std::find(m_atoms.begin(), m_atoms.end(), obj);
+    return it != m_atoms.end() ? (Int32) (it - m_atoms.begin()) : NOTOK;
+}
+
+Bool AtomArray::Remove(C4DAtom* obj) {
+    Int32 index = Find(obj);
+    if (index == NOTOK) return false;
+    m_atoms.erase(m_atoms.begin() + index);
+    return true;
+}
+
+BaseList2D* BaseLink::GetLink(const BaseDocument* doc, Int32 instanceof) const {
+    BaseList2D* node = m_serial ? C4DHeadless_FindNode(m_serial) : nullptr;
+    if (!node) return nullptr;
+    if (doc && node->GetDocument() != doc) return nullptr;
+    if (instanceof && !node->IsInstanceOf(instanceof)) return nullptr;
+    return node;
+}
+
+/**
+ * BaseDocument
+ */
+
+C4DAtom* BaseSceneHook::GetClone(COPYFLAGS flags, AliasTrans* trn) {
+    BaseSceneHook* clone = NewObj(BaseSceneHook, GetType());
+    if (clone && !CopyBaseTo(clone, flags, trn))
+        DeleteObj(clone);
+    return clone;
+}
+
+static std::vector<BaseDocument*> g_documents;
+static BaseDocument* g_activeDocument = nullptr;
+
+BaseDocument::BaseDocument()
+: BaseList2D(Tbasedocument), m_objects(this), m_hooks(this), m_undoDepth(0) { }
+
+BaseDocument::~BaseDocument() {
+    while (m_objects.first) {
+        GeListNode* op = m_objects.first;
+        op->Remove();
+        delete op;
+    }
+    while (m_hooks.first) {
+        GeListNode* hook = m_hooks.first;
+        hook->Remove();
+        delete hook;
+    }
+
+    auto it = std::find(g_documents.begin(), g_documents.end(), this);
+    if (it != g_documents.end()) g_documents.erase(it);
+    if (g_activeDocument == this)
+        g_activeDocument = g_documents.empty() ? nullptr : g_documents.front();
+}
+
+BaseDocument* BaseDocument::Alloc() {
+    BaseDocument* doc = NewObj(BaseDocument);
+    if (!doc) return nullptr;
+    doc->SetName("Untitled");
+    if (!doc->InitSceneHooks())
+        DeleteObj(doc);
+    return doc;
+}
+
+Bool BaseDocument::InitSceneHooks() {
+    BaseSceneHook* pred = nullptr;
+    for (Int32 id : C4DHeadless_GetSceneHooks()) {
+        BaseSceneHook* hook = NewObj(BaseSceneHook, id);
+        if (!hook) return false;
+        if (pred) hook->InsertAfter(pred);
+        else hook->InsertHead(&m_hooks);
+        pred = hook;
+        if (!hook->InitNodeData(id)) return false;
+    }
+    return true;
+}
+
+BaseSceneHook* BaseDocument::FindSceneHook(Int32 id) const {
+    auto hook = static_cast<BaseSceneHook*>(m_hooks.first);
+    for (; hook; hook = hook->GetNext()) {
+        if (hook->GetType() == id)
+            return hook;
+    }
+    return nullptr;
+}
+
+void BaseDocument::Free(BaseDocument*& doc) {
+    DeleteObj(doc);
+}
+
+void BaseDocument::InsertObject(BaseObject* op, BaseObject* parent, BaseObject* pred, Bool checknames) {
+    if (!op) return;
+    if (pred) op->InsertAfter(pred);
+    else if (parent) op->InsertUnder(parent);
+    else op->InsertHead(&m_objects);
+}
+
+/**
+ * Calls *fn* for *op*, its following objects and their children in
+ * hierarchy order. The children of an object are skipped if *fn*
+ * returns false for it.
+ */
+template <typename Fn>
+static void WalkObjects(BaseObject* op, Fn fn) {
+    for (; op; op = op->GetNext()) {
+        if (fn(op)) WalkObjects(op->GetDown(), fn);
+    }
+}
+
+BaseObject* BaseDocument::GetActiveObject() const {
+    BaseObject* active = nullptr;
+    Int32 count = 0;
+    WalkObjects(GetFirstObject(), [&](BaseObject* op) {
+        if (op->GetBit(BIT_ACTIVE)) {
+            active = op;
+            count++;
+        }
+        return true;
+    });
+    return count == 1 ? active : nullptr;
+}
+
+void BaseDocument::SetActiveObject(BaseObject* op, SELECTION mode) {
+    if (mode == SELECTION_NEW) {
+        WalkObjects(GetFirstObject(), [](BaseObject* node) {
+            node->DelBit(BIT_ACTIVE);
+            return true;
+        });
+    }
+    if (!op) return;
+    if (mode == SELECTION_SUB) op->DelBit(BIT_ACTIVE);
+    else op->SetBit(BIT_ACTIVE);
+}
+
+void BaseDocument::GetActiveObjects(AtomArray& selection, GETACTIVEOBJECTFLAGS flags) const {
+    selection.Flush();
+    WalkObjects(GetFirstObject(), [&](BaseObject* op) {
+        if (!op->GetBit(BIT_ACTIVE)) return true;
+        selection.Append(op);
+        return (flags & GETACTIVEOBJECTFLAGS_CHILDREN) != 0;
+    });
+}
+
+void BaseDocument::GetActiveTags(AtomArray& selection) const {
+    selection.Flush();
+    WalkObjects(GetFirstObject(), [&](BaseObject* op) {
+        for (BaseTag* tag = op->GetFirstTag(); tag; tag = tag->GetNext()) {
+            if (tag->GetBit(BIT_ACTIVE)) selection.Append(tag);
+        }
+        return true;
+    });
+}
+
+Bool BaseDocument::StartUndo() {
+    m_undoDepth++;
+    return true;
+}
+
+Bool BaseDocument::EndUndo() {
+    if (m_undoDepth <= 0) return false;
+    m_undoDepth--;
+    return true;
+}
+
+Bool BaseDocument::AddUndo(UNDOTYPE type, void* data) {
+    return m_undoDepth > 0 && data != nullptr;
+}
+
+static Bool AnimateTracks(BaseDocument* doc, BaseList2D* node) {
+    CAnimInfo info;
+    info.doc = doc;
+    info.op = node;
+    info.otime = doc->GetTime();
+    info.xtime = doc->GetTime().Get();
+    info.fac = 0.0;
+    info.rel = 0.0;
+
+    for (CTrack* track = node->GetFirstCTrack(); track; track = track->GetNext()) {
+        if (track->GetType() == CTbase || !track->GetNodeData()) continue;
+        Bool chg = false;
+        auto data = static_cast<CTrackData*>(track->GetNodeData());
+        if (!data->Animate(track, &info, &chg, nullptr))
+            return false;
+    }
+    return true;
+}
+
+Bool BaseDocument::ExecutePasses(void* bt, Bool animation, Bool expressions, Bool caches, BUILDFLAGS flags) {
+    if (!animation) return true;
+    Bool ok = AnimateTracks(this, this);
+    WalkObjects(GetFirstObject(), [&](BaseObject* op) {
+        ok = AnimateTracks(this, op) && ok;
+        for (BaseTag* tag = op->GetFirstTag(); tag; tag = tag->GetNext())
+            ok = AnimateTracks(this, tag) && ok;
+        return true;
+    });
+    return ok;
+}
+
+C4DAtom* BaseDocument::GetClone(COPYFLAGS flags, AliasTrans* trn) {
+    BaseDocument* clone = BaseDocument::Alloc();
+    if (!clone) return nullptr;
+    if (!CopyBaseTo(clone, flags, trn)) {
+        DeleteObj(clone);
+        return nullptr;
+    }
+    clone->m_time = m_time;
+
+    BaseObject* pred = nullptr;
+    for (BaseObject* op = GetFirstObject(); op; op = op->GetNext()) {
+        BaseObject* opClone = static_cast<BaseObject*>(op->GetClone(flags, trn));
+        if (!opClone) {
+            DeleteObj(clone);
+            return nullptr;
+        }
+        clone->InsertObject(opClone, nullptr, pred);
+        pred = opClone;
+    }
+    return clone;
+}
+
+BaseDocument* GetActiveDocument() {
+    return g_activeDocument;
+}
+
+void SetActiveDocument(BaseDocument* doc) {
+    if (doc && std::find(g_documents.begin(), g_documents.end(), doc) != g_documents.end())
+        g_activeDocument = doc;
+}
+
+void InsertBaseDocument(BaseDocument* doc) {
+    if (!doc || std::find(g_documents.begin(), g_documents.end(), doc) != g_documents.end())
+        return;
+    g_documents.push_back(doc);
+    if (!g_activeDocument) g_activeDocument = doc;
+}
+
+void C4DHeadless_FreeDocuments() {
+    while (!g_documents.empty()) {
+        BaseDocument* doc = g_documents.back();
+        BaseDocument::Free(doc);
+    }
+}
+
+/**
+ * Saving and loading
+ *
+ * The stand-in writes its own format: the name and parameters of
+ * the document, followed by the objects in hierarchy order. Every
+ * object and tag is preceded by true, the end of a list of tags or
+ * siblings is marked with false.
+ */
+
+static void SendDocumentInfo(BaseDocument* doc, Int32 type, const Filename& name) {
+    DocumentInfoData info;
+    info.type = type;
+    info.doc = doc;
+    info.filename = name;
+    for (Int32 id : C4DHeadless_GetSceneHooks()) {
+        BaseSceneHook* hook = doc->FindSceneHook(id);
+        if (hook) hook->Message(MSG_DOCUMENTINFO, &info);
+    }
+}
+
+static Bool WriteNode(HyperFile* hf, BaseList2D* node) {
+    // The container is written in place, a copy would drop the
+    // state that custom data does not copy (eg. Floatlist sidecars).
+    return hf->WriteInt32(node->GetType()) && hf->WriteString(node->GetName())
+        && hf->WriteContainer(*node->GetDataInstance());
+}
+
+static Bool ReadNode(HyperFile* hf, BaseList2D* node) {
+    String name;
+    if (!hf->ReadString(&name) || !hf->ReadContainer(node->GetDataInstance(), true))
+        return false;
+    node->SetName(name);
+    return true;
+}
+
+static Bool WriteObjects(HyperFile* hf, BaseObject* op) {
+    for (; op; op = op->GetNext()) {
+        Matrix ml = op->GetMl();
+        if (!hf->WriteBool(true) || !WriteNode(hf, op) || !hf->WriteVector(ml.off)
+                || !hf->WriteVector(ml.v1) || !hf->WriteVector(ml.v2) || !hf->WriteVector(ml.v3))
+            return false;
+        for (BaseTag* tag = op->GetFirstTag(); tag; tag = tag->GetNext()) {
+            if (!hf->WriteBool(true) || !WriteNode(hf, tag))
+                return false;
+        }
+        if (!hf->WriteBool(false) || !WriteObjects(hf, op->GetDown()))
+            return false;
+    }
+    return hf->WriteBool(false);
+}
+
+/**
+ * Reads the objects written by WriteObjects() under *parent*. The
+ * objects are inserted before they are read, so they are freed with
+ * the document if reading fails.
+ */
+static Bool ReadObjects(HyperFile* hf, BaseDocument* doc, BaseObject* parent) {
+    BaseObject* pred = nullptr;
+    for (;;) {
+        Bool more;
+        Int32 type;
+        if (!hf->ReadBool(&more)) return false;
+        if (!more) return true;
+        if (!hf->ReadInt32(&type)) return false;
+
+        BaseObject* op = BaseObject::Alloc(type);
+        if (!op) return false;
+        doc->InsertObject(op, parent, pred);
+        pred = op;
+
+        Matrix ml;
+        if (!ReadNode(hf, op) || !hf->ReadVector(&ml.off) || !hf->ReadVector(&ml.v1)
+                || !hf->ReadVector(&ml.v2) || !hf->ReadVector(&ml.v3))
+            return false;
+        op->SetMl(ml);
+
+        BaseTag* tagPred = nullptr;
+        for (;;) {
+            if (!hf->ReadBool(&more)) return false;
+            if (!more) break;
+            if (!hf->ReadInt32(&type)) return false;
+            BaseTag* tag = BaseTag::Alloc(type);
+            if (!tag) return false;
+            op->InsertTag(tag, tagPred);
+            tagPred = tag;
+            if (!ReadNode(hf, tag)) return false;
+        }
+
+        if (!ReadObjects(hf, doc, op)) return false;
+    }
+}
+
+Bool SaveDocument(BaseDocument* doc, const Filename& name, SAVEDOCUMENTFLAGS saveflags, Int32 format) {
+    if (!doc || format != FORMAT_C4DEXPORT) return false;
+
+    SendDocumentInfo(doc, MSG_DOCUMENTINFO_TYPE_SAVE_BEFORE, name);
+    HyperFile hf;
+    hf.SetDocument(doc);
+    Bool ok = hf.Open(FORMAT_C4DEXPORT, name, FILEOPEN_WRITE, FILEDIALOG_NONE)
+           && WriteNode(&hf, doc) && WriteObjects(&hf, doc->GetFirstObject());
+    ok = hf.Close() && ok;
+    SendDocumentInfo(doc, MSG_DOCUMENTINFO_TYPE_SAVE_AFTER, name);
+    return ok;
+}
+
+BaseDocument* LoadDocument(const Filename& name, SCENEFILTER loadflags, void* thread) {
+    BaseDocument* doc = BaseDocument::Alloc();
+    if (!doc) return nullptr;
+
+    HyperFile hf;
+    hf.SetDocument(doc);
+    Int32 type;
+    Bool ok = hf.Open(FORMAT_C4DEXPORT, name, FILEOPEN_READ, FILEDIALOG_NONE)
+           && hf.ReadInt32(&type) && type == Tbasedocument && ReadNode(&hf, doc)
+           && ReadObjects(&hf, doc, nullptr);
+    hf.Close();
+    if (!ok) {
+        BaseDocument::Free(doc);
+        return nullptr;
+    }
+    SendDocumentInfo(doc, MSG_DOCUMENTINFO_TYPE_LOAD, name);
+    return doc;
+}
+
+/**
+ * Modeling
+ */
+
+/**
+ * Creates a UV sphere with *sub* segments around and *sub* - 2
+ * rings between the poles, so 8 segments give 50 points.
+ */
+static PolygonObject* MakeSphere(Float radius, Int32 sub) {
+    sub = Max(sub, 3);
+    const Int32 rings = sub - 2;
+    const Int32 pcnt = sub * rings + 2;
+    const Int32 vcnt = sub * (rings + 1);
+    PolygonObject* op = PolygonObject::Alloc(pcnt, vcnt);
+    if (!op) return nullptr;
+
+    Vector* points = op->GetPointW();
+    CPolygon* polys = op->GetPolygonW();
+    const Int32 bottom = pcnt - 1;
+    points[0] = Vector(0.0, radius, 0.0);
+    points[bottom] = Vector(0.0, -radius, 0.0);
+    for (Int32 i=0; i < rings; i++) {
+        Float theta = PI * (i + 1) / (rings + 1);
+        for (Int32 j=0; j < sub; j++) {
+            Float phi = 2.0 * PI * j / sub;
+            points[1 + i * sub + j] = Vector(Sin(theta) * Cos(phi), Cos(theta), Sin(theta) * Sin(phi)) * radius;
+        }
+    }
+
+    auto ring = [sub](Int32 i, Int32 j) { return 1 + i * sub + j % sub; };
+    Int32 v = 0;
+    for (Int32 j=0; j < sub; j++)
+        polys[v++] = CPolygon(0, ring(0, j + 1), ring(0, j));
+    for (Int32 i=0; i + 1 < rings; i++) {
+        for (Int32 j=0; j < sub; j++)
+            polys[v++] = CPolygon(ring(i, j), ring(i, j + 1), ring(i + 1, j + 1), ring(i + 1, j));
+    }
+    for (Int32 j=0; j < sub; j++)
+        polys[v++] = CPolygon(bottom, ring(rings - 1, j), ring(rings - 1, j + 1));
+    return op;
+}
+
+Bool SendModelingCommand(Int32 command, ModelingCommandData& data) {
+    if (command != MCOMMAND_CURRENTSTATETOOBJECT || !data.op) return false;
+
+    BaseObject* result;
+    if (data.op->GetType() == Osphere) {
+        const BaseContainer* bc = data.op->GetDataInstance();
+        PolygonObject* sphere = MakeSphere(bc->GetFloat(PRIM_SPHERE_RAD, 100.0), bc->GetInt32(PRIM_SPHERE_SUB, 24));
+        if (!sphere) return false;
+        sphere->SetName(data.op->GetName());
+        sphere->SetMl(data.op->GetMl());
+        BaseTag* pred = nullptr;
+        for (BaseTag* tag = data.op->GetFirstTag(); tag; tag = tag->GetNext()) {
+            BaseTag* clone = static_cast<BaseTag*>(tag->GetClone(COPYFLAGS_0, nullptr));
+            if (!clone) continue;
+            sphere->InsertTag(clone, pred);
+            pred = clone;
+        }
+        result = sphere;
+    }
+    else
+        result = static_cast<BaseObject*>(data.op->GetClone(COPYFLAGS_0, nullptr));
+    if (!result) return false;
+
+    if (!data.result) data.result = AtomArray::Alloc();
+    if (!data.result) {
+        BaseObject::Free(result);
+        return false;
+    }
+    data.result->Append(result);
+    return true;
+}
+
+/**
+ * C4DThread
+ */
+
+Bool C4DThread::Start(THREADMODE mode, THREADPRIORITY priority) {
+    Wait(false);
+    m_break = false;
+    if (mode == THREADMODE_SYNCHRONOUS) {
+        Main();
+        return true;
+    }
+    try {
+        m_thread = new std::thread([this]() { Main(); });
+    }
+    catch (...) {
+        m_thread = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void C4DThread::End(Bool wait) {
+    m_break = true;
+    Wait(false);
+}
+
+void C4DThread::Wait(Bool checkevents) {
+    if (!m_thread) return;
+    m_thread->join();
+    delete m_thread;
+    m_thread = nullptr;
+}
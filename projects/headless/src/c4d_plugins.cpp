@@ -0,0 +1,432 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for the plugin registration,
+ *    commands, resources and the startup of the plugin
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <c4d.h>
+#include <c4d_headless.h>
+
+struct CUSTOMGUIPLUGIN {
+    Int32 id;
+    CustomGuiData* data;
+};
+
+namespace {
+
+    struct NodePlugin {
+        String name;
+        DataAllocator* alloc;
+        Int32 disklevel;
+        Bool scenehook;
+        Int32 priority;
+    };
+
+    struct DataTypePlugin {
+        CustomDataTypeClass* data;
+        Int32 disklevel;
+    };
+
+    /**
+     * All plugins are kept until Shutdown(). Commands, nodes and
+     * datatypes share one ID space like in Cinema, custom GUIs
+     * usually have the ID of their datatype and have their own.
+     */
+    std::set<Int32> g_ids;
+    std::map<Int32, CommandData*> g_commands;
+    std::map<Int32, NodePlugin> g_nodes;
+    std::map<Int32, DataTypePlugin> g_datatypes;
+    std::map<Int32, CUSTOMGUIPLUGIN*> g_guis;
+    std::map<Int32, C4DLibrary*> g_libraries;
+    Bool g_quit = false;
+
+}
+
+/**
+ * Claims *id* for the plugin *name*, fails if it is taken.
+ */
+static Bool ReserveId(Int32 id, const String& name) {
+    if (id <= 0 || !g_ids.insert(id).second) {
+        GePrint("Could not register '" + name + "': the plugin ID "
+                + String::IntToString(id) + " is already in use.");
+        return false;
+    }
+    return true;
+}
+
+Bool RegisterCommandPlugin(Int32 id, const String& str, Int32 info, BaseBitmap* icon,
+                           const String& help, CommandData* dat) {
+    if (!dat || !ReserveId(id, str)) return false;
+    g_commands[id] = dat;
+    return true;
+}
+
+static NodePlugin* RegisterNodePlugin(Int32 id, const String& str, DataAllocator* g, Int32 disklevel) {
+    if (!g || !ReserveId(id, str)) return nullptr;
+    NodePlugin& plugin = g_nodes[id];
+    plugin.name = str;
+    plugin.alloc = g;
+    plugin.disklevel = disklevel;
+    plugin.scenehook = false;
+    plugin.priority = 0;
+    return &plugin;
+}
+
+Bool RegisterCTrackPlugin(Int32 id, const String& str, Int32 info, DataAllocator* g,
+                          const String& description, Int32 disklevel) {
+    return RegisterNodePlugin(id, str, g, disklevel) != nullptr;
+}
+
+Bool RegisterSceneHookPlugin(Int32 id, const String& str, Int32 info, DataAllocator* g,
+                             Int32 priority, Int32 disklevel) {
+    NodePlugin* plugin = RegisterNodePlugin(id, str, g, disklevel);
+    if (!plugin) return false;
+    plugin->scenehook = true;
+    plugin->priority = priority;
+    return true;
+}
+
+Bool RegisterCustomDataTypePlugin(const String& str, Int32 info, CustomDataTypeClass* dat,
+                                  Int32 disklevel) {
+    if (!dat || !ReserveId(dat->GetId(), str)) return false;
+    DataTypePlugin& plugin = g_datatypes[dat->GetId()];
+    plugin.data = dat;
+    plugin.disklevel = disklevel;
+    return true;
+}
+
+Bool RegisterCustomGuiPlugin(const String& str, Int32 info, CustomGuiData* dat) {
+    if (!dat || g_guis.count(dat->GetId())) return false;
+    CUSTOMGUIPLUGIN* plugin = NewObj(CUSTOMGUIPLUGIN);
+    if (!plugin) return false;
+    plugin->id = dat->GetId();
+    plugin->data = dat;
+    dat->m_plugin = plugin;
+    g_guis[plugin->id] = plugin;
+    return true;
+}
+
+CustomDataTypeClass* FindCustomDataTypePlugin(Int32 type) {
+    auto it = g_datatypes.find(type);
+    return it != g_datatypes.end() ? it->second.data : nullptr;
+}
+
+Int32 C4DHeadless_GetDataTypeLevel(Int32 type) {
+    auto it = g_datatypes.find(type);
+    return it != g_datatypes.end() ? it->second.disklevel : 0;
+}
+
+CustomGuiData* FindCustomGuiPlugin(Int32 id) {
+    auto it = g_guis.find(id);
+    return it != g_guis.end() ? it->second->data : nullptr;
+}
+
+NodeData* C4DHeadless_AllocNodeData(Int32 id) {
+    auto it = g_nodes.find(id);
+    return it != g_nodes.end() ? it->second.alloc() : nullptr;
+}
+
+Bool C4DHeadless_IsNodePlugin(Int32 id) {
+    return g_nodes.count(id) != 0;
+}
+
+std::vector<Int32> C4DHeadless_GetSceneHooks() {
+    std::vector<Int32> ids;
+    for (auto& entry : g_nodes) {
+        if (entry.second.scenehook) ids.push_back(entry.first);
+    }
+    std::stable_sort(ids.begin(), ids.end(), [](Int32 a, Int32 b) {
+        return g_nodes[a].priority > g_nodes[b].priority;
+    });
+    return ids;
+}
+
+void FillBaseCustomGui(BaseCustomGuiLib& lib) {
+    lib.size = sizeof(lib);
+    lib.version = 1;
+    for (void*& fn : lib.fn) fn = nullptr;
+}
+
+Bool InstallLibrary(Int32 id, C4DLibrary* lib, Int32 version, Int32 size) {
+    if (!lib || g_libraries.count(id)) return false;
+    lib->version = version;
+    lib->size = size;
+    g_libraries[id] = lib;
+    return true;
+}
+
+/**
+ * Commands
+ */
+
+/**
+ * The commands of Cinema that the stand-in implements.
+ */
+static const Int32 IDM_QUIT = 12104;
+static const Int32 IDM_CONSOLE = 12305;
+
+void CallCommand(Int32 id, Int32 subid) {
+    if (id == IDM_QUIT) {
+        g_quit = true;
+        return;
+    }
+    if (id == IDM_CONSOLE)
+        return; // GePrint() always writes to stdout
+
+    auto it = g_commands.find(id);
+    if (it == g_commands.end()) {
+        GePrint("CallCommand: unknown command " + String::IntToString(id));
+        return;
+    }
+
+    BaseDocument* doc = GetActiveDocument();
+    if (!(it->second->GetState(doc) & CMD_ENABLED))
+        return;
+    if (subid != 0) it->second->ExecuteSubID(doc, subid);
+    else it->second->Execute(doc);
+}
+
+Bool IsCommandEnabled(Int32 id) {
+    auto it = g_commands.find(id);
+    return it != g_commands.end() && (it->second->GetState(GetActiveDocument()) & CMD_ENABLED);
+}
+
+/**
+ * Resources
+ */
+
+GeResource resource;
+
+static String Trim(const std::string& text) {
+    size_t a = text.find_first_not_of(" \t\r\n");
+    size_t b = text.find_last_not_of(" \t\r\n");
+    return a == std::string::npos ? String() : String(text.substr(a, b - a + 1).c_str());
+}
+
+/**
+ * Reads the IDs of the enum in `c4d_symbols.h`. Entries without a
+ * value continue from the previous one.
+ */
+static Bool ReadSymbols(const Filename& path, std::map<std::string, Int32>& symbols) {
+    std::ifstream file(path.GetString().GetUtf8().c_str());
+    if (!file) return false;
+
+    Bool inEnum = false;
+    Int32 next = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t comment = line.find("//");
+        if (comment != std::string::npos) line.erase(comment);
+        if (!inEnum) {
+            inEnum = line.find("enum") != std::string::npos;
+            continue;
+        }
+        if (line.find('}') != std::string::npos) break;
+
+        std::stringstream entries(line);
+        std::string entry;
+        while (std::getline(entries, entry, ',')) {
+            std::string name = Trim(entry).GetUtf8();
+            if (name.empty()) continue;
+            size_t eq = name.find('=');
+            if (eq != std::string::npos) {
+                next = (Int32) std::strtol(name.substr(eq + 1).c_str(), nullptr, 0);
+                name = Trim(name.substr(0, eq)).GetUtf8();
+            }
+            symbols[name] = next++;
+        }
+    }
+    return true;
+}
+
+/**
+ * Reads the `NAME "text";` lines of a string table.
+ */
+static Bool ReadStrings(const Filename& path, const std::map<std::string, Int32>& symbols,
+                        std::vector<std::pair<Int32, String>>& strings) {
+    std::ifstream file(path.GetString().GetUtf8().c_str());
+    if (!file) return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t quote = line.find('"');
+        if (quote == std::string::npos) continue;
+        auto symbol = symbols.find(Trim(line.substr(0, quote)).GetUtf8());
+        if (symbol == symbols.end()) continue;
+
+        std::string text;
+        for (size_t i=quote + 1; i < line.size() && line[i] != '"'; i++) {
+            if (line[i] == '\\' && i + 1 < line.size()) i++;
+            text += line[i];
+        }
+        strings.push_back(std::make_pair(symbol->second, String(text.c_str())));
+    }
+    return true;
+}
+
+Bool GeResource::Init() {
+    return Init(GeGetPluginPath() + Filename("res"));
+}
+
+Bool GeResource::Init(const Filename& path) {
+    std::map<std::string, Int32> symbols;
+    m_strings.clear();
+    if (!ReadSymbols(path + Filename("c4d_symbols.h"), symbols)) {
+        GePrint("Could not load the resource in " + path.GetString());
+        return false;
+    }
+    return ReadStrings(path + Filename("strings_us") + Filename("c4d_strings.str"), symbols, m_strings);
+}
+
+void GeResource::Free() {
+    m_strings.clear();
+}
+
+const String& GeResource::LoadString(Int32 id) const {
+    static const String empty;
+    for (const auto& entry : m_strings) {
+        if (entry.first == id) return entry.second;
+    }
+    return empty;
+}
+
+static String Substitute(Int32 id, const String* args, Int32 count) {
+    const std::string& text = resource.LoadString(id).GetUtf8();
+    std::string result;
+    Int32 arg = 0;
+    for (char c : text) {
+        if (c == '#' && arg < count) result += args[arg++].GetUtf8();
+        else result += c;
+    }
+    String str;
+    str.SetCString(result.data(), (Int) result.size());
+    return str;
+}
+
+String GeLoadString(Int32 id) {
+    return resource.LoadString(id);
+}
+
+String GeLoadString(Int32 id, const String& p1) {
+    return Substitute(id, &p1, 1);
+}
+
+String GeLoadString(Int32 id, const String& p1, const String& p2) {
+    String args[] = {p1, p2};
+    return Substitute(id, args, 2);
+}
+
+String GeLoadString(Int32 id, const String& p1, const String& p2, const String& p3) {
+    String args[] = {p1, p2, p3};
+    return Substitute(id, args, 3);
+}
+
+String GeLoadString(Int32 id, const String& p1, const String& p2, const String& p3,
+                    const String& p4) {
+    String args[] = {p1, p2, p3, p4};
+    return Substitute(id, args, 4);
+}
+
+/**
+ * Startup and shutdown
+ */
+
+/**
+ * Handles `-headless-points <count>`, which makes a polygon object
+ * with *count* random points the active object, and
+ * `-headless-ctrl`, which holds the Ctrl key for GetInputState().
+ */
+static void ParseHostArgs(C4DPL_CommandLineArgs* args, BaseDocument* doc) {
+    for (Int32 i=0; i < args->argc; i++) {
+        const char* arg = args->argv[i];
+        if (!arg) continue;
+        if (std::strcmp(arg, "-headless-ctrl") == 0)
+            headless::SetQualifiers(QCTRL);
+        else if (std::strcmp(arg, "-headless-points") == 0 && i + 1 < args->argc && args->argv[i + 1]) {
+            Int32 count = (Int32) std::atoi(args->argv[++i]);
+            PolygonObject* op = PolygonObject::Alloc(Max(count, 0), 0);
+            if (!op) {
+                GePrint("headless: could not allocate the points");
+                continue;
+            }
+            Random random;
+            random.Init(count);
+            Vector* points = op->GetPointW();
+            for (Int32 k=0; k < count; k++)
+                points[k] = Vector(random.Get11(), random.Get11(), random.Get11()) * 1000.0;
+            op->SetName("Points");
+            doc->InsertObject(op, nullptr, nullptr);
+            doc->SetActiveObject(op);
+        }
+    }
+}
+
+Bool headless::Startup(Int32 argc, char** argv) {
+    g_quit = false;
+    if (!PluginMessage(C4DPL_INIT_SYS, nullptr) || !PluginStart())
+        return false;
+
+    // The plugin sets the arguments it handles to nullptr.
+    std::vector<char*> argvCopy(argv, argv + argc);
+    C4DPL_CommandLineArgs args = {argc, argvCopy.data()};
+    PluginMessage(C4DPL_COMMANDLINEARGS, &args);
+
+    BaseDocument* doc = BaseDocument::Alloc();
+    if (!doc) return false;
+    InsertBaseDocument(doc);
+    SetActiveDocument(doc);
+    ParseHostArgs(&args, doc);
+
+    PluginMessage(C4DPL_PROGRAM_STARTED, nullptr);
+    return true;
+}
+
+void headless::Shutdown() {
+    PluginMessage(C4DPL_ENDACTIVITY, nullptr);
+
+    // The documents hold custom data, they go before the plugin
+    // frees what its datatypes share and before the datatypes.
+    C4DHeadless_FreeDocuments();
+    PluginEnd();
+    for (auto& entry : g_commands) delete entry.second;
+    for (auto& entry : g_datatypes) delete entry.second.data;
+    for (auto& entry : g_guis) {
+        delete entry.second->data;
+        delete entry.second;
+    }
+    g_commands.clear();
+    g_nodes.clear();
+    g_datatypes.clear();
+    g_guis.clear();
+    g_libraries.clear();
+    g_ids.clear();
+    resource.Free();
+}
+
+Bool headless::IsQuitRequested() {
+    return g_quit;
+}
@@ -0,0 +1,316 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for String, Filename and the file
+ *    system functions
+ */
+
+#include <cctype>
+#include <cinttypes>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <c4d.h>
+#include <c4d_headless.h>
+
+/**
+ * Returns true for the bytes that start a UTF-8 character.
+ */
+static inline Bool IsLead(Char c) {
+    return ((UChar) c & 0xC0) != 0x80;
+}
+
+/**
+ * Returns the byte offset of the character *pos* in *str*.
+ */
+static size_t ByteOffset(const std::string& str, Int pos) {
+    for (size_t i=0; i < str.size(); i++) {
+        if (IsLead(str[i]) && pos-- <= 0)
+            return i;
+    }
+    return str.size();
+}
+
+Int String::GetLength() const {
+    Int length = 0;
+    for (Char c : m_utf8) {
+        if (IsLead(c)) length++;
+    }
+    return length;
+}
+
+Int String::GetCString(Char* cstr, Int maxlen, STRINGENCODING type) const {
+    if (!cstr || maxlen <= 0) return 0;
+    Int count = Min<Int>((Int) m_utf8.size(), maxlen - 1);
+    CopyMem(m_utf8.data(), cstr, count);
+    cstr[count] = 0;
+    return count;
+}
+
+Char* String::GetCStringCopy(STRINGENCODING type) const {
+    Char* cstr = NewMem(Char, m_utf8.size() + 1);
+    if (cstr) GetCString(cstr, (Int) m_utf8.size() + 1, type);
+    return cstr;
+}
+
+Bool String::FindFirst(const String& str, Int* pos, Int start) const {
+    size_t found = m_utf8.find(str.m_utf8, ByteOffset(m_utf8, start));
+    if (found == std::string::npos) {
+        if (pos) *pos = -1;
+        return false;
+    }
+    if (pos) *pos = String(m_utf8.substr(0, found).c_str()).GetLength();
+    return true;
+}
+
+String String::SubStr(Int start, Int count) const {
+    size_t a = ByteOffset(m_utf8, start);
+    size_t b = ByteOffset(m_utf8, start + count);
+    return String(m_utf8.substr(a, b - a).c_str());
+}
+
+String String::ToUpper() const {
+    String result(*this);
+    for (Char& c : result.m_utf8) c = (Char) std::toupper((UChar) c);
+    return result;
+}
+
+String String::ToLower() const {
+    String result(*this);
+    for (Char& c : result.m_utf8) c = (Char) std::tolower((UChar) c);
+    return result;
+}
+
+Int32 String::ToInt32(Bool* error) const {
+    Char* end = nullptr;
+    long value = std::strtol(m_utf8.c_str(), &end, 10);
+    if (error) *error = m_utf8.empty() || *end != 0;
+    return (Int32) value;
+}
+
+Float String::ToFloat(Bool* error) const {
+    Char* end = nullptr;
+    Float value = std::strtod(m_utf8.c_str(), &end);
+    if (error) *error = m_utf8.empty() || *end != 0;
+    return value;
+}
+
+String String::IntToString(Int32 value) {
+    Char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%" PRId32, value);
+    return String(buffer);
+}
+
+String String::IntToString(Int64 value) {
+    Char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%" PRId64, value);
+    return String(buffer);
+}
+
+String String::UIntToString(UInt64 value) {
+    Char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%" PRIu64, value);
+    return String(buffer);
+}
+
+String String::FloatToString(Float value, Int32 vvk, Int32 nnk) {
+    Char buffer[512];
+    Int32 digits = nnk < 0 ? -nnk : nnk;
+    std::snprintf(buffer, sizeof(buffer), "%.*f", (int) digits, value);
+    String result(buffer);
+    if (nnk < 0 && result.m_utf8.find('.') != std::string::npos) {
+        // Remove the trailing zeros, and the point if nothing is left
+        // after it.
+        std::string& s = result.m_utf8;
+        while (!s.empty() && s.back() == '0') s.pop_back();
+        if (!s.empty() && s.back() == '.') s.pop_back();
+    }
+    if (vvk > 0) {
+        size_t point = result.m_utf8.find('.');
+        Int32 length = (Int32) (point == std::string::npos ? result.m_utf8.size() : point);
+        if (length < vvk) result.m_utf8.insert(0, (size_t) (vvk - length), '0');
+    }
+    return result;
+}
+
+String String::HexToString(UInt64 value, Bool prefix) {
+    Char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), prefix ? "0x%" PRIX64 : "%" PRIX64, value);
+    return String(buffer);
+}
+
+/**
+ * Filename
+ */
+
+static size_t LastSeparator(const std::string& path) {
+    return path.find_last_of('/');
+}
+
+Filename Filename::GetDirectory() const {
+    const std::string& path = m_path.GetUtf8();
+    size_t sep = LastSeparator(path);
+    if (sep == std::string::npos) return Filename();
+    return Filename(path.substr(0, sep == 0 ? 1 : sep).c_str());
+}
+
+Filename Filename::GetFile() const {
+    return Filename(GetFileString());
+}
+
+String Filename::GetFileString() const {
+    const std::string& path = m_path.GetUtf8();
+    size_t sep = LastSeparator(path);
+    return String(sep == std::string::npos ? path.c_str() : path.substr(sep + 1).c_str());
+}
+
+/**
+ * Returns the offset of the dot of the suffix in *path*, or npos.
+ */
+static size_t SuffixDot(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    size_t sep = LastSeparator(path);
+    if (dot == std::string::npos || (sep != std::string::npos && dot < sep) || dot == sep + 1)
+        return std::string::npos;
+    return dot;
+}
+
+String Filename::GetSuffix() const {
+    const std::string& path = m_path.GetUtf8();
+    size_t dot = SuffixDot(path);
+    return dot == std::string::npos ? String() : String(path.substr(dot + 1).c_str());
+}
+
+void Filename::ClearSuffix() {
+    const std::string& path = m_path.GetUtf8();
+    size_t dot = SuffixDot(path);
+    if (dot != std::string::npos)
+        m_path = String(path.substr(0, dot).c_str());
+}
+
+void Filename::SetSuffix(const String& suffix) {
+    ClearSuffix();
+    m_path += "." + suffix;
+}
+
+Bool Filename::CheckSuffix(const String& suffix) const {
+    return GetSuffix().ToLower() == suffix.ToLower();
+}
+
+Filename Filename::operator + (const Filename& other) const {
+    Filename result(*this);
+    result += other;
+    return result;
+}
+
+Filename& Filename::operator += (const Filename& other) {
+    if (!m_path.Content())
+        m_path = other.m_path;
+    else if (other.m_path.Content()) {
+        const std::string& path = m_path.GetUtf8();
+        if (path[path.size() - 1] != '/')
+            m_path += "/";
+        m_path += other.m_path;
+    }
+    return *this;
+}
+
+Bool Filename::operator == (const Filename& other) const {
+    return m_path == other.m_path && m_memoryWrite == other.m_memoryWrite
+        && m_memoryRead == other.m_memoryRead;
+}
+
+/**
+ * The console. Lines are printed to stdout, which can be turned off
+ * for tests that check the output.
+ */
+
+static GeSpinlock g_consoleLock;
+static Bool g_consoleEcho = true;
+static std::string g_consoleLast;
+
+void GePrint(const String& str) {
+    g_consoleLock.Lock();
+    if (g_consoleEcho) {
+        std::fputs(str.GetUtf8().c_str(), stdout);
+        std::fputc('\n', stdout);
+        std::fflush(stdout);
+    }
+    g_consoleLast = str.GetUtf8();
+    g_consoleLock.Unlock();
+}
+
+void headless::SetConsoleEcho(Bool echo) {
+    g_consoleLock.Lock();
+    g_consoleEcho = echo;
+    g_consoleLock.Unlock();
+}
+
+String headless::GetLastConsoleLine() {
+    g_consoleLock.Lock();
+    String line(g_consoleLast.c_str());
+    g_consoleLock.Unlock();
+    return line;
+}
+
+/**
+ * The file system
+ */
+
+Bool GeFExist(const Filename& name, Bool isdir) {
+    struct stat st;
+    if (stat(name.GetString().GetUtf8().c_str(), &st) != 0)
+        return false;
+    return isdir ? S_ISDIR(st.st_mode) : S_ISREG(st.st_mode);
+}
+
+Bool GeFKill(const Filename& name, Int32 flags) {
+    return std::remove(name.GetString().GetUtf8().c_str()) == 0;
+}
+
+Bool GeFCreateDir(const Filename& name) {
+    return mkdir(name.GetString().GetUtf8().c_str(), 0777) == 0 || GeFExist(name, true);
+}
+
+static Filename GetEnvironmentPath(const Char* variable, const Char* preset) {
+    const Char* value = std::getenv(variable);
+    if (value && *value)
+        return Filename(value);
+    if (preset && *preset)
+        return Filename(preset);
+    Char cwd[4096];
+    if (getcwd(cwd, sizeof(cwd)))
+        return Filename(cwd);
+    return Filename(".");
+}
+
+Filename GeGetStartupWritePath() {
+    return GetEnvironmentPath("C4D_HEADLESS_USER", nullptr);
+}
+
+// The Makefile passes the root of the repository.
+#ifndef C4D_HEADLESS_PLUGIN_DIR
+    #define C4D_HEADLESS_PLUGIN_DIR ""
+#endif
+
+Filename GeGetPluginPath() {
+    return GetEnvironmentPath("C4D_HEADLESS_PLUGIN", C4D_HEADLESS_PLUGIN_DIR);
+}
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: headless stand-in for memory, math, debugging and
+ *    threading functions
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <c4d.h>
+
+void* C4DHeadless_Alloc(Int size, Bool clear) {
+    if (size < 0) return nullptr;
+    // malloc(0) may return nullptr, which would look like a memory
+    // error to the caller.
+    if (size == 0) size = 1;
+    return clear ? std::calloc(1, (size_t) size) : std::malloc((size_t) size);
+}
+
+void C4DHeadless_DebugStop(const Char* file, Int32 line) {
+    std::fprintf(stderr, "DebugStop: %s:%d\n", file, (int) line);
+}
+
+Matrix operator ~ (const Matrix& m) {
+    // The inverse of the 3x3 part by its adjugate, then the inverse
+    // translation.
+    const Vector& a = m.v1;
+    const Vector& b = m.v2;
+    const Vector& c = m.v3;
+    Float det = a.x * (b.y * c.z - b.z * c.y) - b.x * (a.y * c.z - a.z * c.y)
+              + c.x * (a.y * b.z - a.z * b.y);
+    if (det == 0.0)
+        return Matrix();
+    Float inv = 1.0 / det;
+
+    Matrix r;
+    r.v1 = Vector(b.y * c.z - c.y * b.z, c.y * a.z - a.y * c.z, a.y * b.z - b.y * a.z) * inv;
+    r.v2 = Vector(c.x * b.z - b.x * c.z, a.x * c.z - c.x * a.z, b.x * a.z - a.x * b.z) * inv;
+    r.v3 = Vector(b.x * c.y - c.x * b.y, c.x * a.y - a.x * c.y, a.x * b.y - b.x * a.y) * inv;
+    r.off = Vector();
+    r.off = -(r * m.off);
+    return r;
+}
+
+UInt GeGetCurrentThreadId() {
+    return (UInt) std::hash<std::thread::id>()(std::this_thread::get_id());
+}
+
+Int32 GeGetCurrentThreadCount() {
+    Int32 count = (Int32) std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+static const std::chrono::steady_clock::time_point g_start = std::chrono::steady_clock::now();
+
+Float64 GeGetMilliSeconds() {
+    auto elapsed = std::chrono::steady_clock::now() - g_start;
+    return std::chrono::duration<Float64, std::milli>(elapsed).count();
+}
+
+Int32 GeGetTimer() {
+    return (Int32) GeGetMilliSeconds();
+}
@@ -5,6 +5,14 @@ enum {
     // This text is used by Custom GUIs to tell the user that
     // multiple values are being input and can not be displayed.
     IDS_MULTIPLEVALUES = 10000,
+
+    // Displayed by the Floatlist GUI when an item is added with
+    // a name that is already used by another item.
+    IDS_FLOATLIST_DUPLICATENAME,
+
+    // Displayed by the Floatlist GUI next to the scroll slider when
+    // the list has more items than rows, eg. "Items 1-16 of 5000".
+    IDS_FLOATLIST_RANGE,
 };
 
 #endif /* C4D_SYMBOLS_H */
\ No newline at end of file
@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: reads and writes many Floatlist values of a node at once
+ * level: expert
+ * tags: description, message
+ * read-before: floatlist.cpp
+ */
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist-batch.h>
+
+Bool FloatlistBatch::Execute(FloatlistData& list, FloatlistBatchMsg& msg) {
+    Bool result = false;
+    switch (msg.mode) {
+        case FloatlistBatchMsg::MODE_GET:
+            if (msg.indices != nullptr)
+                result = list.GetValues(msg.indices, msg.count, msg.values);
+            else
+                result = list.GetValues(msg.first, msg.count, msg.values);
+            break;
+
+        case FloatlistBatchMsg::MODE_SET:
+            if (msg.indices != nullptr)
+                result = list.SetValues(msg.indices, msg.count, msg.values);
+            else
+                result = list.SetValues(msg.first, msg.count, msg.values);
+            break;
+
+        case FloatlistBatchMsg::MODE_APPLY: {
+            if (msg.fn == nullptr)
+                break;
+            auto fn = msg.fn;
+            void* userdata = msg.userdata;
+            result = list.Apply([fn, userdata](Float value) { return fn(value, userdata); });
+            break;
+        }
+    }
+
+    msg.handled = true;
+    msg.result = result;
+    return result;
+}
+
+Bool FloatlistBatch::Dispatch(BaseList2D* node, FloatlistBatchMsg& msg) {
+    if (node == nullptr)
+        return false;
+
+    node->Message(MSG_FLOATLIST_BATCH, &msg);
+    if (msg.handled)
+        return msg.result;
+
+    // The node does not know about the message, so we go through
+    // the parameter once. The copy we get shares the items with
+    // the node, reading the values does not copy them.
+    GeData data;
+    if (!node->GetParameter(msg.id, data, DESCFLAGS_GET_0))
+        return false;
+    const FloatlistData* list = FloatlistData::Get(data);
+    if (list == nullptr)
+        return false;
+
+    FloatlistData copy(*list);
+    if (!Execute(copy, msg))
+        return false;
+    if (msg.mode == FloatlistBatchMsg::MODE_GET)
+        return true;
+    return node->SetParameter(msg.id, GeData(CUSTOMDATATYPE_FLOATLIST, copy), DESCFLAGS_SET_0);
+}
+
+Bool FloatlistBatch::Get(BaseList2D* node, const DescID& id, Int32 first, Int32 count,
+                         Float* out)
+{
+    FloatlistBatchMsg msg;
+    msg.mode = FloatlistBatchMsg::MODE_GET;
+    msg.id = id;
+    msg.first = first;
+    msg.count = count;
+    msg.values = out;
+    return Dispatch(node, msg);
+}
+
+Bool FloatlistBatch::Get(BaseList2D* node, const DescID& id, const Int32* indices,
+                         Int32 count, Float* out)
+{
+    FloatlistBatchMsg msg;
+    msg.mode = FloatlistBatchMsg::MODE_GET;
+    msg.id = id;
+    msg.indices = indices;
+    msg.count = count;
+    msg.values = out;
+    return Dispatch(node, msg);
+}
+
+Bool FloatlistBatch::Set(BaseList2D* node, const DescID& id, Int32 first, Int32 count,
+                         const Float* values)
+{
+    FloatlistBatchMsg msg;
+    msg.mode = FloatlistBatchMsg::MODE_SET;
+    msg.id = id;
+    msg.first = first;
+    msg.count = count;
+    msg.values = const_cast<Float*>(values);
+    return Dispatch(node, msg);
+}
+
+Bool FloatlistBatch::Set(BaseList2D* node, const DescID& id, const Int32* indices,
+                         Int32 count, const Float* values)
+{
+    FloatlistBatchMsg msg;
+    msg.mode = FloatlistBatchMsg::MODE_SET;
+    msg.id = id;
+    msg.indices = indices;
+    msg.count = count;
+    msg.values = const_cast<Float*>(values);
+    return Dispatch(node, msg);
+}
+
+Bool FloatlistBatch::Apply(BaseList2D* node, const DescID& id, Float (*fn)(Float, void*),
+                           void* userdata)
+{
+    FloatlistBatchMsg msg;
+    msg.mode = FloatlistBatchMsg::MODE_APPLY;
+    msg.id = id;
+    msg.fn = fn;
+    msg.userdata = userdata;
+    return Dispatch(node, msg);
+}
@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CINEMA4DSDK_DATATYPE_FLOATLIST_BATCH_H
+#define CINEMA4DSDK_DATATYPE_FLOATLIST_BATCH_H
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist.h>
+
+/**
+ * Message that can be sent to a node to read or write many values
+ * of one of its Floatlist parameters at once. The data is a pointer
+ * to a FloatlistBatchMsg. Nodes that store their lists themselves
+ * can handle it with FloatlistBatch::Execute(). The ID is registered
+ * at the plugincafe like a plugin ID, so that no other message of
+ * Cinema or a plugin uses the same number.
+ */
+static const Int32 MSG_FLOATLIST_BATCH = 1031956;
+
+struct FloatlistBatchMsg {
+
+    enum Mode {
+        MODE_GET,
+        MODE_SET,
+        MODE_APPLY,
+    };
+
+    Mode mode;
+
+    /**
+     * The ID of the Floatlist parameter.
+     */
+    DescID id;
+
+    /**
+     * The items to read or write, either *count* items from *first*
+     * on or, if *indices* is not nullptr, the *count* items at the
+     * specified indices.
+     */
+    Int32 first;
+    Int32 count;
+    const Int32* indices;
+
+    /**
+     * The values that are read (MODE_GET) or written (MODE_SET),
+     * one per item.
+     */
+    Float* values;
+
+    /**
+     * The function that is applied to every value with MODE_APPLY.
+     */
+    Float (*fn)(Float value, void* userdata);
+    void* userdata;
+
+    /**
+     * Must be set by the node if it handled the message, *result*
+     * is returned to the sender then.
+     */
+    Bool handled;
+    Bool result;
+
+    FloatlistBatchMsg()
+    : mode(MODE_GET), id(), first(0), count(0), indices(nullptr), values(nullptr),
+      fn(nullptr), userdata(nullptr), handled(false), result(false) { }
+
+};
+
+/**
+ * Reads and writes many values of the Floatlist parameter of a node
+ * with a single parameter access instead of one GetParameter() or
+ * SetParameter() call per subchannel. Each call first sends
+ * MSG_FLOATLIST_BATCH to the node and, if the node does not handle
+ * it, gets the whole list with one GetParameter() call and writes it
+ * back with one SetParameter() call.
+ */
+class FloatlistBatch {
+
+public:
+
+    static Bool Get(BaseList2D* node, const DescID& id, Int32 first, Int32 count, Float* out);
+
+    static Bool Get(BaseList2D* node, const DescID& id, const Int32* indices, Int32 count,
+                    Float* out);
+
+    static Bool Set(BaseList2D* node, const DescID& id, Int32 first, Int32 count,
+                    const Float* values);
+
+    static Bool Set(BaseList2D* node, const DescID& id, const Int32* indices, Int32 count,
+                    const Float* values);
+
+    static Bool Apply(BaseList2D* node, const DescID& id, Float (*fn)(Float, void*),
+                      void* userdata);
+
+    /**
+     * Performs the request of *msg* on *list*. Call this from the
+     * Message() method of a node that handles MSG_FLOATLIST_BATCH,
+     * it sets the *handled* and *result* fields.
+     */
+    static Bool Execute(FloatlistData& list, FloatlistBatchMsg& msg);
+
+private:
+
+    static Bool Dispatch(BaseList2D* node, FloatlistBatchMsg& msg);
+
+};
+
+#endif /* CINEMA4DSDK_DATATYPE_FLOATLIST_BATCH_H */
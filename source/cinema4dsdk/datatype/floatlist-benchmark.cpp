@@ -0,0 +1,469 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: A command that times the hot paths of the Floatlist
+ *    datatype for a range of list sizes and writes the results as
+ *    JSON and CSV.
+ * tags: command benchmark
+ * level: expert
+ * read-before: floatlist.cpp, floatlist-kernels.cpp
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist.h>
+#include <cinema4dsdk/datatype/floatlist-kernels.h>
+
+extern void Report_FloatlistInstrumentation(Bool reset); // floatlist-instrumentation.cpp
+
+/**
+ * Plugin ID of the benchmark command, registered separately from
+ * the datatype as plugin IDs are unique across all plugin types.
+ */
+static const Int32 ID_FLOATLISTBENCHMARK = 1031958;
+
+/**
+ * The list sizes that are measured unless others are passed with
+ * `-floatlist-benchmark-sizes`, see ParseFloatlistBenchmarkArgs().
+ */
+static const Int32 DEFAULT_SIZES[] = { 10, 100, 1000, 10000, 100000, 1000000 };
+
+/**
+ * Every measurement is run once cold, right after the list was
+ * created, and WARM_RUNS times afterwards. The median of the warm
+ * runs is reported. A run repeats the operation until about
+ * RUN_ITEMS items were processed, so that small lists are not
+ * measured below the resolution of the timer.
+ */
+static const Int32 WARM_RUNS = 5;
+static const Int32 RUN_ITEMS = 1000000;
+
+/**
+ * The settings from the command line. The directory is kept as a
+ * C string, a global Filename would be constructed before the API
+ * is available.
+ */
+static maxon::BaseArray<Int32> g_sizes;
+static Char* g_outputDir = nullptr;
+
+/**
+ * The names of the items. Short names look like those written by
+ * hand, long names like generated paths. The names of a run are
+ * released when it is done, so their IDs are re-used by the next
+ * size and set and the table only ever holds the names of one run.
+ */
+
+struct NameSet {
+    const Char* label;
+    const Char* prefix;
+};
+
+static const NameSet NAME_SETS[] = {
+    { "short", "w" },
+    { "long", "character_rig/left_arm/blendshape_weights/corrective_" },
+};
+
+/**
+ * The reference implementations for the kernels, the same loops
+ * the kernels run for the items that do not fill a vector.
+ */
+static void LoopAffine(Float* dst, const Float* a, Float scale, Float offset, Int count) {
+    for (Int i=0; i < count; i++)
+        dst[i] = a[i] * scale + offset;
+}
+
+static void LoopLerp(Float* dst, const Float* a, const Float* b, Float t, Int count) {
+    for (Int i=0; i < count; i++)
+        dst[i] = a[i] + (b[i] - a[i]) * t;
+}
+
+static Float LoopSum(const Float* a, Int count) {
+    Float sum = 0.0;
+    for (Int i=0; i < count; i++)
+        sum += a[i];
+    return sum;
+}
+
+class FloatlistBenchmarkCommand : public CommandData {
+
+public:
+
+    //| CommandData Overrides
+
+    virtual Bool Execute(BaseDocument* doc);
+
+private:
+
+    struct Result {
+        String operation;
+        String names;
+        Int32 size;
+        Int32 repeat;
+        Float64 cold;
+        Float64 warm;
+    };
+
+    maxon::BaseArray<Result> m_results;
+
+    /**
+     * Keeps the compiler from removing the reductions.
+     */
+    Float m_sink;
+
+    /**
+     * Runs `fn()` *repeat* times per run and stores the time per
+     * operation in milliseconds, where one call of *fn* performs
+     * *ops* operations. *fn* returns false on failure, which ends
+     * the measurement.
+     */
+    template <typename Fn>
+    Bool Measure(const String& operation, const String& names, Int32 size, Int32 repeat,
+                 Int32 ops, Fn fn);
+
+    Bool RunKernels(Int32 size);
+    Bool RunDatatype(CustomDataTypeClass* type, Int32 size, const NameSet& names);
+
+    Bool WriteResults(const Filename& json, const Filename& csv) const;
+
+};
+
+template <typename Fn>
+Bool FloatlistBenchmarkCommand::Measure(const String& operation, const String& names,
+                                        Int32 size, Int32 repeat, Int32 ops, Fn fn)
+{
+    Float64 times[WARM_RUNS + 1];
+    for (Int32 run=0; run <= WARM_RUNS; run++) {
+        Float64 start = GeGetMilliSeconds();
+        for (Int32 r=0; r < repeat; r++) {
+            if (!fn())
+                return false;
+        }
+        times[run] = (GeGetMilliSeconds() - start) / ((Float64) repeat * ops);
+    }
+
+    // Sort the warm runs to pick the median, there are only a few.
+    for (Int32 i=2; i <= WARM_RUNS; i++) {
+        for (Int32 j=i; j > 1 && times[j] < times[j - 1]; j--) {
+            Float64 temp = times[j];
+            times[j] = times[j - 1];
+            times[j - 1] = temp;
+        }
+    }
+
+    Result result;
+    result.operation = operation;
+    result.names = names;
+    result.size = size;
+    result.repeat = repeat * ops;
+    result.cold = times[0];
+    result.warm = times[1 + WARM_RUNS / 2];
+    if (!m_results.Append(result))
+        return false;
+
+    GePrint("  " + operation + " [" + String::IntToString(size) + ", " + names + "]: cold "
+            + String::FloatToString(result.cold) + " ms, warm " + String::FloatToString(result.warm)
+            + " ms");
+    return true;
+}
+
+Bool FloatlistBenchmarkCommand::RunKernels(Int32 size) {
+    maxon::BaseArray<Float> a, b, dst;
+    if (!a.Resize(size) || !b.Resize(size) || !dst.Resize(size))
+        return false; // memory error
+
+    Random random;
+    random.Init((UInt32) size);
+    for (Int32 i=0; i < size; i++) {
+        a[i] = random.Get01();
+        b[i] = random.Get01();
+    }
+
+    const Float* pa = a.GetFirst();
+    const Float* pb = b.GetFirst();
+    Float* pd = dst.GetFirst();
+    Int32 repeat = Max<Int32>(RUN_ITEMS / size, 1);
+    String none("-");
+
+    return Measure("Loop.Affine", none, size, repeat, 1, [&]() -> Bool {
+               LoopAffine(pd, pa, 0.5, 0.25, size); return true; })
+        && Measure("Kernel.Affine", none, size, repeat, 1, [&]() -> Bool {
+               FloatlistKernels::Affine(pd, pa, 0.5, 0.25, size); return true; })
+        && Measure("Loop.Lerp", none, size, repeat, 1, [&]() -> Bool {
+               LoopLerp(pd, pa, pb, 0.3, size); return true; })
+        && Measure("Kernel.Lerp", none, size, repeat, 1, [&]() -> Bool {
+               FloatlistKernels::Lerp(pd, pa, pb, 0.3, size); return true; })
+        && Measure("Loop.Sum", none, size, repeat, 1, [&]() -> Bool {
+               m_sink += LoopSum(pa, size); return true; })
+        && Measure("Kernel.Sum", none, size, repeat, 1, [&]() -> Bool {
+               m_sink += FloatlistKernels::Sum(pa, size); return true; });
+}
+
+Bool FloatlistBenchmarkCommand::RunDatatype(CustomDataTypeClass* type, Int32 size,
+                                            const NameSet& names)
+{
+    maxon::BaseArray<Int32> ids;
+    maxon::BaseArray<Float> values;
+    if (!ids.Resize(size) || !values.Resize(size))
+        return false; // memory error
+
+    String prefix(names.prefix);
+    for (Int32 i=0; i < size; i++) {
+        ids[i] = FloatlistSymbols::Intern(prefix + String::IntToString(i));
+        if (ids[i] == NOTOK) {
+            FloatlistSymbols::Release(ids.GetFirst(), i);
+            return false;
+        }
+        values[i] = (Float) (i % 1000) / 1000.0;
+    }
+
+    // *list* and *equal* have the same content but do not share
+    // it, so Compare() has to look at the items. The lists take
+    // their own references to the names.
+    FloatlistData list, equal, target;
+    Bool assigned = list.Assign(ids.GetFirst(), values.GetFirst(), size)
+        && equal.Assign(ids.GetFirst(), values.GetFirst(), size);
+    FloatlistSymbols::Release(ids.GetFirst(), size);
+    if (!assigned)
+        return false;
+
+    String label(names.label);
+    Int32 repeat = Max<Int32>(RUN_ITEMS / size, 1);
+
+    Bool ok = Measure("CopyData", label, size, RUN_ITEMS, 1, [&]() -> Bool {
+            return type->CopyData(&list, &target, nullptr); })
+        && Measure("CopyData+Modify", label, size, repeat, 1, [&]() -> Bool {
+            return type->CopyData(&list, &target, nullptr) && target.SetValue(0, 1.0); })
+        && Measure("Compare", label, size, repeat, 1, [&]() -> Bool {
+            return type->Compare(&list, &equal) == 0; });
+    if (!ok) return false;
+
+    // Each item is read and written through its subchannel, the
+    // time is reported per call.
+    ok = Measure("GetParameter", label, size, 1, size, [&]() -> Bool {
+            GeData data;
+            for (Int32 i=0; i < size; i++) {
+                DESCFLAGS_GET flags = DESCFLAGS_GET_0;
+                if (!type->GetParameter(&list, DescID(1000 + i), data, flags))
+                    return false;
+            }
+            return true; })
+        && Measure("SetDParameter", label, size, 1, size, [&]() -> Bool {
+            GeData data(0.5);
+            for (Int32 i=0; i < size; i++) {
+                DESCFLAGS_SET flags = DESCFLAGS_SET_0;
+                if (!type->SetDParameter(&target, DescID(1000 + i), data, flags))
+                    return false;
+            }
+            return true; })
+        && Measure("GetDescription", label, size, Max<Int32>(repeat / 100, 1), 1,
+                   [&]() -> Bool {
+            AutoAlloc<Description> desc;
+            if (!desc) return false;
+            BaseContainer parent;
+            DESCFLAGS_DESC flags = DESCFLAGS_DESC_0;
+            return type->_GetDescription(&list, *desc, flags, parent, nullptr); });
+    if (!ok) return false;
+
+    // The file round trip goes through a memory file, so that the
+    // numbers do not depend on the disk. Reading includes decoding,
+    // which is otherwise deferred to the first access.
+    void* block = nullptr;
+    Int blockSize = 0;
+    GeData source(CUSTOMDATATYPE_FLOATLIST, list);
+    ok = Measure("WriteData", label, size, repeat, 1, [&]() -> Bool {
+            AutoAlloc<MemoryFileStruct> memory;
+            AutoAlloc<HyperFile> hf;
+            if (!memory || !hf) return false;
+            Filename fn;
+            fn.SetMemoryWriteMode(memory);
+            if (!hf->Open(0, fn, FILEOPEN_WRITE, FILEDIALOG_NONE) || !hf->WriteGeData(source))
+                return false;
+            hf->Close();
+            DeleteMem(block);
+            memory->GetData(block, blockSize, true);
+            return block != nullptr; })
+        && Measure("ReadData", label, size, repeat, 1, [&]() -> Bool {
+            AutoAlloc<HyperFile> hf;
+            if (!hf) return false;
+            Filename fn;
+            fn.SetMemoryReadMode(block, blockSize);
+            GeData data;
+            if (!hf->Open(0, fn, FILEOPEN_READ, FILEDIALOG_NONE) || !hf->ReadGeData(&data))
+                return false;
+            hf->Close();
+            const FloatlistData* read = FloatlistData::Get(data);
+            return read != nullptr && read->GetCount() == size; });
+    DeleteMem(block);
+    return ok;
+}
+
+Bool FloatlistBenchmarkCommand::Execute(BaseDocument* doc) {
+    CustomDataTypeClass* type = FindCustomDataTypePlugin(CUSTOMDATATYPE_FLOATLIST);
+    if (!type) return false;
+
+    m_results.Flush();
+    m_sink = 0.0;
+
+    if (g_sizes.GetCount() == 0) {
+        for (Int32 i=0; i < (Int32) (sizeof(DEFAULT_SIZES) / sizeof(DEFAULT_SIZES[0])); i++) {
+            if (!g_sizes.Append(DEFAULT_SIZES[i]))
+                return false; // memory error
+        }
+    }
+
+    GePrint("Floatlist benchmark (" + String(FloatlistKernels::GetInstructionSet()) + ")");
+    for (Int32 i=0; i < g_sizes.GetCount(); i++) {
+        if (!RunKernels(g_sizes[i]))
+            return false;
+        for (Int32 j=0; j < (Int32) (sizeof(NAME_SETS) / sizeof(NAME_SETS[0])); j++) {
+            if (!RunDatatype(type, g_sizes[i], NAME_SETS[j])) {
+                GePrint("Floatlist benchmark: failed at " + String::IntToString(g_sizes[i]) + " items");
+                return false;
+            }
+        }
+    }
+
+    Filename dir = g_outputDir ? Filename(String(g_outputDir)) : GeGetStartupWritePath();
+    Filename json = dir + Filename("floatlist-benchmark.json");
+    Filename csv = dir + Filename("floatlist-benchmark.csv");
+    if (!WriteResults(json, csv)) {
+        GePrint("Floatlist benchmark: could not write " + json.GetString());
+        return false;
+    }
+    GePrint("Floatlist benchmark: results written to " + json.GetString());
+
+    // With FLOATLIST_INSTRUMENTATION, the counters show what the
+    // measured calls did inside.
+    Report_FloatlistInstrumentation(true);
+    return true;
+}
+
+static Bool WriteString(BaseFile* file, const String& str) {
+    Char* cstr = str.GetCStringCopy(STRINGENCODING_UTF8);
+    if (!cstr) return false;
+    Bool ok = file->WriteBytes(cstr, strlen(cstr));
+    DeleteMem(cstr);
+    return ok;
+}
+
+Bool FloatlistBenchmarkCommand::WriteResults(const Filename& json, const Filename& csv) const {
+    AutoAlloc<BaseFile> jsonFile;
+    AutoAlloc<BaseFile> csvFile;
+    if (!jsonFile || !csvFile)
+        return false;
+    if (!jsonFile->Open(json, FILEOPEN_WRITE, FILEDIALOG_NONE)
+            || !csvFile->Open(csv, FILEOPEN_WRITE, FILEDIALOG_NONE))
+        return false;
+
+    Bool ok = WriteString(jsonFile, "{\n  \"instructionSet\": \""
+                          + String(FloatlistKernels::GetInstructionSet()) + "\",\n  \"results\": [\n")
+           && WriteString(csvFile, "operation,size,names,repeat,cold_ms,warm_ms\n");
+
+    for (Int32 i=0; ok && i < m_results.GetCount(); i++) {
+        const Result& r = m_results[i];
+        String size = String::IntToString(r.size);
+        String repeat = String::IntToString(r.repeat);
+        String cold = String::FloatToString(r.cold);
+        String warm = String::FloatToString(r.warm);
+        ok = WriteString(jsonFile, "    {\"operation\": \"" + r.operation + "\", \"size\": " + size
+                         + ", \"names\": \"" + r.names + "\", \"repeat\": " + repeat
+                         + ", \"coldMs\": " + cold + ", \"warmMs\": " + warm + "}"
+                         + (i + 1 < m_results.GetCount() ? ",\n" : "\n"))
+          && WriteString(csvFile, r.operation + "," + size + "," + r.names + "," + repeat + ","
+                         + cold + "," + warm + "\n");
+    }
+
+    ok = ok && WriteString(jsonFile, "  ]\n}\n");
+    ok = jsonFile->Close() && ok;
+    ok = csvFile->Close() && ok;
+    return ok;
+}
+
+/**
+ * Called from PluginMessage() with the command line arguments.
+ * `-floatlist-benchmark-sizes 10,1000` sets the list sizes and
+ * `-floatlist-benchmark-out <dir>` the directory that the results
+ * are written to, the user folder of Cinema by default.
+ */
+void ParseFloatlistBenchmarkArgs(C4DPL_CommandLineArgs* args) {
+    for (Int32 i=0; i + 1 < args->argc; i++) {
+        const char* arg = args->argv[i];
+        const char* value = args->argv[i + 1];
+        if (!arg || !value) continue;
+
+        if (strcmp(arg, "-floatlist-benchmark-sizes") == 0) {
+            g_sizes.Flush();
+            for (const char* p = value; *p; ) {
+                Int32 size = (Int32) atoi(p);
+                if (size > 0 && !g_sizes.Append(size))
+                    break; // memory error
+                while (*p && *p != ',') p++;
+                if (*p == ',') p++;
+            }
+        }
+        else if (strcmp(arg, "-floatlist-benchmark-out") == 0) {
+            DeleteMem(g_outputDir);
+            Int length = strlen(value);
+            g_outputDir = NewMem(Char, length + 1);
+            if (g_outputDir)
+                CopyMem(value, g_outputDir, length + 1);
+        }
+        else continue;
+
+        args->argv[i] = nullptr;
+        args->argv[++i] = nullptr;
+    }
+}
+
+/**
+ * Called from Register_Datatype_Floatlist().
+ */
+Bool Register_FloatlistBenchmark() {
+    CommandData* plugin_command = NewObj(FloatlistBenchmarkCommand);
+    if (!plugin_command) return false; // memory error
+
+    return RegisterCommandPlugin(
+            ID_FLOATLISTBENCHMARK,
+            "datatype/Floatlist Benchmark",
+            0,
+            nullptr,
+            "Times the Floatlist datatype and writes the results as JSON and CSV.",
+            plugin_command);
+}
+
+/**
+ * Runs the benchmark without going through the command, called by
+ * the standalone benchmark program of the headless build
+ * (`projects/headless/src/benchmark.cpp`).
+ */
+Bool Run_FloatlistBenchmark(BaseDocument* doc) {
+    FloatlistBenchmarkCommand command;
+    return command.Execute(doc);
+}
+
+/**
+ * Called from Free_Datatype_Floatlist().
+ */
+void Free_FloatlistBenchmark() {
+    g_sizes.Flush();
+    DeleteMem(g_outputDir);
+}
@@ -0,0 +1,415 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: compact encodings for the values of the Floatlist datatype
+ * level: expert
+ * read-before: floatlist.cpp
+ */
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist.h>
+#include <cinema4dsdk/datatype/floatlist-codec.h>
+#include <cinema4dsdk/datatype/floatlist-symbols.h>
+
+/**
+ * The delta encodings write a stream of zigzag encoded varints.
+ * A zero token is followed by the number of consecutive zero
+ * deltas, which makes constant runs (and linear ramps for the
+ * quantized encoding) only a few bytes long.
+ */
+
+static UInt64 ZigZag(Int64 value) {
+    return ((UInt64) value << 1) ^ (UInt64) (value >> 63);
+}
+
+static Int64 UnZigZag(UInt64 value) {
+    return (Int64) (value >> 1) ^ -(Int64) (value & 1);
+}
+
+static UInt64 FloatBits(Float value) {
+    UInt64 bits;
+    CopyMem(&value, &bits, sizeof(bits));
+    return bits;
+}
+
+static Float BitsFloat(UInt64 bits) {
+    Float value;
+    CopyMem(&bits, &value, sizeof(value));
+    return value;
+}
+
+struct ByteWriter {
+
+    maxon::BaseArray<UChar>& out;
+    Bool ok;
+
+    ByteWriter(maxon::BaseArray<UChar>& out_) : out(out_), ok(true) { }
+
+    void Byte(UChar byte) {
+        if (ok && out.Append(byte) == nullptr)
+            ok = false;
+    }
+
+    void Varint(UInt64 value) {
+        while (value >= 0x80) {
+            Byte((UChar) (value | 0x80));
+            value >>= 7;
+        }
+        Byte((UChar) value);
+    }
+
+    void Raw(UInt64 bits) {
+        for (Int32 i=0; i < 8; i++)
+            Byte((UChar) (bits >> (i * 8)));
+    }
+
+};
+
+struct ByteReader {
+
+    const UChar* ptr;
+    const UChar* end;
+    Bool ok;
+
+    ByteReader(const UChar* data, Int size) : ptr(data), end(data + size), ok(true) { }
+
+    UInt64 Varint() {
+        UInt64 value = 0;
+        for (Int32 shift=0; shift < 64; shift += 7) {
+            if (ptr >= end) break;
+            UChar byte = *ptr++;
+            value |= (UInt64) (byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    UInt64 Raw() {
+        if (end - ptr < 8) {
+            ok = false;
+            return 0;
+        }
+        UInt64 bits = 0;
+        for (Int32 i=0; i < 8; i++)
+            bits |= (UInt64) *ptr++ << (i * 8);
+        return bits;
+    }
+
+};
+
+struct DeltaWriter {
+
+    ByteWriter& writer;
+    UInt64 zeros;
+
+    DeltaWriter(ByteWriter& writer_) : writer(writer_), zeros(0) { }
+
+    void Put(Int64 delta) {
+        if (delta == 0) {
+            zeros++;
+            return;
+        }
+        Flush();
+        writer.Varint(ZigZag(delta));
+    }
+
+    void Flush() {
+        if (zeros > 0) {
+            writer.Varint(0);
+            writer.Varint(zeros);
+            zeros = 0;
+        }
+    }
+
+};
+
+struct DeltaReader {
+
+    ByteReader& reader;
+    UInt64 zeros;
+
+    DeltaReader(ByteReader& reader_) : reader(reader_), zeros(0) { }
+
+    Int64 Next() {
+        if (zeros > 0) {
+            zeros--;
+            return 0;
+        }
+        UInt64 token = reader.Varint();
+        if (token != 0)
+            return UnZigZag(token);
+
+        zeros = reader.Varint();
+        if (zeros == 0) {
+            reader.ok = false;
+            return 0;
+        }
+        zeros--;
+        return 0;
+    }
+
+};
+
+/**
+ * The step of the quantization grid. Rounding to the nearest grid
+ * point is off by at most half a step, TOLERANCE / 2, which leaves
+ * room for the rounding of the division and multiplication so that
+ * the error stays below the tolerance of FloatlistDataType::Compare().
+ */
+static Float QuantizationStep() {
+    return FloatlistData::TOLERANCE;
+}
+
+/**
+ * The grid of the first version of the quantized encoding, whose
+ * error could reach the tolerance. Streams without the
+ * QUANTIZED_MARKER are decoded with it.
+ */
+static Float LegacyQuantizationStep() {
+    return FloatlistData::TOLERANCE * 2.0;
+}
+
+/**
+ * Quantized values must fit into 52 bits so that the second order
+ * deltas can not overflow an Int64.
+ */
+static const Int64 QUANTIZED_LIMIT = (Int64) 1 << 52;
+
+/**
+ * Starts the quantized streams that use QuantizationStep(). A zero
+ * token followed by a run of zero zeros is invalid in a delta
+ * stream, so older streams never start with it.
+ */
+static const UChar QUANTIZED_MARKER[2] = { 0, 0 };
+
+static Bool CanQuantize(const Float* values, Int32 count) {
+    const Float limit = (Float) QUANTIZED_LIMIT;
+    Float step = QuantizationStep();
+    for (Int32 i=0; i < count; i++) {
+        Float q = values[i] / step;
+        if (!(q > -limit && q < limit))
+            return false;
+    }
+    return true;
+}
+
+Int32 FloatlistCodec::Encode(const Float* values, Int32 count, Int32 encoding,
+                             maxon::BaseArray<UChar>& out)
+{
+    out.Flush();
+    if (encoding == FLOATLIST_ENCODING_QUANTIZED && !CanQuantize(values, count))
+        encoding = FLOATLIST_ENCODING_DELTA;
+
+    ByteWriter writer(out);
+    switch (encoding) {
+        case FLOATLIST_ENCODING_DELTA: {
+            // Differences of the bit patterns. Neighbouring values of
+            // a smooth curve share sign, exponent and the high bits of
+            // the mantissa so the differences are small.
+            DeltaWriter deltas(writer);
+            UInt64 prev = 0;
+            for (Int32 i=0; i < count; i++) {
+                UInt64 bits = FloatBits(values[i]);
+                deltas.Put((Int64) (bits - prev));
+                prev = bits;
+            }
+            deltas.Flush();
+            break;
+        }
+
+        case FLOATLIST_ENCODING_RLE: {
+            // Pairs of run length and value.
+            Int32 i = 0;
+            while (i < count) {
+                UInt64 bits = FloatBits(values[i]);
+                Int32 run = 1;
+                while (i + run < count && FloatBits(values[i + run]) == bits)
+                    run++;
+                writer.Varint(run);
+                writer.Raw(bits);
+                i += run;
+            }
+            break;
+        }
+
+        case FLOATLIST_ENCODING_QUANTIZED: {
+            // Second order differences of the values rounded to the
+            // quantization grid. Constant values and linear ramps
+            // both produce runs of zeros.
+            writer.Byte(QUANTIZED_MARKER[0]);
+            writer.Byte(QUANTIZED_MARKER[1]);
+            DeltaWriter deltas(writer);
+            Float step = QuantizationStep();
+            Int64 prev = 0;
+            Int64 prevDelta = 0;
+            for (Int32 i=0; i < count; i++) {
+                Int64 q = (Int64) Floor(values[i] / step + 0.5);
+                Int64 delta = q - prev;
+                deltas.Put(delta - prevDelta);
+                prev = q;
+                prevDelta = delta;
+            }
+            deltas.Flush();
+            break;
+        }
+
+        default:
+            encoding = FLOATLIST_ENCODING_RAW;
+            for (Int32 i=0; i < count; i++)
+                writer.Raw(FloatBits(values[i]));
+            break;
+    }
+
+    // Values that do not compress (noise, all distinct values for
+    // RLE) can take more room than the raw column, store that instead.
+    if (writer.ok && encoding != FLOATLIST_ENCODING_RAW
+            && (Int) out.GetCount() >= (Int) count * (Int) sizeof(Float))
+        return Encode(values, count, FLOATLIST_ENCODING_RAW, out);
+
+    return writer.ok ? encoding : NOTOK;
+}
+
+Bool FloatlistCodec::Decode(const UChar* data, Int size, Int32 encoding,
+                            Float* values, Int32 count)
+{
+    ByteReader reader(data, size);
+    switch (encoding) {
+        case FLOATLIST_ENCODING_RAW:
+            // Written directly from the value column.
+            if (size != count * (Int) sizeof(Float))
+                return false;
+            CopyMem(data, values, size);
+            break;
+
+        case FLOATLIST_ENCODING_DELTA: {
+            DeltaReader deltas(reader);
+            UInt64 bits = 0;
+            for (Int32 i=0; i < count && reader.ok; i++) {
+                bits += (UInt64) deltas.Next();
+                values[i] = BitsFloat(bits);
+            }
+            break;
+        }
+
+        case FLOATLIST_ENCODING_RLE: {
+            Int32 i = 0;
+            while (i < count && reader.ok) {
+                UInt64 run = reader.Varint();
+                Float value = BitsFloat(reader.Raw());
+                if (run == 0 || run > (UInt64) (count - i)) {
+                    reader.ok = false;
+                    break;
+                }
+                for (UInt64 j=0; j < run; j++)
+                    values[i++] = value;
+            }
+            break;
+        }
+
+        case FLOATLIST_ENCODING_QUANTIZED: {
+            Float step = LegacyQuantizationStep();
+            if (size >= 2 && data[0] == QUANTIZED_MARKER[0] && data[1] == QUANTIZED_MARKER[1]) {
+                reader.ptr += 2;
+                step = QuantizationStep();
+            }
+
+            // The sums are computed without sign, so that corrupt
+            // data can not overflow them. The encoder never writes
+            // grid points outside of QUANTIZED_LIMIT, which catches
+            // most corrupt deltas.
+            DeltaReader deltas(reader);
+            UInt64 q = 0;
+            UInt64 delta = 0;
+            for (Int32 i=0; i < count && reader.ok; i++) {
+                delta += (UInt64) deltas.Next();
+                q += delta;
+                Int64 point = (Int64) q;
+                if (point <= -QUANTIZED_LIMIT || point >= QUANTIZED_LIMIT) {
+                    reader.ok = false;
+                    break;
+                }
+                values[i] = (Float) point * step;
+            }
+            break;
+        }
+
+        default:
+            return false;
+    }
+
+    return reader.ok;
+}
+
+Bool FloatlistCodec::EncodeNames(const Int32* ids, Int32 count, maxon::BaseArray<Char>& out) {
+    out.Flush();
+
+    // Each name is stored as its length in bytes followed by the
+    // UTF-8 characters without a terminating null byte.
+    // The symbol table keeps the UTF-8 bytes of every name, so
+    // they are copied without converting the Strings.
+    Int size = 0;
+    for (Int32 index=0; index < count; index++)
+        size += sizeof(Int32) + FloatlistSymbols::GetUtf8(ids[index]).length;
+
+    if (!out.Resize(size))
+        return false;
+
+    Char* ptr = out.GetFirst();
+    for (Int32 index=0; index < count; index++) {
+        FloatlistSymbols::Utf8 name = FloatlistSymbols::GetUtf8(ids[index]);
+        CopyMem(&name.length, ptr, sizeof(Int32));
+        ptr += sizeof(Int32);
+        if (name.length > 0)
+            CopyMem(name.bytes, ptr, name.length);
+        ptr += name.length;
+    }
+    return true;
+}
+
+Bool FloatlistCodec::DecodeNames(const Char* data, Int size, Int32* ids, Int32 count) {
+    maxon::BaseArray<FloatlistSymbols::Utf8> names;
+    if (!names.Resize(count))
+        return false;
+
+    // We check the lengths against the size of the block as the
+    // file might be corrupt.
+    const Char* ptr = data;
+    const Char* end = data + size;
+    for (Int32 index=0; index < count; index++) {
+        Int32 length;
+        if (end - ptr < (Int) sizeof(Int32))
+            return false;
+        CopyMem(ptr, &length, sizeof(Int32));
+        ptr += sizeof(Int32);
+        if (length < 0 || end - ptr < length)
+            return false;
+
+        names[index].bytes = ptr;
+        names[index].length = length;
+        ptr += length;
+    }
+
+    // All names are interned under a single lock, which matters
+    // when many lists are loaded from multiple threads.
+    return FloatlistSymbols::Intern(names.GetFirst(), count, ids);
+}
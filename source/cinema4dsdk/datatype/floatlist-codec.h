@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CINEMA4DSDK_DATATYPE_FLOATLIST_CODEC_H
+#define CINEMA4DSDK_DATATYPE_FLOATLIST_CODEC_H
+
+#include <c4d.h>
+
+/**
+ * Encodes and decodes the columns of a Floatlist for writing
+ * them to a HyperFile. See FLOATLIST_ENCODING in floatlist.h for
+ * the available encodings of the values.
+ */
+class FloatlistCodec {
+
+public:
+
+    /**
+     * Encodes *count* values with the specified encoding and
+     * stores the result in *out*. Returns the encoding that was
+     * actually used, which can differ from the requested one if
+     * the values can not be represented with it (eg. NaN values
+     * can not be quantized) or if the encoded values would not be
+     * smaller than FLOATLIST_ENCODING_RAW, or NOTOK on a memory
+     * error.
+     */
+    static Int32 Encode(const Float* values, Int32 count, Int32 encoding,
+                        maxon::BaseArray<UChar>& out);
+
+    /**
+     * Decodes *count* values that were encoded with *encoding*
+     * from *size* bytes at *data* into *values*. Returns false if
+     * the data is corrupt or the encoding is unknown.
+     */
+    static Bool Decode(const UChar* data, Int size, Int32 encoding,
+                       Float* values, Int32 count);
+
+    /**
+     * Stores the names of *count* name IDs as length-prefixed UTF-8
+     * strings in *out*. Returns false on a memory error.
+     */
+    static Bool EncodeNames(const Int32* ids, Int32 count, maxon::BaseArray<Char>& out);
+
+    /**
+     * Interns *count* names from a block that was created with
+     * EncodeNames() and stores their IDs in *ids*, each with a
+     * reference that the caller has to release. Returns false if
+     * the block is corrupt, the name table is full or on a memory
+     * error, no references are taken then.
+     */
+    static Bool DecodeNames(const Char* data, Int size, Int32* ids, Int32 count);
+
+};
+
+#endif /* CINEMA4DSDK_DATATYPE_FLOATLIST_CODEC_H */
@@ -0,0 +1,732 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: implements the non-inline methods of the FloatlistData
+ * level: expert
+ * read-before: floatlist.cpp
+ */
+
+#include <algorithm>
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist.h>
+#include <cinema4dsdk/datatype/floatlist-codec.h>
+#include <cinema4dsdk/datatype/floatlist-instrumentation.h>
+#include <cinema4dsdk/datatype/floatlist-kernels.h>
+#include <cinema4dsdk/datatype/floatlist-pool.h>
+
+const Float FloatlistData::TOLERANCE = 0.00001;
+
+/**
+ * Returns the cell of the TOLERANCE grid that *value* falls into.
+ * NaN stays NaN.
+ */
+static Float Quantize(Float value) {
+    return Floor(value / FloatlistData::TOLERANCE + 0.5);
+}
+
+Int32 FloatlistData::CompareValues(Float a, Float b) {
+    Float qa = Quantize(a);
+    Float qb = Quantize(b);
+    if (qa == qb)
+        return 0;
+    if (qb != qb)
+        return qa != qa ? 0 : -1;
+    if (qa != qa)
+        return 1;
+    return qa < qb ? -1 : 1;
+}
+
+UInt64 FloatlistData::ItemHash(Int32 index, Int32 id, Float value) {
+    // The hash uses the cell of CompareValues(), so items that are
+    // equal for Compare() have the same hash. Cells out of the range
+    // of an Int64 are hashed by their bits instead, all NaNs alike.
+    Float q = Quantize(value);
+    Int64 bucket;
+    if (q > -9.0e18 && q < 9.0e18)
+        bucket = (Int64) q;
+    else if (q != q)
+        bucket = LIMIT<Int64>::MIN;
+    else {
+        Float64 bits = (Float64) q;
+        CopyMem(&bits, &bucket, sizeof(bucket));
+    }
+
+    UInt64 h = (UInt64) (UInt32) index * 0x9E3779B97F4A7C15ull;
+    h ^= (UInt64) (UInt32) id * 0xC2B2AE3D27D4EB4Full;
+    h ^= (UInt64) bucket * 0x165667B19E3779F9ull;
+
+    // Finalizer of MurmurHash3 so that the sum of the item hashes
+    // does not cancel out for similar items.
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+Bool FloatlistData::Payload::CopyFrom(const Payload& other) {
+    hash = other.hash.load();
+    hashDirty = other.hashDirty.load();
+    if (!ids.CopyFrom(other.ids))
+        return false;
+    FloatlistSymbols::Retain(ids.GetFirst(), (Int32) ids.GetCount());
+    if (!slots.CopyFrom(other.slots))
+        return false;
+    if (other.sidecar == nullptr)
+        return values.CopyFrom(other.values);
+
+    // The copy does not map the sidecar, as its values can be
+    // changed independently of the original.
+    Int32 count = other.GetCount();
+    if (!values.Resize(count))
+        return false;
+    if (count > 0)
+        CopyMem(other.sidecar->GetValues(), values.GetFirst(), count * sizeof(Float));
+    return true;
+}
+
+Bool FloatlistData::Payload::Unmap() {
+    if (sidecar == nullptr)
+        return true;
+    Int32 count = GetCount();
+    if (!values.Resize(count))
+        return false;
+    if (count > 0)
+        CopyMem(sidecar->GetValues(), values.GetFirst(), count * sizeof(Float));
+    FloatlistSidecar::Free(sidecar);
+    return true;
+}
+
+UInt64 FloatlistData::Payload::GetHash() {
+    if (hashDirty) {
+        // The payload can be shared between threads here, but all
+        // of them compute the same value so it does not matter who
+        // stores it first.
+        UInt64 sum = 0;
+        Int32 count = GetCount();
+        for (Int32 index=0; index < count; index++)
+            sum += ItemHash(index);
+        hash = sum;
+        hashDirty = false;
+    }
+    return hash + (UInt64) GetCount();
+}
+
+Bool FloatlistData::Payload::IndexReserve(Int32 count) {
+    Int32 size = (Int32) slots.GetCount();
+    if (size > 0 ? count * 2 <= size : count <= SMALL_LIST)
+        return true;
+
+    Int32 newSize = size > 0 ? size : 16;
+    while (newSize < count * 2)
+        newSize *= 2;
+    if (!slots.Resize(newSize))
+        return false;
+
+    // The mask changed, all items must be placed again.
+    IndexRebuild();
+    return true;
+}
+
+void FloatlistData::Payload::IndexInsert(Int32 index) {
+    nameOrderValid = false;
+    if (slots.GetCount() == 0)
+        return;
+    Int32 mask = (Int32) slots.GetCount() - 1;
+    Int32 i = HashId(ids[index]) & mask;
+    while (slots[i] != 0)
+        i = (i + 1) & mask;
+    slots[i] = index + 1;
+}
+
+void FloatlistData::Payload::IndexRemove(Int32 index) {
+    nameOrderValid = false;
+    if (slots.GetCount() == 0)
+        return;
+    Int32 mask = (Int32) slots.GetCount() - 1;
+    Int32 i = HashId(ids[index]) & mask;
+    while (slots[i] != index + 1) {
+        DebugAssert(slots[i] != 0);
+        i = (i + 1) & mask;
+    }
+
+    // Shift the following entries of the probe sequence back
+    // into the gap unless they are already in their home slot
+    // range, so that no tombstones are required.
+    Int32 j = i;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (slots[j] == 0)
+            break;
+        Int32 home = HashId(ids[slots[j] - 1]) & mask;
+        Bool inRange = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (inRange)
+            continue;
+        slots[i] = slots[j];
+        i = j;
+    }
+    slots[i] = 0;
+}
+
+void FloatlistData::Payload::IndexRebuild() {
+    nameOrderValid = false;
+    Int32 size = (Int32) slots.GetCount();
+    for (Int32 i=0; i < size; i++)
+        slots[i] = 0;
+    Int32 count = GetCount();
+    for (Int32 index=0; index < count; index++)
+        IndexInsert(index);
+}
+
+Int32 FloatlistData::Payload::FindNameId(Int32 id) const {
+    Int32 size = (Int32) slots.GetCount();
+    if (size == 0) {
+        // Small lists have no index, a scan over a few IDs is
+        // faster than hashing anyway.
+        Int32 count = GetCount();
+        for (Int32 index=0; index < count; index++) {
+            if (ids[index] == id)
+                return index;
+        }
+        return NOTOK;
+    }
+
+    // Walk the whole probe sequence so that the lowest index
+    // is returned if there are multiple items with the name.
+    Int32 mask = size - 1;
+    Int32 result = NOTOK;
+    for (Int32 i = HashId(id) & mask; slots[i] != 0; i = (i + 1) & mask) {
+        Int32 index = slots[i] - 1;
+        if (ids[index] == id && (result == NOTOK || index < result))
+            result = index;
+    }
+    return result;
+}
+
+const Int32* FloatlistData::Payload::GetOrder(Bool byName) {
+    std::atomic<Bool>& valid = byName ? nameOrderValid : valueOrderValid;
+    maxon::BaseArray<Int32>& order = byName ? nameOrder : valueOrder;
+    if (valid)
+        return order.GetFirst();
+
+    // Like the pending blocks, a shared payload can be asked for
+    // the order from multiple threads.
+    orderLock.Lock();
+    Bool success = true;
+    if (!valid) {
+        Int32 count = GetCount();
+        success = order.Resize(count);
+        if (success && count > 0) {
+            Int32* first = order.GetFirst();
+            for (Int32 i=0; i < count; i++)
+                first[i] = i;
+
+            // Sorting by (key, index) gives a strict order, so the
+            // result does not depend on the sort algorithm.
+            if (byName) {
+                const Int32* keys = ids.GetFirst();
+                std::sort(first, first + count, [keys](Int32 a, Int32 b) {
+                    return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+                });
+            }
+            else {
+                // NaN is not ordered with anything, it is sorted
+                // behind all other values instead.
+                const Float* keys = Values();
+                auto less = [](Float a, Float b) { return a < b || (b != b && a == a); };
+                std::sort(first, first + count, [keys, less](Int32 a, Int32 b) {
+                    return less(keys[a], keys[b]) || (!less(keys[b], keys[a]) && a < b);
+                });
+            }
+        }
+        valid = success;
+    }
+    orderLock.Unlock();
+    return success ? order.GetFirst() : nullptr;
+}
+
+Bool FloatlistData::Payload::Materialize() {
+    if (!pending)
+        return true;
+
+    FLOATLIST_PROBE_SCOPE(FLOATLIST_PROBE_MATERIALIZE);
+    pendingLock.Lock();
+    Bool success = true;
+    if (pending) {
+        Int32 count = pendingCount;
+        success = values.Resize(count)
+            && FloatlistCodec::Decode(static_cast<const UChar*>(pendingValues),
+                    pendingValuesSize, pendingEncoding, values.GetFirst(), count);
+
+        if (!success) {
+            GePrint("Floatlist: could not decode " + String::IntToString(count) + " items");
+            FloatlistSymbols::Release(ids.GetFirst(), (Int32) ids.GetCount());
+            values.Flush();
+            ids.Flush();
+            slots.Flush();
+            pendingCount = 0;
+        }
+
+        DeleteMem(pendingValues);
+        hashDirty = true;
+        nameOrderValid = false;
+        pending = false;
+    }
+    pendingLock.Unlock();
+    return success;
+}
+
+FloatlistData* FloatlistData::Alloc() {
+    return FloatlistPool::Acquire();
+}
+
+void FloatlistData::Free(FloatlistData* ptr) {
+    if (ptr == nullptr)
+        DebugStop();
+    FloatlistPool::Recycle(ptr);
+}
+
+void FloatlistData::Release() {
+    if (payload != nullptr && --payload->refs == 0)
+        DeleteObj(payload);
+    payload = nullptr;
+}
+
+Bool FloatlistData::Detach() {
+    if (payload == nullptr) {
+        payload = NewObj(Payload);
+        return payload != nullptr;
+    }
+
+    // Data that is still encoded is decoded first, even if the
+    // payload is not shared, as we can only modify the columns.
+    // Every modification detaches first, so this is where the
+    // value order is invalidated.
+    Touch();
+    if (payload->refs == 1) {
+        payload->valueOrderValid = false;
+        return true;
+    }
+
+    // The payload is shared with at least one other list, we
+    // need our own copy before we can modify it.
+    FLOATLIST_PROBE_SCOPE(FLOATLIST_PROBE_DETACH);
+    FLOATLIST_PROBE_BYTES(payload->GetCount() * (sizeof(Float) + sizeof(Int32)));
+    Payload* copy = NewObj(Payload);
+    if (copy == nullptr)
+        return false;
+    if (!copy->CopyFrom(*payload)) {
+        DeleteObj(copy);
+        return false;
+    }
+
+    Release();
+    payload = copy;
+    return true;
+}
+
+Bool FloatlistData::Append(const String& name, Float value) {
+    Int32 id = FloatlistSymbols::Intern(name);
+    if (id == NOTOK)
+        return false;
+
+    // AppendId() takes its own reference.
+    Bool success = AppendId(id, value);
+    FloatlistSymbols::Release(id);
+    return success;
+}
+
+Bool FloatlistData::AppendId(Int32 id, Float value) {
+    if (!Detach() || !payload->Unmap())
+        return false;
+
+    Int32 count = payload->GetCount();
+    if (!payload->IndexReserve(count + 1))
+        return false;
+    if (!payload->values.Append(value))
+        return false;
+    if (!payload->ids.Append(id)) {
+        payload->values.Pop();
+        return false;
+    }
+    FloatlistSymbols::Retain(id);
+    payload->IndexInsert(count);
+    payload->HashAdd(count);
+    return true;
+}
+
+Bool FloatlistData::Assign(const Int32* ids, const Float* values, Int32 count) {
+    Release();
+    if (count <= 0)
+        return true;
+    if (!Detach())
+        return false;
+
+    if (!payload->values.Resize(count) || !payload->ids.Resize(count)) {
+        Release();
+        return false;
+    }
+    CopyMem(values, payload->values.GetFirst(), count * sizeof(Float));
+    CopyMem(ids, payload->ids.GetFirst(), count * sizeof(Int32));
+    FloatlistSymbols::Retain(ids, count);
+
+    // The payload is new, so this always allocates and fills the
+    // index from the columns.
+    if (!payload->IndexReserve(count)) {
+        Release();
+        return false;
+    }
+    payload->hashDirty = true;
+    return true;
+}
+
+Bool FloatlistData::AssignEncoded(Int32 count, Int32 encoding, void* values,
+                                  Int valuesSize, void* names, Int namesSize)
+{
+    Release();
+    if (count <= 0 || !Detach()) {
+        DeleteMem(values);
+        DeleteMem(names);
+        return count == 0;
+    }
+
+    payload->pendingCount = count;
+    payload->pendingEncoding = encoding;
+    payload->pendingValues = values;
+    payload->pendingValuesSize = valuesSize;
+    payload->pending = true;
+    return AssignNames(count, names, namesSize);
+}
+
+Bool FloatlistData::AssignMapped(Int32 count, FloatlistSidecar* values, void* names,
+                                 Int namesSize)
+{
+    Release();
+    if (count <= 0 || values == nullptr || values->GetCount() != count || !Detach()) {
+        FloatlistSidecar::Free(values);
+        DeleteMem(names);
+        return false;
+    }
+
+    // Mapped values are used in place, only the names need to be
+    // decoded.
+    payload->sidecar = values;
+    payload->hashDirty = true;
+    return AssignNames(count, names, namesSize);
+}
+
+Bool FloatlistData::AssignNames(Int32 count, void* names, Int namesSize) {
+    Bool success = payload->ids.Resize(count)
+        && FloatlistCodec::DecodeNames(static_cast<const Char*>(names), namesSize,
+                payload->ids.GetFirst(), count);
+    DeleteMem(names);
+
+    // DecodeNames() takes no references when it fails, the IDs must
+    // not be released by the payload then.
+    if (!success) {
+        payload->ids.Flush();
+        Release();
+        return false;
+    }
+    if (!payload->IndexReserve(count)) {
+        Release();
+        return false;
+    }
+    return true;
+}
+
+Bool FloatlistData::WriteSidecar(UInt64* stamp) const {
+    if (!sidecar.Content())
+        return false;
+
+    // A list that is still mapped from its sidecar does not write
+    // anything unless its values were modified since it was loaded.
+    Payload* p = Touch();
+    if (p != nullptr && p->sidecar != nullptr && p->sidecar->GetPath() == sidecar) {
+        if (!p->sidecar->WriteBack())
+            return false;
+        if (stamp) *stamp = p->sidecar->GetStamp();
+        return true;
+    }
+    return FloatlistSidecar::Write(sidecar, p ? p->Values() : nullptr, p ? p->GetCount() : 0, stamp);
+}
+
+Bool FloatlistData::Pop() {
+    Int32 count = GetCount();
+    if (count <= 0 || !Detach() || !payload->Unmap())
+        return false;
+    payload->HashRemove(count - 1);
+    payload->IndexRemove(count - 1);
+    payload->values.Pop();
+    FloatlistSymbols::Release(payload->ids[count - 1]);
+    payload->ids.Pop();
+    return true;
+}
+
+void FloatlistData::Erase(Int32 index) {
+    if (!Detach() || !payload->Unmap())
+        return;
+
+    // All items behind the erased one move by one index, so their
+    // hashes and the whole index have to be updated. Erasing is
+    // linear anyway.
+    Int32 count = payload->GetCount();
+    for (Int32 i=index; i < count; i++)
+        payload->HashRemove(i);
+    payload->values.Erase(index);
+    FloatlistSymbols::Release(payload->ids[index]);
+    payload->ids.Erase(index);
+    for (Int32 i=index; i < count - 1; i++)
+        payload->HashAdd(i);
+    payload->IndexRebuild();
+}
+
+Bool FloatlistData::EnsureCapacity(Int32 count) {
+    if (!Detach() || !payload->Unmap())
+        return false;
+    return payload->values.EnsureCapacity(count)
+        && payload->ids.EnsureCapacity(count)
+        && payload->IndexReserve(count);
+}
+
+Bool FloatlistData::CopyFrom(const FloatlistData& other) {
+    // The copy shares the mapped values, but it must not write them
+    // to the file of the original.
+    encoding = other.encoding;
+    sidecar = Filename();
+    if (payload == other.payload)
+        return true;
+    Release();
+    payload = other.payload;
+    if (payload != nullptr)
+        payload->refs++;
+    return true;
+}
+
+Bool FloatlistData::SetName(Int32 i, const String& name) {
+    Int32 id = FloatlistSymbols::Intern(name);
+    if (id == NOTOK)
+        return false;
+    if (!Detach()) {
+        FloatlistSymbols::Release(id);
+        return false;
+    }
+
+    // The list adopts the reference from Intern().
+    payload->HashRemove(i);
+    payload->IndexRemove(i);
+    FloatlistSymbols::Release(payload->ids[i]);
+    payload->ids[i] = id;
+    payload->IndexInsert(i);
+    payload->HashAdd(i);
+    return true;
+}
+
+FloatlistData::Item FloatlistData::operator [] (Int32 i) {
+    if (!Detach()) {
+        // The item can not refer to the shared values, since other
+        // lists would see the change. It refers to the scratch value
+        // of this list instead, which is reset every time.
+        static const String noname;
+        scratch = 0.0;
+        return Item(payload ? GetName(i) : noname, scratch);
+    }
+    payload->hashDirty = true;
+    payload->SetDirty(i, 1);
+    return Item(GetName(i), payload->Values()[i]);
+}
+
+Bool FloatlistData::SetValue(Int32 i, Float value) {
+    if (!Detach())
+        return false;
+    payload->HashRemove(i);
+    payload->Values()[i] = value;
+    payload->SetDirty(i, 1);
+    payload->HashAdd(i);
+    return true;
+}
+
+Bool FloatlistData::GetValues(Int32 first, Int32 count, Float* out) const {
+    if (first < 0 || count < 0 || first + count > GetCount())
+        return false;
+    if (count > 0)
+        CopyMem(payload->Values() + first, out, count * sizeof(Float));
+    return true;
+}
+
+Bool FloatlistData::GetValues(const Int32* indices, Int32 count, Float* out) const {
+    Int32 size = GetCount();
+    const Float* values = GetValuesR();
+    for (Int32 i=0; i < count; i++) {
+        if (indices[i] < 0 || indices[i] >= size)
+            return false;
+        out[i] = values[indices[i]];
+    }
+    return true;
+}
+
+Bool FloatlistData::SetValues(Int32 first, Int32 count, const Float* values) {
+    if (first < 0 || count < 0 || first + count > GetCount())
+        return false;
+    if (count == 0)
+        return true;
+    if (!Detach())
+        return false;
+
+    // Updating the hash per item is only worth it if a small part
+    // of the list changes, otherwise it is recomputed on demand.
+    if (count * 4 > payload->GetCount())
+        payload->hashDirty = true;
+    for (Int32 i=first; i < first + count; i++)
+        payload->HashRemove(i);
+    CopyMem(values, payload->Values() + first, count * sizeof(Float));
+    for (Int32 i=first; i < first + count; i++)
+        payload->HashAdd(i);
+    payload->SetDirty(first, count);
+    return true;
+}
+
+Bool FloatlistData::SetValues(const Int32* indices, Int32 count, const Float* values) {
+    if (count <= 0)
+        return true;
+    if (!Detach())
+        return false;
+
+    Int32 size = payload->GetCount();
+    Float* column = payload->Values();
+    for (Int32 i=0; i < count; i++) {
+        Int32 index = indices[i];
+        if (index < 0 || index >= size)
+            return false;
+        payload->HashRemove(index);
+        column[index] = values[i];
+        payload->HashAdd(index);
+        payload->SetDirty(index, 1);
+    }
+    return true;
+}
+
+/**
+ * Stores the value of the item with the same name in *other* for
+ * each item of *list* in *out*. Items without a match get their own
+ * value if *own* is not nullptr or *fill* otherwise.
+ */
+static Bool GatherByName(const FloatlistData& list, const FloatlistData& other,
+                         const Float* own, Float fill, maxon::BaseArray<Float>& out)
+{
+    Int32 count = list.GetCount();
+    if (!out.Resize(count))
+        return false;
+    const Int32* ids = list.GetNameIdsR();
+    const Float* values = other.GetValuesR();
+    for (Int32 i=0; i < count; i++) {
+        Int32 j = other.FindNameId(ids[i]);
+        out[i] = j != NOTOK ? values[j] : (own ? own[i] : fill);
+    }
+    return true;
+}
+
+Bool FloatlistData::Add(const FloatlistData& other, Bool byName) {
+    Int32 count = byName ? GetCount() : Min(GetCount(), other.GetCount());
+    if (count == 0)
+        return true;
+    maxon::BaseArray<Float> matched;
+    if (byName && !GatherByName(*this, other, nullptr, 0.0, matched))
+        return false;
+    Float* values = GetValuesW();
+    if (values == nullptr)
+        return false;
+    FloatlistKernels::Add(values, values, byName ? matched.GetFirst() : other.GetValuesR(), count);
+    return true;
+}
+
+Bool FloatlistData::Mul(const FloatlistData& other, Bool byName) {
+    Int32 count = byName ? GetCount() : Min(GetCount(), other.GetCount());
+    if (count == 0)
+        return true;
+    maxon::BaseArray<Float> matched;
+    if (byName && !GatherByName(*this, other, nullptr, 1.0, matched))
+        return false;
+    Float* values = GetValuesW();
+    if (values == nullptr)
+        return false;
+    FloatlistKernels::Mul(values, values, byName ? matched.GetFirst() : other.GetValuesR(), count);
+    return true;
+}
+
+Bool FloatlistData::Lerp(const FloatlistData& other, Float t, Bool byName) {
+    Int32 count = byName ? GetCount() : Min(GetCount(), other.GetCount());
+    if (count == 0)
+        return true;
+    maxon::BaseArray<Float> matched;
+    if (byName && !GatherByName(*this, other, GetValuesR(), 0.0, matched))
+        return false;
+    Float* values = GetValuesW();
+    if (values == nullptr)
+        return false;
+    FloatlistKernels::Lerp(values, values, byName ? matched.GetFirst() : other.GetValuesR(), t, count);
+    return true;
+}
+
+Bool FloatlistData::Affine(Float scale, Float offset) {
+    Int32 count = GetCount();
+    if (count == 0)
+        return true;
+    Float* values = GetValuesW();
+    if (values == nullptr)
+        return false;
+    FloatlistKernels::Affine(values, values, scale, offset, count);
+    return true;
+}
+
+Bool FloatlistData::Clamp(Float lo, Float hi) {
+    Int32 count = GetCount();
+    if (count == 0)
+        return true;
+    Float* values = GetValuesW();
+    if (values == nullptr)
+        return false;
+    FloatlistKernels::Clamp(values, values, lo, hi, count);
+    return true;
+}
+
+Bool FloatlistData::Normalize() {
+    Float sum = GetSum();
+    if (sum == 0.0)
+        return false;
+    return Affine(1.0 / sum);
+}
+
+Float FloatlistData::GetSum() const {
+    Int32 count = GetCount();
+    return count > 0 ? FloatlistKernels::Sum(GetValuesR(), count) : 0.0;
+}
+
+Float FloatlistData::GetMin() const {
+    Int32 count = GetCount();
+    return count > 0 ? FloatlistKernels::Min(GetValuesR(), count) : 0.0;
+}
+
+Float FloatlistData::GetMax() const {
+    Int32 count = GetCount();
+    return count > 0 ? FloatlistKernels::Max(GetValuesR(), count) : 0.0;
+}
@@ -0,0 +1,235 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: call counters and latency histograms for the entry
+ *    points of the Floatlist datatype, and a command to print them
+ * tags: command profiling threading
+ * level: expert
+ * read-before: floatlist.cpp
+ */
+
+#include <atomic>
+#include <cstring>
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist-instrumentation.h>
+
+/**
+ * Plugin ID of the command that prints the report.
+ */
+static const Int32 ID_FLOATLISTINSTRUMENTATION = 1031959;
+
+#if FLOATLIST_INSTRUMENTATION
+
+static const Int32 STRIPE_COUNT = 16;
+
+/**
+ * Bucket *b* of a histogram counts the calls that took less than
+ * 2^b nanoseconds (and at least 2^(b-1)). The last bucket takes all
+ * longer calls.
+ */
+static const Int32 BUCKET_COUNT = 40;
+
+static const Char* const PROBE_NAMES[FLOATLIST_PROBE_COUNT] = {
+    "CopyData",
+    "Compare",
+    "_GetDescription",
+    "GetParameter",
+    "SetDParameter",
+    "WriteData",
+    "ReadData",
+    "Materialize",
+    "Detach",
+    "Gui::SetData",
+    "Gui::Rebuild",
+};
+
+struct ProbeCounters {
+    std::atomic<Int64> calls;
+    std::atomic<Int64> nanoseconds;
+    std::atomic<Int64> bytes;
+    std::atomic<Int64> buckets[BUCKET_COUNT];
+};
+
+struct CounterStripe {
+    ProbeCounters probes[FLOATLIST_PROBE_COUNT];
+};
+
+static CounterStripe g_stripes[STRIPE_COUNT];
+
+static ProbeCounters& GetCounters(FLOATLIST_PROBE probe) {
+    UInt32 id = GeGetCurrentThreadId() * 2654435761u;
+    return g_stripes[id >> 28 & (STRIPE_COUNT - 1)].probes[probe];
+}
+
+void FloatlistInstrumentation::Record(FLOATLIST_PROBE probe, Int64 nanoseconds, Int64 bytes) {
+    Int32 bucket = 0;
+    while (bucket < BUCKET_COUNT - 1 && ((Int64) 1 << bucket) <= nanoseconds)
+        bucket++;
+
+    ProbeCounters& counters = GetCounters(probe);
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+    counters.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+    counters.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    if (bytes != 0)
+        counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void FloatlistInstrumentation::AddBytes(FLOATLIST_PROBE probe, Int64 bytes) {
+    GetCounters(probe).bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+/**
+ * Returns the upper bound in microseconds of the bucket that
+ * contains the call at *fraction* of the calls.
+ */
+static Float64 Percentile(const Int64* buckets, Int64 calls, Float64 fraction) {
+    Int64 rank = (Int64) (fraction * (calls - 1));
+    Int64 seen = 0;
+    for (Int32 b=0; b < BUCKET_COUNT; b++) {
+        seen += buckets[b];
+        if (seen > rank)
+            return (Float64) ((Int64) 1 << b) / 1000.0;
+    }
+    return (Float64) ((Int64) 1 << (BUCKET_COUNT - 1)) / 1000.0;
+}
+
+String FloatlistInstrumentation::GetReport() {
+    String report = "probe, calls, total ms, mean us, p50 us, p90 us, p99 us, bytes\n";
+    for (Int32 p=0; p < FLOATLIST_PROBE_COUNT; p++) {
+        // Sum up the stripes, they are read without stopping the
+        // writers, so a report taken while Cinema is busy can be
+        // off by the calls that are in progress.
+        Int64 calls = 0, ns = 0, bytes = 0;
+        Int64 buckets[BUCKET_COUNT];
+        for (Int32 b=0; b < BUCKET_COUNT; b++)
+            buckets[b] = 0;
+        for (Int32 s=0; s < STRIPE_COUNT; s++) {
+            const ProbeCounters& c = g_stripes[s].probes[p];
+            calls += c.calls;
+            ns += c.nanoseconds;
+            bytes += c.bytes;
+            for (Int32 b=0; b < BUCKET_COUNT; b++)
+                buckets[b] += c.buckets[b];
+        }
+        if (calls == 0)
+            continue;
+
+        report += String(PROBE_NAMES[p]) + ", " + String::IntToString(calls)
+               + ", " + String::FloatToString(ns / 1000000.0)
+               + ", " + String::FloatToString(ns / 1000.0 / calls)
+               + ", " + String::FloatToString(Percentile(buckets, calls, 0.5))
+               + ", " + String::FloatToString(Percentile(buckets, calls, 0.9))
+               + ", " + String::FloatToString(Percentile(buckets, calls, 0.99))
+               + ", " + String::IntToString(bytes) + "\n";
+    }
+    return report;
+}
+
+void FloatlistInstrumentation::Reset() {
+    for (Int32 s=0; s < STRIPE_COUNT; s++) {
+        for (Int32 p=0; p < FLOATLIST_PROBE_COUNT; p++) {
+            ProbeCounters& c = g_stripes[s].probes[p];
+            c.calls = 0;
+            c.nanoseconds = 0;
+            c.bytes = 0;
+            for (Int32 b=0; b < BUCKET_COUNT; b++)
+                c.buckets[b] = 0;
+        }
+    }
+}
+
+/**
+ * Prints the report to the console and writes it to
+ * `floatlist-instrumentation.csv` in the user folder. With *reset*,
+ * the counters start anew, so that the next report covers the time
+ * since this one. Called from PluginMessage() when Cinema quits, by
+ * the benchmark after its runs and by the command below.
+ */
+void Report_FloatlistInstrumentation(Bool reset) {
+    String report = FloatlistInstrumentation::GetReport();
+    GePrint(report);
+
+    Filename path = GeGetStartupWritePath() + Filename("floatlist-instrumentation.csv");
+    AutoAlloc<BaseFile> file;
+    Char* cstr = report.GetCStringCopy(STRINGENCODING_UTF8);
+    Bool ok = file && cstr && file->Open(path, FILEOPEN_WRITE, FILEDIALOG_NONE)
+           && file->WriteBytes(cstr, strlen(cstr));
+    if (file) ok = file->Close() && ok;
+    DeleteMem(cstr);
+    if (!ok)
+        GePrint("Floatlist instrumentation: could not write " + path.GetString());
+
+    if (reset)
+        FloatlistInstrumentation::Reset();
+}
+
+#else
+
+void Report_FloatlistInstrumentation(Bool reset) {
+}
+
+#endif
+
+/**
+ * The command reports the counters collected so far. The option
+ * (the cog next to the command in the menu) also resets them, to
+ * measure a single action in Cinema.
+ */
+class FloatlistInstrumentationCommand : public CommandData {
+
+public:
+
+    //| CommandData Overrides
+
+    virtual Bool Execute(BaseDocument* doc) {
+        return Report(false);
+    }
+
+    virtual Bool ExecuteOptionID(BaseDocument* doc, Int32 plugid, Int32 subid) {
+        return Report(true);
+    }
+
+private:
+
+    static Bool Report(Bool reset) {
+        if (!FLOATLIST_INSTRUMENTATION)
+            GePrint("Floatlist instrumentation: compile with FLOATLIST_INSTRUMENTATION=1 to count the calls");
+        Report_FloatlistInstrumentation(reset);
+        return true;
+    }
+
+};
+
+/**
+ * Called from Register_Datatype_Floatlist().
+ */
+Bool Register_FloatlistInstrumentation() {
+    CommandData* plugin_command = NewObj(FloatlistInstrumentationCommand);
+    if (!plugin_command) return false; // memory error
+
+    return RegisterCommandPlugin(
+            ID_FLOATLISTINSTRUMENTATION,
+            "datatype/Floatlist Instrumentation",
+            PLUGINFLAG_COMMAND_OPTION_DIALOG,
+            nullptr,
+            "Prints the call counters of the Floatlist datatype, the option also resets them.",
+            plugin_command);
+}
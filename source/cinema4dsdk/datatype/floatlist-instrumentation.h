@@ -0,0 +1,131 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CINEMA4DSDK_DATATYPE_FLOATLIST_INSTRUMENTATION_H
+#define CINEMA4DSDK_DATATYPE_FLOATLIST_INSTRUMENTATION_H
+
+#include <c4d.h>
+
+/**
+ * Compile with FLOATLIST_INSTRUMENTATION defined to 1 to count the
+ * calls and measure the time of the entry points of the Floatlist
+ * datatype. Without it, the macros below expand to nothing and the
+ * instrumentation costs nothing.
+ */
+#ifndef FLOATLIST_INSTRUMENTATION
+    #define FLOATLIST_INSTRUMENTATION 0
+#endif
+
+/**
+ * The instrumented entry points.
+ */
+enum FLOATLIST_PROBE {
+    FLOATLIST_PROBE_COPYDATA,
+    FLOATLIST_PROBE_COMPARE,
+    FLOATLIST_PROBE_GETDESCRIPTION,
+    FLOATLIST_PROBE_GETPARAMETER,
+    FLOATLIST_PROBE_SETDPARAMETER,
+    FLOATLIST_PROBE_WRITEDATA,
+    FLOATLIST_PROBE_READDATA,
+    FLOATLIST_PROBE_MATERIALIZE,
+    FLOATLIST_PROBE_DETACH,
+    FLOATLIST_PROBE_GUI_SETDATA,
+    FLOATLIST_PROBE_GUI_REBUILD,
+
+    FLOATLIST_PROBE_COUNT,
+};
+
+#if FLOATLIST_INSTRUMENTATION
+
+/**
+ * Collects the call counts, latencies and copied bytes of the
+ * probes. The counters are spread over stripes picked by the ID of
+ * the calling thread and updated with atomic additions, so threads
+ * do not contend for them. Latencies are kept in a histogram with a
+ * bucket per power of two nanoseconds, percentiles are therefore
+ * accurate to a factor of two.
+ */
+class FloatlistInstrumentation {
+
+public:
+
+    /**
+     * Records a call of *probe* that took *nanoseconds* and copied
+     * *bytes*.
+     */
+    static void Record(FLOATLIST_PROBE probe, Int64 nanoseconds, Int64 bytes);
+
+    /**
+     * Adds copied bytes to a call that is recorded separately.
+     */
+    static void AddBytes(FLOATLIST_PROBE probe, Int64 bytes);
+
+    /**
+     * Returns a table with one line per probe that was called.
+     */
+    static String GetReport();
+
+    static void Reset();
+
+};
+
+/**
+ * Measures the time from its construction to its destruction and
+ * records it for a probe. Use it through FLOATLIST_PROBE_SCOPE().
+ */
+class FloatlistProbeScope {
+
+public:
+
+    explicit FloatlistProbeScope(FLOATLIST_PROBE probe)
+    : m_probe(probe), m_start(GeGetMilliSeconds()), m_bytes(0) { }
+
+    ~FloatlistProbeScope() {
+        Int64 ns = (Int64) ((GeGetMilliSeconds() - m_start) * 1000000.0);
+        FloatlistInstrumentation::Record(m_probe, ns, m_bytes);
+    }
+
+    void AddBytes(Int64 bytes) {
+        m_bytes += bytes;
+    }
+
+private:
+
+    FLOATLIST_PROBE m_probe;
+    Float64 m_start;
+    Int64 m_bytes;
+
+};
+
+    #define FLOATLIST_PROBE_SCOPE(probe) FloatlistProbeScope floatlistProbe_(probe)
+    #define FLOATLIST_PROBE_BYTES(bytes) floatlistProbe_.AddBytes(bytes)
+    #define FLOATLIST_PROBE_ADDBYTES(probe, bytes) FloatlistInstrumentation::AddBytes(probe, bytes)
+
+#else
+
+    #define FLOATLIST_PROBE_SCOPE(probe) ((void) 0)
+    #define FLOATLIST_PROBE_BYTES(bytes) ((void) 0)
+    #define FLOATLIST_PROBE_ADDBYTES(probe, bytes) ((void) 0)
+
+#endif
+
+#endif /* CINEMA4DSDK_DATATYPE_FLOATLIST_INSTRUMENTATION_H */
@@ -0,0 +1,261 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: SIMD kernels for whole-list operations on the Floatlist
+ * level: expert
+ * tags: simd, performance
+ * read-before: floatlist.cpp
+ */
+
+#if defined __AVX__
+    #include <immintrin.h>
+#elif defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define FLOATLIST_SSE2
+#endif
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist-kernels.h>
+
+/**
+ * The kernels are written once against the small interface of
+ * these structures, which wrap the vector type and intrinsics of
+ * one instruction set. The remaining elements that do not fill a
+ * whole vector are processed with ScalarOps.
+ */
+struct ScalarOps {
+    typedef Float V;
+    static const Int N = 1;
+    static V Load(const Float* p) { return *p; }
+    static void Store(Float* p, V v) { *p = v; }
+    static V Set(Float x) { return x; }
+    static V Add(V a, V b) { return a + b; }
+    static V Sub(V a, V b) { return a - b; }
+    static V Mul(V a, V b) { return a * b; }
+    // The same as minpd and maxpd, which return *b* if either
+    // operand is NaN. The tail must treat NaN like the vectors.
+    static V Min(V a, V b) { return a < b ? a : b; }
+    static V Max(V a, V b) { return a > b ? a : b; }
+    static Float Sum(V v) { return v; }
+    static Float MinAll(V v) { return v; }
+    static Float MaxAll(V v) { return v; }
+};
+
+#if defined __AVX__
+
+static const Char* INSTRUCTION_SET = "AVX";
+
+struct SimdOps {
+    typedef __m256d V;
+    static const Int N = 4;
+    static V Load(const Float* p) { return _mm256_loadu_pd(p); }
+    static void Store(Float* p, V v) { _mm256_storeu_pd(p, v); }
+    static V Set(Float x) { return _mm256_set1_pd(x); }
+    static V Add(V a, V b) { return _mm256_add_pd(a, b); }
+    static V Sub(V a, V b) { return _mm256_sub_pd(a, b); }
+    static V Mul(V a, V b) { return _mm256_mul_pd(a, b); }
+    static V Min(V a, V b) { return _mm256_min_pd(a, b); }
+    static V Max(V a, V b) { return _mm256_max_pd(a, b); }
+    static Float Sum(V v) {
+        Float x[4];
+        _mm256_storeu_pd(x, v);
+        return (x[0] + x[1]) + (x[2] + x[3]);
+    }
+    static Float MinAll(V v) {
+        Float x[4];
+        _mm256_storeu_pd(x, v);
+        return ScalarOps::Min(ScalarOps::Min(x[0], x[1]), ScalarOps::Min(x[2], x[3]));
+    }
+    static Float MaxAll(V v) {
+        Float x[4];
+        _mm256_storeu_pd(x, v);
+        return ScalarOps::Max(ScalarOps::Max(x[0], x[1]), ScalarOps::Max(x[2], x[3]));
+    }
+};
+
+#elif defined FLOATLIST_SSE2
+
+static const Char* INSTRUCTION_SET = "SSE2";
+
+struct SimdOps {
+    typedef __m128d V;
+    static const Int N = 2;
+    static V Load(const Float* p) { return _mm_loadu_pd(p); }
+    static void Store(Float* p, V v) { _mm_storeu_pd(p, v); }
+    static V Set(Float x) { return _mm_set1_pd(x); }
+    static V Add(V a, V b) { return _mm_add_pd(a, b); }
+    static V Sub(V a, V b) { return _mm_sub_pd(a, b); }
+    static V Mul(V a, V b) { return _mm_mul_pd(a, b); }
+    static V Min(V a, V b) { return _mm_min_pd(a, b); }
+    static V Max(V a, V b) { return _mm_max_pd(a, b); }
+    static Float Sum(V v) {
+        Float x[2];
+        _mm_storeu_pd(x, v);
+        return x[0] + x[1];
+    }
+    static Float MinAll(V v) {
+        Float x[2];
+        _mm_storeu_pd(x, v);
+        return ScalarOps::Min(x[0], x[1]);
+    }
+    static Float MaxAll(V v) {
+        Float x[2];
+        _mm_storeu_pd(x, v);
+        return ScalarOps::Max(x[0], x[1]);
+    }
+};
+
+#else
+
+static const Char* INSTRUCTION_SET = "Scalar";
+
+typedef ScalarOps SimdOps;
+
+#endif
+
+/**
+ * Runs *op* over all elements, first with full vectors and then
+ * with scalars for the rest. *op* is called with the instruction
+ * set structure as template argument and the index of the first
+ * element.
+ */
+template <typename Op>
+static void ForEach(Int count, Op op) {
+    Int i = 0;
+    for (; i + SimdOps::N <= count; i += SimdOps::N)
+        op.template Run<SimdOps>(i);
+    for (; i < count; i++)
+        op.template Run<ScalarOps>(i);
+}
+
+struct AddOp {
+    Float* dst; const Float* a; const Float* b;
+    template <typename S> void Run(Int i) const {
+        S::Store(dst + i, S::Add(S::Load(a + i), S::Load(b + i)));
+    }
+};
+
+struct MulOp {
+    Float* dst; const Float* a; const Float* b;
+    template <typename S> void Run(Int i) const {
+        S::Store(dst + i, S::Mul(S::Load(a + i), S::Load(b + i)));
+    }
+};
+
+struct AffineOp {
+    Float* dst; const Float* a; Float scale; Float offset;
+    template <typename S> void Run(Int i) const {
+        S::Store(dst + i, S::Add(S::Mul(S::Load(a + i), S::Set(scale)), S::Set(offset)));
+    }
+};
+
+struct LerpOp {
+    Float* dst; const Float* a; const Float* b; Float t;
+    template <typename S> void Run(Int i) const {
+        typename S::V va = S::Load(a + i);
+        S::Store(dst + i, S::Add(va, S::Mul(S::Sub(S::Load(b + i), va), S::Set(t))));
+    }
+};
+
+struct ClampOp {
+    Float* dst; const Float* a; Float lo; Float hi;
+    template <typename S> void Run(Int i) const {
+        S::Store(dst + i, S::Min(S::Max(S::Load(a + i), S::Set(lo)), S::Set(hi)));
+    }
+};
+
+const Char* FloatlistKernels::GetInstructionSet() {
+    return INSTRUCTION_SET;
+}
+
+void FloatlistKernels::Add(Float* dst, const Float* a, const Float* b, Int count) {
+    AddOp op = { dst, a, b };
+    ForEach(count, op);
+}
+
+void FloatlistKernels::Mul(Float* dst, const Float* a, const Float* b, Int count) {
+    MulOp op = { dst, a, b };
+    ForEach(count, op);
+}
+
+void FloatlistKernels::Affine(Float* dst, const Float* a, Float scale, Float offset, Int count) {
+    AffineOp op = { dst, a, scale, offset };
+    ForEach(count, op);
+}
+
+void FloatlistKernels::Lerp(Float* dst, const Float* a, const Float* b, Float t, Int count) {
+    LerpOp op = { dst, a, b, t };
+    ForEach(count, op);
+}
+
+void FloatlistKernels::Clamp(Float* dst, const Float* a, Float lo, Float hi, Int count) {
+    ClampOp op = { dst, a, lo, hi };
+    ForEach(count, op);
+}
+
+Float FloatlistKernels::Sum(const Float* a, Int count) {
+    // Four independent accumulators hide the latency of the
+    // additions.
+    SimdOps::V acc[4] = { SimdOps::Set(0.0), SimdOps::Set(0.0), SimdOps::Set(0.0), SimdOps::Set(0.0) };
+    Int i = 0;
+    for (; i + 4 * SimdOps::N <= count; i += 4 * SimdOps::N) {
+        for (Int j=0; j < 4; j++)
+            acc[j] = SimdOps::Add(acc[j], SimdOps::Load(a + i + j * SimdOps::N));
+    }
+    Float sum = SimdOps::Sum(SimdOps::Add(SimdOps::Add(acc[0], acc[1]), SimdOps::Add(acc[2], acc[3])));
+    for (; i < count; i++)
+        sum += a[i];
+    return sum;
+}
+
+Float FloatlistKernels::Min(const Float* a, Int count) {
+    if (count < SimdOps::N) {
+        Float result = a[0];
+        for (Int i=1; i < count; i++)
+            result = ScalarOps::Min(result, a[i]);
+        return result;
+    }
+    SimdOps::V acc = SimdOps::Load(a);
+    Int i = SimdOps::N;
+    for (; i + SimdOps::N <= count; i += SimdOps::N)
+        acc = SimdOps::Min(acc, SimdOps::Load(a + i));
+    Float result = SimdOps::MinAll(acc);
+    for (; i < count; i++)
+        result = ScalarOps::Min(result, a[i]);
+    return result;
+}
+
+Float FloatlistKernels::Max(const Float* a, Int count) {
+    if (count < SimdOps::N) {
+        Float result = a[0];
+        for (Int i=1; i < count; i++)
+            result = ScalarOps::Max(result, a[i]);
+        return result;
+    }
+    SimdOps::V acc = SimdOps::Load(a);
+    Int i = SimdOps::N;
+    for (; i + SimdOps::N <= count; i += SimdOps::N)
+        acc = SimdOps::Max(acc, SimdOps::Load(a + i));
+    Float result = SimdOps::MaxAll(acc);
+    for (; i < count; i++)
+        result = ScalarOps::Max(result, a[i]);
+    return result;
+}
@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CINEMA4DSDK_DATATYPE_FLOATLIST_KERNELS_H
+#define CINEMA4DSDK_DATATYPE_FLOATLIST_KERNELS_H
+
+#include <c4d.h>
+
+/**
+ * Element-wise operations on arrays of Floats, the building blocks
+ * of the whole-list operations of the FloatlistData. They use AVX if
+ * the plugin is compiled with AVX enabled, SSE2 on every other x86
+ * build and plain loops elsewhere. The arrays do not need to be
+ * aligned and *dst* may be the same as one of the inputs.
+ */
+class FloatlistKernels {
+
+public:
+
+    /**
+     * Returns the name of the instruction set the kernels were
+     * compiled for ("AVX", "SSE2" or "Scalar").
+     */
+    static const Char* GetInstructionSet();
+
+    // dst[i] = a[i] + b[i]
+    static void Add(Float* dst, const Float* a, const Float* b, Int count);
+
+    // dst[i] = a[i] * b[i]
+    static void Mul(Float* dst, const Float* a, const Float* b, Int count);
+
+    // dst[i] = a[i] * scale + offset
+    static void Affine(Float* dst, const Float* a, Float scale, Float offset, Int count);
+
+    // dst[i] = a[i] + (b[i] - a[i]) * t
+    static void Lerp(Float* dst, const Float* a, const Float* b, Float t, Int count);
+
+    // dst[i] = min(max(a[i], lo), hi), NaN becomes lo
+    static void Clamp(Float* dst, const Float* a, Float lo, Float hi, Int count);
+
+    static Float Sum(const Float* a, Int count);
+
+    /**
+     * Return the smallest and largest value. Undefined for
+     * *count* == 0. NaN is compared like minpd and maxpd do, so
+     * it is skipped unless it is the last value of a vector lane
+     * or of the tail. Do not rely on the result for lists that
+     * contain NaN.
+     */
+    static Float Min(const Float* a, Int count);
+    static Float Max(const Float* a, Int count);
+
+};
+
+#endif /* CINEMA4DSDK_DATATYPE_FLOATLIST_KERNELS_H */
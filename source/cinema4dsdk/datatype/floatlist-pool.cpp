@@ -0,0 +1,170 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: a thread-safe pool of FloatlistData instances
+ * level: expert
+ * tags: memory, threading
+ * read-before: floatlist.cpp
+ */
+
+#include <atomic>
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist.h>
+#include <cinema4dsdk/datatype/floatlist-pool.h>
+
+/**
+ * Number of stripes (a power of two), the number of instances a
+ * stripe holds, and the size of the shared overflow list. Stripes
+ * exchange half of their capacity with the overflow at once, so
+ * the overflow lock is taken rarely.
+ */
+static const Int32 STRIPE_COUNT = 16;
+static const Int32 STRIPE_CAPACITY = 64;
+static const Int32 OVERFLOW_CAPACITY = 1024;
+static const Int32 TRANSFER = STRIPE_CAPACITY / 2;
+
+struct PoolList {
+    GeSpinlock lock;
+    Int32 count;
+    FloatlistData* items[OVERFLOW_CAPACITY];
+};
+
+struct PoolStripe {
+    GeSpinlock lock;
+    Int32 count;
+    FloatlistData* items[STRIPE_CAPACITY];
+};
+
+static PoolStripe g_stripes[STRIPE_COUNT];
+static PoolList g_overflow;
+static std::atomic<Bool> g_closed(false);
+
+static std::atomic<Int> g_hits(0);
+static std::atomic<Int> g_misses(0);
+static std::atomic<Int> g_live(0);
+static std::atomic<Int> g_peak(0);
+
+static PoolStripe& GetStripe() {
+    // Thread IDs are often multiples of a small power of two,
+    // mix them before picking a stripe.
+    UInt32 id = GeGetCurrentThreadId() * 2654435761u;
+    return g_stripes[id >> 28 & (STRIPE_COUNT - 1)];
+}
+
+static void CountLive() {
+    Int live = ++g_live;
+    Int peak = g_peak;
+    while (live > peak && !g_peak.compare_exchange_weak(peak, live)) { }
+}
+
+FloatlistData* FloatlistPool::Acquire() {
+    FloatlistData* data = nullptr;
+    if (!g_closed) {
+        PoolStripe& stripe = GetStripe();
+        stripe.lock.Lock();
+        if (stripe.count == 0) {
+            g_overflow.lock.Lock();
+            while (stripe.count < TRANSFER && g_overflow.count > 0)
+                stripe.items[stripe.count++] = g_overflow.items[--g_overflow.count];
+            g_overflow.lock.Unlock();
+        }
+        if (stripe.count > 0)
+            data = stripe.items[--stripe.count];
+        stripe.lock.Unlock();
+    }
+
+    if (data != nullptr) {
+        g_hits++;
+    }
+    else {
+        data = NewObj(FloatlistData);
+        if (data == nullptr)
+            return nullptr;
+        g_misses++;
+    }
+    CountLive();
+    return data;
+}
+
+void FloatlistPool::Recycle(FloatlistData* data) {
+    if (data == nullptr)
+        return;
+    g_live--;
+
+    // Releases the payload now instead of when the instance is
+    // re-used, the pool only keeps empty lists.
+    *data = FloatlistData();
+
+    if (!g_closed) {
+        PoolStripe& stripe = GetStripe();
+        stripe.lock.Lock();
+        if (stripe.count == STRIPE_CAPACITY) {
+            g_overflow.lock.Lock();
+            while (stripe.count > STRIPE_CAPACITY - TRANSFER && g_overflow.count < OVERFLOW_CAPACITY)
+                g_overflow.items[g_overflow.count++] = stripe.items[--stripe.count];
+            g_overflow.lock.Unlock();
+        }
+        if (stripe.count < STRIPE_CAPACITY) {
+            stripe.items[stripe.count++] = data;
+            data = nullptr;
+        }
+        stripe.lock.Unlock();
+    }
+
+    // The pool is full or closed.
+    if (data != nullptr)
+        DeleteObj(data);
+}
+
+void FloatlistPool::GetStats(Stats& stats) {
+    stats.hits = g_hits;
+    stats.misses = g_misses;
+    stats.live = g_live;
+    stats.peak = g_peak;
+    stats.pooled = 0;
+    for (Int32 i=0; i < STRIPE_COUNT; i++) {
+        g_stripes[i].lock.Lock();
+        stats.pooled += g_stripes[i].count;
+        g_stripes[i].lock.Unlock();
+    }
+    g_overflow.lock.Lock();
+    stats.pooled += g_overflow.count;
+    g_overflow.lock.Unlock();
+}
+
+void FloatlistPool::Free() {
+    g_closed = true;
+    for (Int32 i=0; i < STRIPE_COUNT; i++) {
+        PoolStripe& stripe = g_stripes[i];
+        stripe.lock.Lock();
+        while (stripe.count > 0) {
+            FloatlistData* data = stripe.items[--stripe.count];
+            DeleteObj(data);
+        }
+        stripe.lock.Unlock();
+    }
+    g_overflow.lock.Lock();
+    while (g_overflow.count > 0) {
+        FloatlistData* data = g_overflow.items[--g_overflow.count];
+        DeleteObj(data);
+    }
+    g_overflow.lock.Unlock();
+}
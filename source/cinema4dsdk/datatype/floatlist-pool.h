@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CINEMA4DSDK_DATATYPE_FLOATLIST_POOL_H
+#define CINEMA4DSDK_DATATYPE_FLOATLIST_POOL_H
+
+#include <c4d.h>
+
+class FloatlistData;
+
+/**
+ * Recycles FloatlistData instances. Cinema allocates and frees the
+ * data of a custom datatype whenever a GeData is copied, which
+ * happens all the time during undo, Attribute Manager updates and
+ * when documents are cloned.
+ *
+ * Released instances are kept in one of several stripes, picked by
+ * the ID of the calling thread, so threads rarely wait for each
+ * other. A full stripe hands half of its instances to a shared
+ * overflow list and an empty stripe takes them back from there
+ * before new memory is allocated.
+ */
+class FloatlistPool {
+
+public:
+
+    struct Stats {
+
+        /**
+         * Number of Acquire() calls served from the pool and number
+         * of calls that had to allocate.
+         */
+        Int hits;
+        Int misses;
+
+        /**
+         * Number of instances currently handed out and the largest
+         * number handed out at the same time.
+         */
+        Int live;
+        Int peak;
+
+        /**
+         * Number of instances waiting in the pool.
+         */
+        Int pooled;
+
+    };
+
+    /**
+     * Returns an empty FloatlistData or nullptr on a memory error.
+     */
+    static FloatlistData* Acquire();
+
+    /**
+     * Clears *data* and keeps it for the next Acquire(), or deletes
+     * it if the pool is full or was already freed.
+     */
+    static void Recycle(FloatlistData* data);
+
+    static void GetStats(Stats& stats);
+
+    /**
+     * Deletes all pooled instances. Called from PluginEnd(), later
+     * calls to Recycle() delete the instances immediately.
+     */
+    static void Free();
+
+};
+
+#endif /* CINEMA4DSDK_DATATYPE_FLOATLIST_POOL_H */
@@ -0,0 +1,240 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: edits a Floatlist parameter on all selected nodes at once
+ * level: expert
+ * tags: description, undo
+ * read-before: floatlist.cpp
+ */
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist-selection.h>
+
+/**
+ * Returns true if *node* has the Floatlist parameter *id* in its
+ * description. The name of the parameter is not compared, it is
+ * localized and not unique.
+ */
+static Bool HasParameter(BaseList2D* node, const DescID& id) {
+    AutoAlloc<Description> desc;
+    if (!desc || !node->GetDescription(desc, DESCFLAGS_DESC_0))
+        return false;
+
+    Bool result = false;
+    const BaseContainer* bc = nullptr;
+    DescID other, groupid;
+    void* handle = desc->BrowseInit();
+    while (desc->GetNext(handle, &bc, other, groupid)) {
+        if (other.GetDepth() == 1 && other[0].id == id[0].id
+                && other[0].dtype == CUSTOMDATATYPE_FLOATLIST) {
+            result = true;
+            break;
+        }
+    }
+    desc->BrowseFree(handle);
+    return result;
+}
+
+/**
+ * Fills *nodes* with the active objects, tags and materials of
+ * *doc*. Returns false on a memory error.
+ */
+static Bool GetActiveNodes(BaseDocument* doc, maxon::BaseArray<BaseList2D*>& nodes) {
+    nodes.Flush();
+
+    // Each of the methods fills its own array.
+    AutoAlloc<AtomArray> objects, tags, materials;
+    if (!objects || !tags || !materials)
+        return false;
+    doc->GetActiveObjects(*objects, GETACTIVEOBJECTFLAGS_0);
+    doc->GetActiveTags(*tags);
+    doc->GetActiveMaterials(*materials);
+
+    AtomArray* arrays[] = { objects, tags, materials };
+    for (AtomArray* atoms : arrays) {
+        Int32 count = atoms->GetCount();
+        for (Int32 i=0; i < count; i++) {
+            if (nodes.Append(static_cast<BaseList2D*>(atoms->GetIndex(i))) == nullptr)
+                return false;
+        }
+    }
+    return true;
+}
+
+Int32 FloatlistSelection::Collect(BaseDocument* doc, Int32 param) {
+    Flush();
+    if (doc == nullptr || !GetActiveNodes(doc, m_active))
+        return 0;
+
+    DescID id(DescLevel(param, CUSTOMDATATYPE_FLOATLIST, 0));
+
+    Int32 count = (Int32) m_active.GetCount();
+    for (Int32 i=0; i < count; i++) {
+        BaseList2D* node = m_active[i];
+        if (!HasParameter(node, id))
+            continue;
+
+        BaseLink* link = BaseLink::Alloc();
+        if (link == nullptr)
+            break;
+        link->SetLink(node);
+
+        Entry entry;
+        entry.link = link;
+        entry.id = id;
+        if (m_entries.Append(entry) == nullptr) {
+            BaseLink::Free(link);
+            break;
+        }
+    }
+
+    m_doc = doc;
+    return GetCount();
+}
+
+Bool FloatlistSelection::IsCurrent(BaseDocument* doc) const {
+    if (doc == nullptr || doc != m_doc)
+        return false;
+    maxon::BaseArray<BaseList2D*> nodes;
+    if (!GetActiveNodes(doc, nodes) || nodes.GetCount() != m_active.GetCount())
+        return false;
+    for (Int32 i=0; i < (Int32) nodes.GetCount(); i++) {
+        if (nodes[i] != m_active[i])
+            return false;
+    }
+    return true;
+}
+
+void FloatlistSelection::Flush() {
+    for (Int32 i=0; i < GetCount(); i++)
+        BaseLink::Free(m_entries[i].link);
+    m_entries.Flush();
+    m_active.Flush();
+    m_doc = nullptr;
+}
+
+Bool FloatlistSelection::Merge(FloatlistData& merged, maxon::BaseArray<Bool>& differs) const {
+    merged.Flush();
+    differs.Flush();
+
+    // The number of lists that have each merged item, items that
+    // are missing in any list are marked as differing at the end.
+    maxon::BaseArray<Int32> found;
+    Int32 lists = 0;
+
+    for (Int32 i=0; i < GetCount(); i++) {
+        BaseList2D* node = m_entries[i].link->GetLink(m_doc);
+        GeData data;
+        if (node == nullptr || !node->GetParameter(m_entries[i].id, data, DESCFLAGS_GET_0))
+            continue;
+        const FloatlistData* list = FloatlistData::Get(data);
+        if (list == nullptr)
+            continue;
+        lists++;
+
+        Int32 count = list->GetCount();
+        const Int32* ids = list->GetNameIdsR();
+        const Float* values = list->GetValuesR();
+        for (Int32 j=0; j < count; j++) {
+            Int32 index = merged.FindNameId(ids[j]);
+            if (index == NOTOK) {
+                if (!merged.AppendId(ids[j], values[j]) || differs.Append(false) == nullptr
+                        || found.Append(1) == nullptr)
+                    return false;
+                continue;
+            }
+            if (Abs(merged.GetValue(index) - values[j]) > FloatlistData::TOLERANCE)
+                differs[index] = true;
+            found[index]++;
+        }
+    }
+
+    for (Int32 index=0; index < (Int32) found.GetCount(); index++) {
+        if (found[index] < lists)
+            differs[index] = true;
+    }
+    return true;
+}
+
+template <typename Fn>
+Bool FloatlistSelection::Modify(Bool undo, Fn modify) {
+    // The selection could have been collected from a document that
+    // is not active anymore.
+    if (m_doc == nullptr || m_doc != GetActiveDocument())
+        return false;
+
+    if (undo) m_doc->StartUndo();
+    for (Int32 i=0; i < GetCount(); i++) {
+        BaseList2D* node = m_entries[i].link->GetLink(m_doc);
+        GeData data;
+        if (node == nullptr || !node->GetParameter(m_entries[i].id, data, DESCFLAGS_GET_0))
+            continue;
+        const FloatlistData* list = FloatlistData::Get(data);
+        if (list == nullptr)
+            continue;
+
+        // The copy shares the items of the node until it is
+        // modified, so lists that are not changed cost nothing.
+        FloatlistData copy(*list);
+        if (!modify(copy))
+            continue;
+
+        if (undo) m_doc->AddUndo(UNDOTYPE_CHANGE_SMALL, node);
+        node->SetParameter(m_entries[i].id, GeData(CUSTOMDATATYPE_FLOATLIST, copy),
+                DESCFLAGS_SET_USERINTERACTION);
+    }
+    if (undo) m_doc->EndUndo();
+
+    EventAdd();
+    return true;
+}
+
+Bool FloatlistSelection::SetValues(const FloatlistData& merged, const Int32* ids,
+                                   Int32 count, Bool undo)
+{
+    return Modify(undo, [&](FloatlistData& list) {
+        Bool changed = false;
+        for (Int32 i=0; i < count; i++) {
+            Int32 source = merged.FindNameId(ids[i]);
+            Int32 index = list.FindNameId(ids[i]);
+            if (source == NOTOK || index == NOTOK)
+                continue;
+            changed = list.SetValue(index, merged.GetValue(source)) || changed;
+        }
+        return changed;
+    });
+}
+
+Bool FloatlistSelection::Append(const String& name, Float value) {
+    return Modify(true, [&](FloatlistData& list) {
+        return list.FindName(name) == NOTOK && list.Append(name, value);
+    });
+}
+
+Bool FloatlistSelection::Erase(Int32 id) {
+    return Modify(true, [&](FloatlistData& list) {
+        Int32 index = list.FindNameId(id);
+        if (index == NOTOK)
+            return false;
+        list.Erase(index);
+        return true;
+    });
+}
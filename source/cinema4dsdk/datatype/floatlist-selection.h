@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CINEMA4DSDK_DATATYPE_FLOATLIST_SELECTION_H
+#define CINEMA4DSDK_DATATYPE_FLOATLIST_SELECTION_H
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist.h>
+
+/**
+ * The Floatlist parameters with the same ID on all selected nodes
+ * of a document. The FloatlistGui uses this to edit all lists at
+ * once when multiple nodes are displayed in the Attribute Manager,
+ * since the TriState it receives only holds the first value.
+ *
+ * The nodes are referenced by BaseLinks, so the selection stays
+ * safe to use when nodes are deleted in the meantime. All methods
+ * that modify the lists do so in a single undo step.
+ */
+class FloatlistSelection {
+
+public:
+
+    FloatlistSelection() : m_doc(nullptr), m_entries(), m_active() { }
+
+    ~FloatlistSelection() {
+        Flush();
+    }
+
+    /**
+     * Finds the Floatlist parameters with the ID *param* on the
+     * active objects, tags and materials of *doc*. Returns the
+     * number of parameters that were found.
+     */
+    Int32 Collect(BaseDocument* doc, Int32 param);
+
+    void Flush();
+
+    /**
+     * Returns true if the active objects, tags and materials of
+     * *doc* are still the ones that were collected. This only
+     * compares the nodes and does not look at their descriptions,
+     * so it is a lot cheaper than collecting them again.
+     */
+    Bool IsCurrent(BaseDocument* doc) const;
+
+    Int32 GetCount() const {
+        return (Int32) m_entries.GetCount();
+    }
+
+    /**
+     * Stores the union of the items of all lists in *merged*, in
+     * the order in which they appear first, with the values of the
+     * first list that has the item. *differs* receives one flag per
+     * item of *merged* that is true if not all lists have the item
+     * with the same value. Returns false on a memory error.
+     */
+    Bool Merge(FloatlistData& merged, maxon::BaseArray<Bool>& differs) const;
+
+    /**
+     * Copies the values of the *count* items with the name IDs in
+     * *ids* from *merged* to every list that has an item with that
+     * name. An undo step is only added if *undo* is true, so that
+     * the changes of one slider drag can be undone at once.
+     */
+    Bool SetValues(const FloatlistData& merged, const Int32* ids, Int32 count, Bool undo);
+
+    /**
+     * Appends an item to every list that has no item of that name.
+     */
+    Bool Append(const String& name, Float value);
+
+    /**
+     * Removes the first item with the name ID from every list.
+     */
+    Bool Erase(Int32 id);
+
+private:
+
+    struct Entry {
+        BaseLink* link;
+        DescID id;
+    };
+
+    /**
+     * Calls *modify* with a copy of every list, and writes the copy
+     * back to its node if *modify* returns true.
+     */
+    template <typename Fn>
+    Bool Modify(Bool undo, Fn modify);
+
+    BaseDocument* m_doc;
+    maxon::BaseArray<Entry> m_entries;
+
+    /**
+     * The active nodes at the time of Collect(), only compared by
+     * IsCurrent() and never dereferenced.
+     */
+    maxon::BaseArray<BaseList2D*> m_active;
+
+};
+
+#endif /* CINEMA4DSDK_DATATYPE_FLOATLIST_SELECTION_H */
@@ -0,0 +1,444 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: memory mapped sidecar files for the values of large Floatlists
+ * level: expert
+ * tags: platform, file
+ * read-before: floatlist.cpp
+ */
+
+// The platform headers must come first, they are not happy with
+// some of the definitions in the Cinema 4D API.
+#if defined _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <stdio.h>
+    #include <time.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist-sidecar.h>
+
+/**
+ * The documents that are being saved, see BeginSave(). A document is
+ * in the array once for every call of BeginSave().
+ */
+static GeSpinlock g_savingLock;
+static maxon::BaseArray<BaseDocument*> g_saving;
+
+/**
+ * Layout of the sidecar file: a header of HEADER_SIZE bytes
+ * followed by the values in the byte order of the machine. The
+ * header size keeps the values aligned in the mapped view.
+ */
+struct SidecarHeader {
+    Char magic[4];
+    Int32 version;
+    Int32 count;
+    Int32 floatSize;
+
+    // Added without changing the version, files that were written
+    // before have a stamp of 0 as the rest of the header is cleared.
+    UInt64 stamp;
+};
+
+static const Char SIDECAR_MAGIC[4] = { 'F', 'L', 'S', 'C' };
+static const Int32 SIDECAR_VERSION = 1;
+static const Int HEADER_SIZE = 64;
+
+/**
+ * Returns a stamp that is not 0 and that no other sidecar gets,
+ * neither from this process nor from another one. The process ID,
+ * the time and a counter are mixed, so that the stamps also differ
+ * between machines that write to the same share.
+ */
+static UInt64 NewStamp() {
+    static GeSpinlock lock;
+    static UInt64 counter = 0;
+    lock.Lock();
+    UInt64 seed = ++counter;
+    lock.Unlock();
+
+#if defined _WIN32
+    FILETIME time;
+    GetSystemTimeAsFileTime(&time);
+    seed ^= ((UInt64) time.dwHighDateTime << 32 | time.dwLowDateTime) << 16;
+    seed ^= (UInt64) GetCurrentProcessId() << 40;
+#else
+    struct timespec time;
+    clock_gettime(CLOCK_REALTIME, &time);
+    seed ^= ((UInt64) time.tv_sec * 1000000000u + (UInt64) time.tv_nsec) << 16;
+    seed ^= (UInt64) getpid() << 40;
+#endif
+
+    // SplitMix64 finalizer, spreads the bits of the seed over the
+    // whole stamp.
+    UInt64 z = seed + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    return z != 0 ? z : 1;
+}
+
+#if defined _WIN32
+/**
+ * Returns *path* as a null terminated UTF-16 string for the wide
+ * character functions of Windows, to be freed with DeleteMem().
+ */
+static UInt16* GetWidePath(const Filename& path) {
+    String str = path.GetString();
+    Int length = str.GetLength();
+    UInt16* wide = NewMemClear(UInt16, length + 1);
+    if (wide) str.GetUcBlockNull(wide, length + 1);
+    return wide;
+}
+#endif
+
+/**
+ * Maps *path* copy-on-write. Stores the view and the handles that
+ * must be passed to UnmapFile() and returns the view, or nullptr
+ * on failure.
+ */
+static void* MapFile(const Filename& path, Int& size, void*& file, void*& mapping) {
+#if defined _WIN32
+    // No process ever writes to a sidecar that is mapped, files are
+    // only replaced as a whole (see ReplaceFileWith()). Sharing the
+    // file for deletion allows it to be renamed while it is mapped.
+    UInt16* wide = GetWidePath(path);
+    if (!wide) return nullptr;
+    HANDLE hFile = CreateFileW((LPCWSTR) wide, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                               nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    DeleteMem(wide);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart < HEADER_SIZE) {
+        CloseHandle(hFile);
+        return nullptr;
+    }
+
+    HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (!hMapping) {
+        CloseHandle(hFile);
+        return nullptr;
+    }
+
+    void* address = MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0);
+    if (!address) {
+        CloseHandle(hMapping);
+        CloseHandle(hFile);
+        return nullptr;
+    }
+
+    size = (Int) fileSize.QuadPart;
+    file = hFile;
+    mapping = hMapping;
+    return address;
+#else
+    Char* cpath = path.GetString().GetCStringCopy(STRINGENCODING_UTF8);
+    if (!cpath) return nullptr;
+    int fd = open(cpath, O_RDONLY);
+    DeleteMem(cpath);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < HEADER_SIZE) {
+        close(fd);
+        return nullptr;
+    }
+
+    // A private mapping allows writing to the pages without
+    // changing the file. The descriptor is not needed anymore
+    // once the file is mapped.
+    void* address = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED)
+        return nullptr;
+
+    size = (Int) st.st_size;
+    file = nullptr;
+    mapping = nullptr;
+    return address;
+#endif
+}
+
+static void UnmapFile(void* address, Int size, void* file, void* mapping) {
+    if (!address) return;
+#if defined _WIN32
+    UnmapViewOfFile(address);
+    CloseHandle((HANDLE) mapping);
+    CloseHandle((HANDLE) file);
+#else
+    munmap(address, size);
+#endif
+}
+
+/**
+ * Moves the file *from* to *to*, replacing *to* if it exists.
+ * Processes that have the old *to* mapped keep their view of it,
+ * the file is only removed from the disk once they unmap it.
+ */
+static Bool ReplaceFileWith(const Filename& to, const Filename& from) {
+#if defined _WIN32
+    // Windows can not replace a file that is open, but it can rename
+    // it. The old file is moved aside under a name that is not used
+    // yet (a previous version might still be mapped) and deleted,
+    // which Windows defers until the last view of it is closed.
+    Filename aside = to;
+    for (Int32 i=0; GeFExist(aside); i++)
+        aside.SetSuffix("old" + String::IntToString(i));
+
+    UInt16* wideTo = GetWidePath(to);
+    UInt16* wideFrom = GetWidePath(from);
+    UInt16* wideAside = GetWidePath(aside);
+    Bool ok = wideTo && wideFrom && wideAside;
+    Bool moved = false;
+    if (ok && GeFExist(to))
+        ok = moved = MoveFileW((LPCWSTR) wideTo, (LPCWSTR) wideAside) != 0;
+    if (ok)
+        ok = MoveFileW((LPCWSTR) wideFrom, (LPCWSTR) wideTo) != 0;
+    if (moved) {
+        if (ok)
+            DeleteFileW((LPCWSTR) wideAside);
+        else
+            MoveFileW((LPCWSTR) wideAside, (LPCWSTR) wideTo);
+    }
+    DeleteMem(wideTo);
+    DeleteMem(wideFrom);
+    DeleteMem(wideAside);
+    return ok;
+#else
+    // rename() replaces the file atomically, so there is no moment
+    // in which another process finds no file at all.
+    Char* cto = to.GetString().GetCStringCopy(STRINGENCODING_UTF8);
+    Char* cfrom = from.GetString().GetCStringCopy(STRINGENCODING_UTF8);
+    Bool ok = cto && cfrom && rename(cfrom, cto) == 0;
+    DeleteMem(cto);
+    DeleteMem(cfrom);
+    return ok;
+#endif
+}
+
+FloatlistSidecar::FloatlistSidecar()
+: m_count(0), m_stamp(0), m_values(nullptr), m_address(nullptr), m_size(0), m_file(nullptr),
+  m_mapping(nullptr), m_dirty(false) { }
+
+FloatlistSidecar::~FloatlistSidecar() {
+    UnmapFile(m_address, m_size, m_file, m_mapping);
+}
+
+FloatlistSidecar* FloatlistSidecar::Open(const Filename& path) {
+    FloatlistSidecar* sidecar = NewObj(FloatlistSidecar);
+    if (!sidecar) return nullptr;
+
+    sidecar->m_address = MapFile(path, sidecar->m_size, sidecar->m_file, sidecar->m_mapping);
+    if (!sidecar->m_address) {
+        DeleteObj(sidecar);
+        return nullptr;
+    }
+
+    SidecarHeader header;
+    CopyMem(sidecar->m_address, &header, sizeof(header));
+    Bool valid = header.magic[0] == SIDECAR_MAGIC[0] && header.magic[1] == SIDECAR_MAGIC[1]
+              && header.magic[2] == SIDECAR_MAGIC[2] && header.magic[3] == SIDECAR_MAGIC[3]
+              && header.version == SIDECAR_VERSION
+              && header.floatSize == (Int32) sizeof(Float)
+              && header.count >= 0
+              && sidecar->m_size >= HEADER_SIZE + (Int) header.count * (Int) sizeof(Float);
+    if (!valid) {
+        DeleteObj(sidecar);
+        return nullptr;
+    }
+
+    sidecar->m_path = path;
+    sidecar->m_count = header.count;
+    sidecar->m_stamp = header.stamp;
+    sidecar->m_values = (Float*) ((UChar*) sidecar->m_address + HEADER_SIZE);
+    return sidecar;
+}
+
+void FloatlistSidecar::Free(FloatlistSidecar*& sidecar) {
+    DeleteObj(sidecar);
+}
+
+void FloatlistSidecar::BeginSave(BaseDocument* doc) {
+    if (!doc) return;
+    g_savingLock.Lock();
+    if (!g_saving.Append(doc))
+        GePrint("Floatlist: out of memory, sidecars are not written");
+    g_savingLock.Unlock();
+}
+
+void FloatlistSidecar::EndSave(BaseDocument* doc) {
+    g_savingLock.Lock();
+    for (Int32 i=0; i < (Int32) g_saving.GetCount(); i++) {
+        if (g_saving[i] == doc) {
+            g_saving.Erase(i);
+            break;
+        }
+    }
+    g_savingLock.Unlock();
+}
+
+void FloatlistSidecar::DocumentInfo(const DocumentInfoData* info) {
+    if (!info) return;
+    switch (info->type) {
+        case MSG_DOCUMENTINFO_TYPE_SAVE_BEFORE:
+        case MSG_DOCUMENTINFO_TYPE_SAVEPROJECT_BEFORE:
+            BeginSave(info->doc);
+            break;
+        case MSG_DOCUMENTINFO_TYPE_SAVE_AFTER:
+        case MSG_DOCUMENTINFO_TYPE_SAVEPROJECT_AFTER:
+            EndSave(info->doc);
+            break;
+    }
+}
+
+Bool FloatlistSidecar::IsSaving(BaseDocument* doc) {
+    if (!doc) return false;
+    Bool saving = false;
+    g_savingLock.Lock();
+    for (Int32 i=0; !saving && i < (Int32) g_saving.GetCount(); i++)
+        saving = g_saving[i] == doc;
+    g_savingLock.Unlock();
+    return saving;
+}
+
+Bool FloatlistSidecar::Write(const Filename& path, const Float* values, Int32 count, UInt64* stamp) {
+    // The temporary file is named after the stamp, so that processes
+    // which save the same sidecar at the same time do not write into
+    // each others temporary file. The last rename wins.
+    UInt64 fileStamp;
+    Filename temp;
+    do {
+        fileStamp = NewStamp();
+        temp = Filename(path.GetString() + "." + String::HexToString(fileStamp, false) + ".tmp");
+    } while (GeFExist(temp));
+
+    AutoAlloc<BaseFile> file;
+    if (!file || !file->Open(temp, FILEOPEN_WRITE, FILEDIALOG_NONE))
+        return false;
+
+    UChar header[HEADER_SIZE];
+    ClearMem(header, HEADER_SIZE);
+    SidecarHeader* info = (SidecarHeader*) header;
+    CopyMem(SIDECAR_MAGIC, info->magic, sizeof(SIDECAR_MAGIC));
+    info->version = SIDECAR_VERSION;
+    info->count = count;
+    info->floatSize = sizeof(Float);
+    info->stamp = fileStamp;
+
+    Bool ok = file->WriteBytes(header, HEADER_SIZE)
+           && file->WriteBytes(values, (Int) count * sizeof(Float));
+    ok = file->Close() && ok;
+
+    // Replacing the file by renaming keeps the pages of a previous
+    // version valid for everyone who still has it mapped.
+    if (ok)
+        ok = ReplaceFileWith(path, temp);
+    if (!ok)
+        GeFKill(temp);
+    else if (stamp)
+        *stamp = fileStamp;
+    return ok;
+}
+
+void FloatlistSidecar::SetDirty(Int32 first, Int32 count) {
+    DebugAssert(first >= 0 && first + count <= m_count);
+    if (count > 0)
+        m_dirty = true;
+}
+
+/**
+ * Returns the stamp of the sidecar at *path*, 0 if the file can not
+ * be read or is not a sidecar.
+ */
+static UInt64 ReadStamp(const Filename& path) {
+    AutoAlloc<BaseFile> file;
+    if (!file || !file->Open(path, FILEOPEN_READ, FILEDIALOG_NONE))
+        return 0;
+    SidecarHeader header;
+    Bool ok = file->ReadBytes(&header, sizeof(header)) == (Int) sizeof(header);
+    file->Close();
+    if (!ok || header.magic[0] != SIDECAR_MAGIC[0] || header.magic[1] != SIDECAR_MAGIC[1]
+            || header.magic[2] != SIDECAR_MAGIC[2] || header.magic[3] != SIDECAR_MAGIC[3])
+        return 0;
+    return header.stamp;
+}
+
+Bool FloatlistSidecar::WriteBack() {
+    // Another process (or another document with a list that has the
+    // same sidecar) may have replaced the file since we mapped it.
+    // The values are written again in that case, our view still has
+    // the values of the file that we loaded.
+    if (!m_dirty && m_stamp != 0 && ReadStamp(m_path) == m_stamp)
+        return true;
+
+    // The file can be mapped by other processes (render jobs, a
+    // second Cinema) which must not see the pages change under
+    // them, so the modified values are never written in place. The
+    // whole column is written to a new file that replaces the old
+    // one. Our view keeps showing the same values, the modified
+    // pages are private to it.
+    if (!Write(m_path, m_values, m_count, &m_stamp))
+        return false;
+    m_dirty = false;
+    return true;
+}
+
+/**
+ * Marks the documents that are being saved for all lists in them,
+ * see FloatlistSidecar::BeginSave(). Every document has its own
+ * instance of the hook.
+ */
+class FloatlistSaveHook : public SceneHookData {
+
+    INSTANCEOF(FloatlistSaveHook, SceneHookData)
+
+public:
+
+    static NodeData* Alloc() {
+        return NewObj(FloatlistSaveHook);
+    }
+
+    virtual Bool Message(GeListNode* node, Int32 type, void* data) {
+        if (type == MSG_DOCUMENTINFO)
+            FloatlistSidecar::DocumentInfo(static_cast<DocumentInfoData*>(data));
+        return super::Message(node, type, data);
+    }
+
+};
+
+/**
+ * Called from Register_Datatype_Floatlist().
+ */
+Bool Register_FloatlistSidecar() {
+    return RegisterSceneHookPlugin(ID_FLOATLISTSAVEHOOK, "Floatlist Sidecars", 0,
+            FloatlistSaveHook::Alloc, 0, 0);
+}
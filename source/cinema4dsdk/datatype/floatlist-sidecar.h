@@ -0,0 +1,160 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CINEMA4DSDK_DATATYPE_FLOATLIST_SIDECAR_H
+#define CINEMA4DSDK_DATATYPE_FLOATLIST_SIDECAR_H
+
+#include <c4d.h>
+
+/**
+ * Plugin ID of the scene hook that marks the documents that are
+ * being saved, see FloatlistSidecar::BeginSave().
+ */
+static const Int32 ID_FLOATLISTSAVEHOOK = 1031960;
+
+/**
+ * A binary file next to the scene that holds the value column of
+ * a very large Floatlist, mapped into memory.
+ *
+ * The file is mapped copy-on-write: pages that are only read are
+ * shared with every other process that maps the same file, and
+ * modified pages are private to the process. A sidecar file is never
+ * modified in place, Write() and WriteBack() replace it with a new
+ * file, so the views of other processes stay valid.
+ */
+class FloatlistSidecar {
+
+public:
+
+    /**
+     * Maps the sidecar at *path*. Returns nullptr if the file does
+     * not exist, is not a valid sidecar or can not be mapped.
+     */
+    static FloatlistSidecar* Open(const Filename& path);
+
+    static void Free(FloatlistSidecar*& sidecar);
+
+    /**
+     * Lists only write their values to their sidecar while their
+     * document is being saved. All other writes (the clipboard,
+     * memory files, network transfers) store the values in the data,
+     * otherwise copying a list would rewrite files on the disk. The
+     * Floatlist scene hook (ID_FLOATLISTSAVEHOOK) passes the
+     * MSG_DOCUMENTINFO of every document on to DocumentInfo(), so
+     * nodes do not have to do anything. Calls can be nested, code
+     * that writes a document itself can mark the save as well.
+     */
+    static void BeginSave(BaseDocument* doc);
+
+    static void EndSave(BaseDocument* doc);
+
+    /**
+     * Calls BeginSave() or EndSave() for the messages that are sent
+     * before and after a document is saved, does nothing for all
+     * other messages.
+     */
+    static void DocumentInfo(const DocumentInfoData* info);
+
+    /**
+     * Returns true if *doc* is being saved. Thread-safe.
+     */
+    static Bool IsSaving(BaseDocument* doc);
+
+    /**
+     * Writes *count* values to a new sidecar at *path*, replacing
+     * an existing file. The file is written under a temporary name
+     * and renamed afterwards so that processes which still map the
+     * old file are not affected. Every file gets a new stamp which
+     * is stored in *stamp*, the scene keeps it to detect a sidecar
+     * that was replaced by another save. Returns false if the file
+     * could not be written.
+     */
+    static Bool Write(const Filename& path, const Float* values, Int32 count, UInt64* stamp=nullptr);
+
+    const Filename& GetPath() const {
+        return m_path;
+    }
+
+    Int32 GetCount() const {
+        return m_count;
+    }
+
+    /**
+     * The stamp that Write() gave the file, 0 for files that were
+     * written before sidecars had a stamp.
+     */
+    UInt64 GetStamp() const {
+        return m_stamp;
+    }
+
+    /**
+     * Returns the mapped values. They can be modified, but must be
+     * marked with SetDirty() to be written by WriteBack().
+     */
+    Float* GetValues() const {
+        return m_values;
+    }
+
+    /**
+     * Marks the values from *first* to *first + count* as modified.
+     */
+    void SetDirty(Int32 first, Int32 count);
+
+    Bool IsDirty() const {
+        return m_dirty;
+    }
+
+    /**
+     * Replaces the sidecar file with the current values if any of
+     * them were modified or the file was replaced since it was
+     * mapped, see Write(). Returns false if the file could not be
+     * written.
+     */
+    Bool WriteBack();
+
+private:
+
+    FloatlistSidecar();
+    ~FloatlistSidecar();
+
+    Filename m_path;
+    Int32 m_count;
+    UInt64 m_stamp;
+    Float* m_values;
+
+    /**
+     * The start and size of the mapped view and the platform
+     * handles of the mapping.
+     */
+    void* m_address;
+    Int m_size;
+    void* m_file;
+    void* m_mapping;
+
+    /**
+     * Set by SetDirty().
+     */
+    Bool m_dirty;
+
+};
+
+#endif /* CINEMA4DSDK_DATATYPE_FLOATLIST_SIDECAR_H */
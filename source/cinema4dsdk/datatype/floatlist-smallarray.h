@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CINEMA4DSDK_DATATYPE_FLOATLIST_SMALLARRAY_H
+#define CINEMA4DSDK_DATATYPE_FLOATLIST_SMALLARRAY_H
+
+#include <c4d.h>
+
+/**
+ * An array of plain values that keeps up to *N* elements inside the
+ * object and only allocates memory when it grows beyond that. The
+ * interface is the subset of maxon::BaseArray that the columns of
+ * the FloatlistData use. *T* must be copyable with CopyMem().
+ *
+ * Once the elements were moved to the heap they stay there until
+ * Flush() is called, so that a list that shrinks and grows again
+ * does not move its elements back and forth.
+ */
+template <typename T, Int N>
+class FloatlistSmallArray {
+
+public:
+
+    FloatlistSmallArray()
+    : m_ptr(m_inline), m_count(0), m_capacity(N) { }
+
+    ~FloatlistSmallArray() {
+        Flush();
+    }
+
+    Int GetCount() const {
+        return m_count;
+    }
+
+    Bool IsInline() const {
+        return m_ptr == m_inline;
+    }
+
+    /**
+     * Returns nullptr if the array is empty, like BaseArray.
+     */
+    T* GetFirst() {
+        return m_count > 0 ? m_ptr : nullptr;
+    }
+
+    const T* GetFirst() const {
+        return m_count > 0 ? m_ptr : nullptr;
+    }
+
+    T& operator [] (Int index) {
+        DebugAssert(index >= 0 && index < m_count);
+        return m_ptr[index];
+    }
+
+    const T& operator [] (Int index) const {
+        DebugAssert(index >= 0 && index < m_count);
+        return m_ptr[index];
+    }
+
+    /**
+     * Makes room for at least *count* elements without changing
+     * the number of elements. Returns false on a memory error.
+     */
+    Bool EnsureCapacity(Int count) {
+        if (count <= m_capacity)
+            return true;
+
+        // Grow by half of the capacity like BaseArray, so that a
+        // sequence of Append() calls is linear.
+        Int capacity = Max(count, m_capacity + m_capacity / 2);
+        T* ptr = NewMem(T, capacity);
+        if (ptr == nullptr)
+            return false;
+        if (m_count > 0)
+            CopyMem(m_ptr, ptr, m_count * sizeof(T));
+        if (!IsInline())
+            DeleteMem(m_ptr);
+        m_ptr = ptr;
+        m_capacity = capacity;
+        return true;
+    }
+
+    /**
+     * Sets the number of elements. New elements are not
+     * initialized. Returns false on a memory error.
+     */
+    Bool Resize(Int count) {
+        if (!EnsureCapacity(count))
+            return false;
+        m_count = count;
+        return true;
+    }
+
+    Bool Append(const T& value) {
+        if (m_count == m_capacity && !EnsureCapacity(m_count + 1))
+            return false;
+        m_ptr[m_count++] = value;
+        return true;
+    }
+
+    Bool Pop() {
+        if (m_count <= 0)
+            return false;
+        m_count--;
+        return true;
+    }
+
+    Bool Erase(Int index) {
+        if (index < 0 || index >= m_count)
+            return false;
+        m_count--;
+        for (Int i=index; i < m_count; i++)
+            m_ptr[i] = m_ptr[i + 1];
+        return true;
+    }
+
+    Bool CopyFrom(const FloatlistSmallArray& other) {
+        if (!Resize(other.m_count))
+            return false;
+        if (m_count > 0)
+            CopyMem(other.m_ptr, m_ptr, m_count * sizeof(T));
+        return true;
+    }
+
+    /**
+     * Removes all elements and releases the heap memory.
+     */
+    void Flush() {
+        if (!IsInline())
+            DeleteMem(m_ptr);
+        m_ptr = m_inline;
+        m_count = 0;
+        m_capacity = N;
+    }
+
+private:
+
+    FloatlistSmallArray(const FloatlistSmallArray&);
+    FloatlistSmallArray& operator = (const FloatlistSmallArray&);
+
+    T* m_ptr;
+    Int m_count;
+    Int m_capacity;
+    T m_inline[N];
+
+};
+
+#endif /* CINEMA4DSDK_DATATYPE_FLOATLIST_SMALLARRAY_H */
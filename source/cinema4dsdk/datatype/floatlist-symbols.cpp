@@ -0,0 +1,430 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: the interned name table of the Floatlist datatype
+ * level: expert
+ * read-before: floatlist.cpp
+ */
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist-symbols.h>
+
+/**
+ * The names are stored in pages of fixed size that are never
+ * moved in memory, so Get() can hand out references without
+ * taking the lock.
+ */
+static const Int32 PAGE_BITS = 10;
+static const Int32 PAGE_SIZE = 1 << PAGE_BITS;
+static const Int32 PAGE_MASK = PAGE_SIZE - 1;
+static const Int32 MAX_PAGES = 4096;
+
+/**
+ * A slot whose name was released keeps its bytes, so that a new
+ * name that fits can re-use them. *capacities* is the size of the
+ * bytes that a slot owns.
+ */
+struct SymbolPage {
+    String names[PAGE_SIZE];
+    FloatlistSymbols::Utf8 bytes[PAGE_SIZE];
+    Int32 capacities[PAGE_SIZE];
+    UInt32 hashes[PAGE_SIZE];
+    Int32 refs[PAGE_SIZE];
+    UInt32 serials[PAGE_SIZE];
+};
+
+static GeSpinlock g_lock;
+static SymbolPage* g_pages[MAX_PAGES];
+
+/**
+ * *g_count* IDs were handed out so far, *g_live* of them are in use.
+ * The others are in *g_free* and are re-used before a new ID is
+ * taken.
+ */
+static Int32 g_count = 0;
+static Int32 g_live = 0;
+static maxon::BaseArray<Int32> g_free;
+
+/**
+ * Open addressing table with linear probing. Each slot holds
+ * the ID of a name plus one, zero marks a free slot. The table
+ * is kept at most half full.
+ */
+static Int32* g_slots = nullptr;
+static Int32 g_size = 0;
+
+/**
+ * The UTF-8 bytes of all names are bump allocated from blocks of
+ * ARENA_BLOCK bytes, which are only released all at once by
+ * Free(). Looking up names compares these bytes, so no String
+ * has to be created for a name that is already known.
+ */
+static const Int ARENA_BLOCK = 64 * 1024;
+static maxon::BaseArray<Char*> g_blocks;
+static Char* g_arenaPtr = nullptr;
+static Int g_arenaLeft = 0;
+
+/**
+ * Names that are converted to UTF-8 on the stack, longer names
+ * need a temporary allocation.
+ */
+static const Int32 STACK_NAME = 256;
+
+static const Char* ArenaCopy(const Char* bytes, Int32 length) {
+    if (length > g_arenaLeft) {
+        // Long names get a block of their own, so that the rest of
+        // the current block is not wasted.
+        Bool own = length > ARENA_BLOCK / 4;
+        Char* block = NewMem(Char, own ? length : ARENA_BLOCK);
+        if (block == nullptr)
+            return nullptr;
+        if (!g_blocks.Append(block)) {
+            DeleteMem(block);
+            return nullptr;
+        }
+        if (own) {
+            CopyMem(bytes, block, length);
+            return block;
+        }
+        g_arenaPtr = block;
+        g_arenaLeft = ARENA_BLOCK;
+    }
+
+    Char* dst = g_arenaPtr;
+    g_arenaPtr += length;
+    g_arenaLeft -= length;
+    if (length > 0)
+        CopyMem(bytes, dst, length);
+    return dst;
+}
+
+static UInt32 HashName(const Char* bytes, Int32 length) {
+    // FNV-1a over the UTF-8 bytes of the name.
+    UInt32 hash = 2166136261u;
+    for (Int32 i=0; i < length; i++) {
+        hash ^= (UChar) bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static Bool EqualBytes(const FloatlistSymbols::Utf8& a, const Char* bytes, Int32 length) {
+    if (a.length != length)
+        return false;
+    for (Int32 i=0; i < length; i++) {
+        if (a.bytes[i] != bytes[i])
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Converts *name* to UTF-8 in *buffer* of STACK_NAME bytes or, if
+ * it does not fit, in newly allocated memory. Returns nullptr on a
+ * memory error. The result must be released with ReleaseUtf8().
+ */
+static Char* ToUtf8(const String& name, Char* buffer, Int32& length) {
+    length = (Int32) name.GetCStringLen(STRINGENCODING_UTF8);
+    Char* bytes = length < STACK_NAME ? buffer : NewMem(Char, length + 1);
+    if (bytes != nullptr)
+        name.GetCString(bytes, length + 1, STRINGENCODING_UTF8);
+    return bytes;
+}
+
+static void ReleaseUtf8(Char* bytes, Char* buffer) {
+    if (bytes != buffer)
+        DeleteMem(bytes);
+}
+
+static Int32 Lookup(const Char* bytes, Int32 length, UInt32 hash) {
+    if (g_size == 0)
+        return NOTOK;
+
+    Int32 mask = g_size - 1;
+    for (Int32 i = hash & mask; g_slots[i] != 0; i = (i + 1) & mask) {
+        Int32 id = g_slots[i] - 1;
+        const SymbolPage* page = g_pages[id >> PAGE_BITS];
+        if (page->hashes[id & PAGE_MASK] == hash && EqualBytes(page->bytes[id & PAGE_MASK], bytes, length))
+            return id;
+    }
+    return NOTOK;
+}
+
+static void Place(Int32* slots, Int32 size, Int32 id, UInt32 hash) {
+    Int32 mask = size - 1;
+    Int32 i = hash & mask;
+    while (slots[i] != 0)
+        i = (i + 1) & mask;
+    slots[i] = id + 1;
+}
+
+static UInt32 GetHash(Int32 id) {
+    return g_pages[id >> PAGE_BITS]->hashes[id & PAGE_MASK];
+}
+
+/**
+ * Removes *id* from the hash table. The following entries of the
+ * probe sequence are shifted back into the gap unless they are
+ * already in their home slot range, so that no tombstones are
+ * required (the same as in the index of the FloatlistData).
+ */
+static void Unplace(Int32 id) {
+    Int32 mask = g_size - 1;
+    Int32 i = GetHash(id) & mask;
+    while (g_slots[i] != id + 1) {
+        DebugAssert(g_slots[i] != 0);
+        i = (i + 1) & mask;
+    }
+
+    Int32 j = i;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (g_slots[j] == 0)
+            break;
+        Int32 home = GetHash(g_slots[j] - 1) & mask;
+        Bool inRange = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (inRange)
+            continue;
+        g_slots[i] = g_slots[j];
+        i = j;
+    }
+    g_slots[i] = 0;
+}
+
+static Bool Grow() {
+    if ((g_live + 1) * 2 <= g_size)
+        return true;
+
+    Int32 size = g_size > 0 ? g_size * 2 : 256;
+    Int32* slots = NewMemClear(Int32, size);
+    if (slots == nullptr)
+        return false;
+
+    for (Int32 id=0; id < g_count; id++) {
+        if (g_pages[id >> PAGE_BITS]->refs[id & PAGE_MASK] > 0)
+            Place(slots, size, id, GetHash(id));
+    }
+
+    DeleteMem(g_slots);
+    g_slots = slots;
+    g_size = size;
+    return true;
+}
+
+/**
+ * Returns the ID of the name with a new reference, adding it if it
+ * is not in the table yet. *name* is the String of the name if the
+ * caller has it, otherwise it is created from the bytes. Must be
+ * called with the lock held.
+ */
+static Int32 InternLocked(const Char* bytes, Int32 length, const String* name) {
+    UInt32 hash = HashName(bytes, length);
+    Int32 id = Lookup(bytes, length, hash);
+    if (id != NOTOK) {
+        g_pages[id >> PAGE_BITS]->refs[id & PAGE_MASK]++;
+        return id;
+    }
+
+    // Released IDs are re-used first. Otherwise make sure there is
+    // room for the new entry in the page it falls into.
+    if (!Grow())
+        return NOTOK;
+    Bool reuse = g_free.GetCount() > 0;
+    id = reuse ? g_free[g_free.GetCount() - 1] : g_count;
+    Int32 pageIndex = id >> PAGE_BITS;
+    if (pageIndex >= MAX_PAGES)
+        return NOTOK;
+    if (g_pages[pageIndex] == nullptr) {
+        g_pages[pageIndex] = NewObjClear(SymbolPage);
+        if (g_pages[pageIndex] == nullptr)
+            return NOTOK;
+    }
+
+    // The bytes of a released name are overwritten if the new name
+    // fits, they are not used by anyone anymore.
+    SymbolPage* page = g_pages[pageIndex];
+    Int32 slot = id & PAGE_MASK;
+    const Char* copy;
+    if (reuse && length <= page->capacities[slot]) {
+        copy = page->bytes[slot].bytes;
+        if (length > 0)
+            CopyMem(bytes, const_cast<Char*>(copy), length);
+    }
+    else {
+        copy = ArenaCopy(bytes, length);
+        if (copy == nullptr)
+            return NOTOK;
+        page->capacities[slot] = length;
+    }
+
+    if (reuse)
+        g_free.Pop();
+    else
+        g_count++;
+    g_live++;
+
+    if (name != nullptr)
+        page->names[slot] = *name;
+    else
+        page->names[slot].SetCString(bytes, length, STRINGENCODING_UTF8);
+    page->bytes[slot].bytes = copy;
+    page->bytes[slot].length = length;
+    page->hashes[slot] = hash;
+    page->refs[slot] = 1;
+    page->serials[slot]++;
+    Place(g_slots, g_size, id, hash);
+    return id;
+}
+
+/**
+ * Drops *count* references to *id* and removes the name if they
+ * were the last ones. Must be called with the lock held.
+ */
+static void ReleaseLocked(Int32 id, Int32 count) {
+    DebugAssert(id >= 0 && id < g_count);
+    SymbolPage* page = g_pages[id >> PAGE_BITS];
+    Int32 slot = id & PAGE_MASK;
+    DebugAssert(page->refs[slot] >= count);
+    page->refs[slot] -= count;
+    if (page->refs[slot] > 0)
+        return;
+
+    // The ID can only be re-used if it can be remembered. If the
+    // free list can not grow, the slot stays empty until Free().
+    Unplace(id);
+    page->names[slot] = String();
+    page->bytes[slot].length = 0;
+    g_live--;
+    g_free.Append(id);
+}
+
+Int32 FloatlistSymbols::Intern(const String& name) {
+    Char buffer[STACK_NAME];
+    Int32 length;
+    Char* bytes = ToUtf8(name, buffer, length);
+    if (bytes == nullptr)
+        return NOTOK;
+
+    g_lock.Lock();
+    Int32 id = InternLocked(bytes, length, &name);
+    g_lock.Unlock();
+
+    ReleaseUtf8(bytes, buffer);
+    return id;
+}
+
+Bool FloatlistSymbols::Intern(const Utf8* names, Int32 count, Int32* ids) {
+    Int32 done = 0;
+    g_lock.Lock();
+    while (done < count) {
+        ids[done] = InternLocked(names[done].bytes, names[done].length, nullptr);
+        if (ids[done] == NOTOK)
+            break;
+        done++;
+    }
+
+    // All or nothing, so that the caller does not have to find out
+    // which names it holds a reference to.
+    if (done < count) {
+        for (Int32 i=0; i < done; i++)
+            ReleaseLocked(ids[i], 1);
+    }
+    g_lock.Unlock();
+    return done == count;
+}
+
+void FloatlistSymbols::Retain(const Int32* ids, Int32 count) {
+    if (count <= 0)
+        return;
+    g_lock.Lock();
+    for (Int32 i=0; i < count; i++) {
+        DebugAssert(ids[i] >= 0 && ids[i] < g_count);
+        g_pages[ids[i] >> PAGE_BITS]->refs[ids[i] & PAGE_MASK]++;
+    }
+    g_lock.Unlock();
+}
+
+void FloatlistSymbols::Release(const Int32* ids, Int32 count) {
+    if (count <= 0)
+        return;
+    g_lock.Lock();
+    for (Int32 i=0; i < count; i++)
+        ReleaseLocked(ids[i], 1);
+    g_lock.Unlock();
+}
+
+Int32 FloatlistSymbols::Find(const String& name) {
+    Char buffer[STACK_NAME];
+    Int32 length;
+    Char* bytes = ToUtf8(name, buffer, length);
+    if (bytes == nullptr)
+        return NOTOK;
+
+    UInt32 hash = HashName(bytes, length);
+    g_lock.Lock();
+    Int32 id = Lookup(bytes, length, hash);
+    g_lock.Unlock();
+
+    ReleaseUtf8(bytes, buffer);
+    return id;
+}
+
+const String& FloatlistSymbols::Get(Int32 id) {
+    DebugAssert(id >= 0 && id < g_count);
+    return g_pages[id >> PAGE_BITS]->names[id & PAGE_MASK];
+}
+
+FloatlistSymbols::Utf8 FloatlistSymbols::GetUtf8(Int32 id) {
+    DebugAssert(id >= 0 && id < g_count);
+    return g_pages[id >> PAGE_BITS]->bytes[id & PAGE_MASK];
+}
+
+UInt32 FloatlistSymbols::GetSerial(Int32 id) {
+    DebugAssert(id >= 0 && id < g_count);
+    return g_pages[id >> PAGE_BITS]->serials[id & PAGE_MASK];
+}
+
+Int32 FloatlistSymbols::GetCount() {
+    return g_count;
+}
+
+Int32 FloatlistSymbols::GetLiveCount() {
+    return g_live;
+}
+
+void FloatlistSymbols::Free() {
+    g_lock.Lock();
+    for (Int32 i=0; i < MAX_PAGES; i++) {
+        if (g_pages[i] != nullptr)
+            DeleteObj(g_pages[i]);
+    }
+    for (Int32 i=0; i < g_blocks.GetCount(); i++)
+        DeleteMem(g_blocks[i]);
+    g_blocks.Flush();
+    g_arenaPtr = nullptr;
+    g_arenaLeft = 0;
+    DeleteMem(g_slots);
+    g_free.Flush();
+    g_size = 0;
+    g_count = 0;
+    g_live = 0;
+    g_lock.Unlock();
+}
@@ -0,0 +1,137 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CINEMA4DSDK_DATATYPE_FLOATLIST_SYMBOLS_H
+#define CINEMA4DSDK_DATATYPE_FLOATLIST_SYMBOLS_H
+
+#include <c4d.h>
+
+/**
+ * A process-wide table of interned item names. Every distinct
+ * name is stored exactly once and identified by a stable integer
+ * ID, so the FloatlistData can store and compare Int32 IDs instead
+ * of String objects.
+ *
+ * Every ID is reference counted. Intern() returns a reference that
+ * the caller owns, and everything that stores an ID (the lists,
+ * the keys of tracks) holds a reference of its own with Retain()
+ * and gives it back with Release(). When the last reference is
+ * released, the name is removed and its ID is handed out again for
+ * another name, so the table only has to hold the names that are
+ * currently in use. An ID must only be passed to the functions
+ * below while a reference to it is held.
+ */
+class FloatlistSymbols {
+
+public:
+
+    /**
+     * A name as UTF-8 bytes without a terminating null byte.
+     */
+    struct Utf8 {
+        const Char* bytes;
+        Int32 length;
+    };
+
+    /**
+     * Returns the ID of *name* with a new reference, adding the
+     * name to the table if it is not already in it. Returns NOTOK
+     * if the memory for a new entry could not be allocated or the
+     * table is full. Thread-safe.
+     */
+    static Int32 Intern(const String& name);
+
+    /**
+     * Interns *count* names given as UTF-8 and stores their IDs in
+     * *ids*, with a reference each. The table is locked once for
+     * all names and no String is created for names that are already
+     * known, which makes this the fast path for reading lists from
+     * files. Returns false if the memory for a new entry could not
+     * be allocated or the table is full, no reference is taken in
+     * that case.
+     */
+    static Bool Intern(const Utf8* names, Int32 count, Int32* ids);
+
+    /**
+     * Adds or removes one reference to each of the *count* IDs.
+     * Thread-safe.
+     */
+    static void Retain(const Int32* ids, Int32 count);
+    static void Release(const Int32* ids, Int32 count);
+
+    static void Retain(Int32 id) {
+        Retain(&id, 1);
+    }
+
+    static void Release(Int32 id) {
+        Release(&id, 1);
+    }
+
+    /**
+     * Returns the ID of *name* or NOTOK if the name is not in
+     * the table (and can therefore not be in any list). No
+     * reference is taken, the ID can only be compared with IDs
+     * that the caller holds a reference to. Thread-safe.
+     */
+    static Int32 Find(const String& name);
+
+    /**
+     * Returns a number that changes whenever the ID is handed out
+     * for another name. Caches that are indexed by ID but do not
+     * hold a reference use it to detect that an ID was re-used.
+     */
+    static UInt32 GetSerial(Int32 id);
+
+    /**
+     * Returns the name for an ID returned by Intern(). The
+     * reference stays valid until Free() is called. This does
+     * not lock and is cheap enough to be called per item.
+     */
+    static const String& Get(Int32 id);
+
+    /**
+     * Returns the name for an ID as UTF-8 bytes, the same rules
+     * as for Get() apply.
+     */
+    static Utf8 GetUtf8(Int32 id);
+
+    /**
+     * Returns an upper bound of the IDs, all IDs are smaller than
+     * this. IDs are small numbers, so they can be used as indices
+     * into arrays of this size.
+     */
+    static Int32 GetCount();
+
+    /**
+     * Returns the number of names in the table.
+     */
+    static Int32 GetLiveCount();
+
+    /**
+     * Releases all memory of the table. Must only be called
+     * when no FloatlistData is alive anymore.
+     */
+    static void Free();
+
+};
+
+#endif /* CINEMA4DSDK_DATATYPE_FLOATLIST_SYMBOLS_H */
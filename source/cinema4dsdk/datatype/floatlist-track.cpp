@@ -0,0 +1,376 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: a track that animates all items of a Floatlist at once
+ * level: expert
+ * tags: animation, track
+ * read-before: floatlist.cpp
+ */
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist-track.h>
+#include <cinema4dsdk/datatype/floatlist-codec.h>
+
+Int32 FloatlistKeyTable::UpperKey(Float time) const {
+    Int32 lo = 0;
+    Int32 hi = GetKeyCount();
+    while (lo < hi) {
+        Int32 mid = (lo + hi) / 2;
+        if (m_times[mid] <= time)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+Bool FloatlistKeyTable::SetKey(Float time, const FloatlistData& list) {
+    Int32 oldChannels = GetChannelCount();
+    Int32 keys = GetKeyCount();
+
+    // The current values of all channels at the time, so that the
+    // channels that are not in the list keep their value.
+    maxon::BaseArray<Float> row;
+    if (!row.Resize(oldChannels))
+        return false;
+    if (oldChannels > 0)
+        Evaluate(time, row.GetFirst());
+
+    // The channel of every name ID, name IDs are small consecutive
+    // numbers so they can be used as indices.
+    maxon::BaseArray<Int32> channelOf;
+    if (!channelOf.Resize(FloatlistSymbols::GetCount()))
+        return false;
+    for (Int32 i=0; i < (Int32) channelOf.GetCount(); i++)
+        channelOf[i] = NOTOK;
+    for (Int32 c=0; c < oldChannels; c++)
+        channelOf[m_channels[c]] = c;
+
+    // Add a channel for every new name.
+    Int32 count = list.GetCount();
+    const Int32* ids = list.GetNameIdsR();
+    const Float* values = list.GetValuesR();
+    maxon::BaseArray<Int32> added;
+    for (Int32 i=0; i < count; i++) {
+        if (channelOf[ids[i]] != NOTOK)
+            continue;
+        channelOf[ids[i]] = oldChannels + (Int32) added.GetCount();
+        if (added.Append(i) == nullptr)
+            return false;
+    }
+
+    Int32 channels = oldChannels + (Int32) added.GetCount();
+    if (!row.Resize(channels))
+        return false;
+    for (Int32 i=0; i < count; i++)
+        row[channelOf[ids[i]]] = values[i];
+
+    // Replace the key at the same time or insert a new one.
+    Int32 key = UpperKey(time);
+    Bool replace = key > 0 && m_times[key - 1] == time;
+    if (replace)
+        key--;
+
+    if (replace && channels == oldChannels) {
+        CopyMem(row.GetFirst(), m_values.GetFirst() + (Int) key * channels, channels * sizeof(Float));
+        return true;
+    }
+
+    // Build the new columns completely before swapping them in, so
+    // that the table stays unchanged if an allocation fails. The new
+    // channels have the value of their item in all other keys.
+    Int32 newKeys = replace ? keys : keys + 1;
+    maxon::BaseArray<Int32> newChannels;
+    maxon::BaseArray<Float> newTimes, newValues;
+    if (!newChannels.Resize(channels) || !newTimes.Resize(newKeys)
+            || !newValues.Resize((Int) newKeys * channels))
+        return false;
+
+    for (Int32 c=0; c < oldChannels; c++)
+        newChannels[c] = m_channels[c];
+    for (Int32 a=0; a < (Int32) added.GetCount(); a++)
+        newChannels[oldChannels + a] = ids[added[a]];
+
+    for (Int32 k=0; k < newKeys; k++) {
+        Float* dst = newValues.GetFirst() + (Int) k * channels;
+        if (k == key) {
+            newTimes[k] = time;
+            CopyMem(row.GetFirst(), dst, channels * sizeof(Float));
+            continue;
+        }
+        Int32 src = (!replace && k > key) ? k - 1 : k;
+        newTimes[k] = m_times[src];
+        if (oldChannels > 0)
+            CopyMem(GetKeyValues(src), dst, oldChannels * sizeof(Float));
+        for (Int32 a=0; a < (Int32) added.GetCount(); a++)
+            dst[oldChannels + a] = values[added[a]];
+    }
+
+    for (Int32 a=0; a < (Int32) added.GetCount(); a++)
+        FloatlistSymbols::Retain(ids[added[a]]);
+    m_channels.SwapWith(newChannels);
+    m_times.SwapWith(newTimes);
+    m_values.SwapWith(newValues);
+    return true;
+}
+
+void FloatlistKeyTable::RemoveKey(Int32 key) {
+    Int32 channels = GetChannelCount();
+    m_times.Erase(key);
+    m_values.Erase((Int) key * channels, channels);
+}
+
+void FloatlistKeyTable::Flush() {
+    FloatlistSymbols::Release(m_channels.GetFirst(), GetChannelCount());
+    m_channels.Flush();
+    m_times.Flush();
+    m_values.Flush();
+}
+
+void FloatlistKeyTable::Evaluate(Float time, Float* out) const {
+    Int32 channels = GetChannelCount();
+    Int32 keys = GetKeyCount();
+    if (keys == 0) {
+        for (Int32 c=0; c < channels; c++)
+            out[c] = 0.0;
+        return;
+    }
+
+    Int32 key = UpperKey(time);
+    if (key == 0 || key == keys) {
+        CopyMem(GetKeyValues(key == 0 ? 0 : keys - 1), out, channels * sizeof(Float));
+        return;
+    }
+
+    // One pass over two contiguous rows, which the compiler can
+    // vectorize.
+    const Float* a = GetKeyValues(key - 1);
+    const Float* b = GetKeyValues(key);
+    Float t0 = m_times[key - 1];
+    Float f = (time - t0) / (m_times[key] - t0);
+    for (Int32 c=0; c < channels; c++)
+        out[c] = a[c] + (b[c] - a[c]) * f;
+}
+
+Bool FloatlistKeyTable::Apply(Float time, FloatlistData& list) const {
+    Int32 channels = GetChannelCount();
+    maxon::BaseArray<Float> row;
+    if (channels == 0)
+        return true;
+    if (!row.Resize(channels))
+        return false;
+    Evaluate(time, row.GetFirst());
+
+    // Scatter the values to the items, the list is only detached
+    // once for all of them.
+    Float* values = list.GetValuesW();
+    if (values == nullptr)
+        return list.GetCount() == 0;
+    for (Int32 c=0; c < channels; c++) {
+        Int32 index = list.FindNameId(m_channels[c]);
+        if (index != NOTOK)
+            values[index] = row[c];
+    }
+    return true;
+}
+
+Bool FloatlistKeyTable::CopyFrom(const FloatlistKeyTable& other) {
+    maxon::BaseArray<Int32> channels;
+    if (!channels.CopyFrom(other.m_channels))
+        return false;
+    Flush();
+    m_channels.SwapWith(channels);
+    FloatlistSymbols::Retain(m_channels.GetFirst(), GetChannelCount());
+    return m_times.CopyFrom(other.m_times) && m_values.CopyFrom(other.m_values);
+}
+
+Bool FloatlistKeyTable::Write(HyperFile* hf) const {
+    Int32 channels = GetChannelCount();
+    Int32 keys = GetKeyCount();
+    if (!hf->WriteInt32(channels)) return false;
+    if (!hf->WriteInt32(keys)) return false;
+    if (!hf->WriteInt32(sizeof(Float))) return false;
+    if (channels == 0 || keys == 0) return true;
+
+    // The channel names are stored the same way as the names of
+    // a Floatlist, the IDs are only valid in this session.
+    maxon::BaseArray<Char> names;
+    if (!FloatlistCodec::EncodeNames(m_channels.GetFirst(), channels, names))
+        return false;
+    return hf->WriteMemory(names.GetFirst(), names.GetCount())
+        && hf->WriteMemory(m_times.GetFirst(), keys * sizeof(Float))
+        && hf->WriteMemory(m_values.GetFirst(), (Int) keys * channels * sizeof(Float));
+}
+
+Bool FloatlistKeyTable::Read(HyperFile* hf) {
+    Flush();
+    Int32 channels, keys, floatSize;
+    if (!hf->ReadInt32(&channels)) return false;
+    if (!hf->ReadInt32(&keys)) return false;
+    if (!hf->ReadInt32(&floatSize)) return false;
+    if (channels < 0 || keys < 0 || floatSize != sizeof(Float)) return false;
+    if (channels == 0 || keys == 0) return true;
+
+    void* names = nullptr;
+    void* times = nullptr;
+    void* values = nullptr;
+    Int namesSize = 0, timesSize = 0, valuesSize = 0;
+    Bool ok = hf->ReadMemory(&names, &namesSize)
+           && hf->ReadMemory(&times, &timesSize)
+           && hf->ReadMemory(&values, &valuesSize)
+           && timesSize == keys * (Int) sizeof(Float)
+           && valuesSize == (Int) keys * channels * (Int) sizeof(Float)
+           && m_channels.Resize(channels) && m_times.Resize(keys)
+           && m_values.Resize((Int) keys * channels)
+           && FloatlistCodec::DecodeNames(static_cast<const Char*>(names), namesSize,
+                    m_channels.GetFirst(), channels);
+    if (ok) {
+        CopyMem(times, m_times.GetFirst(), timesSize);
+        CopyMem(values, m_values.GetFirst(), valuesSize);
+    }
+    else {
+        // DecodeNames() is the last step, so the channels do not
+        // hold any references if reading failed.
+        m_channels.Flush();
+        Flush();
+    }
+
+    DeleteMem(names);
+    DeleteMem(times);
+    DeleteMem(values);
+    return ok;
+}
+
+/**
+ * The track plugin. The track itself is identified by its own type
+ * (like the PLA or sound track), so it stores the ID of the
+ * parameter it animates.
+ */
+class FloatlistTrackData : public CTrackData {
+
+    INSTANCEOF(FloatlistTrackData, CTrackData)
+
+public:
+
+    FloatlistKeyTable keys;
+    DescID target;
+
+    static NodeData* Alloc() {
+        return NewObj(FloatlistTrackData);
+    }
+
+    // CTrackData
+
+    virtual Bool Animate(CTrack* track, const CAnimInfo* info, Bool* chg, void* data) {
+        if (info->op == nullptr || target.GetDepth() == 0 || keys.GetKeyCount() == 0)
+            return true;
+
+        // One parameter access for all items instead of one per
+        // subchannel.
+        GeData value;
+        if (!info->op->GetParameter(target, value, DESCFLAGS_GET_0))
+            return true;
+        const FloatlistData* list = FloatlistData::Get(value);
+        if (list == nullptr)
+            return true;
+
+        FloatlistData copy(*list);
+        if (!keys.Apply(info->xtime, copy))
+            return false;
+        info->op->SetParameter(target, GeData(CUSTOMDATATYPE_FLOATLIST, copy), DESCFLAGS_SET_0);
+        if (chg) *chg = true;
+        return true;
+    }
+
+    // NodeData
+
+    virtual Bool Read(GeListNode* node, HyperFile* hf, Int32 level) {
+        return target.Read(hf) && keys.Read(hf);
+    }
+
+    virtual Bool Write(GeListNode* node, HyperFile* hf) {
+        return target.Write(hf) && keys.Write(hf);
+    }
+
+    virtual Bool CopyTo(NodeData* dest_, GeListNode* snode, GeListNode* dnode,
+                        COPYFLAGS flags, AliasTrans* trn)
+    {
+        auto dest = static_cast<FloatlistTrackData*>(dest_);
+        dest->target = target;
+        return dest->keys.CopyFrom(keys) && super::CopyTo(dest_, snode, dnode, flags, trn);
+    }
+
+};
+
+static FloatlistTrackData* GetTrackData(CTrack* track) {
+    if (track == nullptr || track->GetType() != ID_FLOATLISTTRACK)
+        return nullptr;
+    return static_cast<FloatlistTrackData*>(track->GetNodeData());
+}
+
+CTrack* FloatlistTrack::Find(BaseList2D* node, const DescID& id, Bool create) {
+    if (node == nullptr)
+        return nullptr;
+
+    for (CTrack* track = node->GetFirstCTrack(); track; track = track->GetNext()) {
+        FloatlistTrackData* data = GetTrackData(track);
+        if (data != nullptr && data->target == id)
+            return track;
+    }
+
+    if (!create)
+        return nullptr;
+
+    CTrack* track = CTrack::Alloc(node, DescID(DescLevel(ID_FLOATLISTTRACK, ID_FLOATLISTTRACK, 0)));
+    FloatlistTrackData* data = GetTrackData(track);
+    if (data == nullptr) {
+        CTrack::Free(track);
+        return nullptr;
+    }
+    data->target = id;
+    node->InsertTrackSorted(track);
+    return track;
+}
+
+FloatlistKeyTable* FloatlistTrack::GetKeys(CTrack* track) {
+    FloatlistTrackData* data = GetTrackData(track);
+    return data ? &data->keys : nullptr;
+}
+
+Bool FloatlistTrack::RecordKey(BaseList2D* node, const DescID& id, const BaseTime& time) {
+    GeData value;
+    if (node == nullptr || !node->GetParameter(id, value, DESCFLAGS_GET_0))
+        return false;
+    const FloatlistData* list = FloatlistData::Get(value);
+    if (list == nullptr)
+        return false;
+
+    FloatlistKeyTable* keys = GetKeys(Find(node, id, true));
+    return keys != nullptr && keys->SetKey(time.Get(), *list);
+}
+
+/**
+ * Called from Register_Datatype_Floatlist().
+ */
+Bool Register_FloatlistTrack() {
+    return RegisterCTrackPlugin(ID_FLOATLISTTRACK, "Floatlist", 0,
+            FloatlistTrackData::Alloc, "", 0);
+}
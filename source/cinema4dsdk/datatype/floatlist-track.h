@@ -0,0 +1,177 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CINEMA4DSDK_DATATYPE_FLOATLIST_TRACK_H
+#define CINEMA4DSDK_DATATYPE_FLOATLIST_TRACK_H
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist.h>
+
+/**
+ * Plugin ID of the Floatlist animation track. Plugin IDs are unique
+ * across all plugin types, so the track has its own registered ID.
+ */
+static const Int32 ID_FLOATLISTTRACK = 1031957;
+
+/**
+ * The keys of a Floatlist track. Each channel animates the item of
+ * one name, and every key stores a value for every channel. The
+ * values are stored key by key in one block (structure of arrays
+ * with the times in a separate column), so evaluating all channels
+ * at a time is a single linear interpolation between two
+ * contiguous rows.
+ */
+class FloatlistKeyTable {
+
+public:
+
+    FloatlistKeyTable() : m_channels(), m_times(), m_values() { }
+
+    ~FloatlistKeyTable() {
+        Flush();
+    }
+
+    Int32 GetChannelCount() const {
+        return (Int32) m_channels.GetCount();
+    }
+
+    /**
+     * Returns the name IDs of the channels. The table holds a
+     * reference to each of them.
+     */
+    const Int32* GetChannelIds() const {
+        return m_channels.GetFirst();
+    }
+
+    Int32 GetKeyCount() const {
+        return (Int32) m_times.GetCount();
+    }
+
+    /**
+     * Returns the time of a key in seconds. The keys are sorted
+     * by time.
+     */
+    Float GetKeyTime(Int32 key) const {
+        return m_times[key];
+    }
+
+    /**
+     * Returns the GetChannelCount() values of a key.
+     */
+    const Float* GetKeyValues(Int32 key) const {
+        return m_values.GetFirst() + (Int) key * GetChannelCount();
+    }
+
+    /**
+     * Stores the values of all items of *list* as a key at *time*
+     * (in seconds), replacing a key at the same time. Items with a
+     * name that has no channel yet get a new channel, which has the
+     * value of the item in all other keys. Channels of names that
+     * are not in *list* keep their interpolated value. Returns false
+     * on a memory error, in which case the table is unchanged.
+     */
+    Bool SetKey(Float time, const FloatlistData& list);
+
+    void RemoveKey(Int32 key);
+
+    void Flush();
+
+    /**
+     * Evaluates all channels at *time* into *out*, which must have
+     * room for GetChannelCount() values. Before the first and after
+     * the last key the values of that key are used.
+     */
+    void Evaluate(Float time, Float* out) const;
+
+    /**
+     * Evaluates the channels at *time* and writes the values to the
+     * items of *list* with the same names. Returns false on a memory
+     * error.
+     */
+    Bool Apply(Float time, FloatlistData& list) const;
+
+    Bool CopyFrom(const FloatlistKeyTable& other);
+
+    Bool Write(HyperFile* hf) const;
+
+    Bool Read(HyperFile* hf);
+
+private:
+
+    FloatlistKeyTable(const FloatlistKeyTable&);
+    FloatlistKeyTable& operator = (const FloatlistKeyTable&);
+
+    /**
+     * Returns the index of the first key after *time*.
+     */
+    Int32 UpperKey(Float time) const;
+
+    maxon::BaseArray<Int32> m_channels;
+    maxon::BaseArray<Float> m_times;
+
+    /**
+     * The value of channel *c* at key *k* is at
+     * `k * GetChannelCount() + c`.
+     */
+    maxon::BaseArray<Float> m_values;
+
+};
+
+/**
+ * Functions to create and access Floatlist tracks. A Floatlist track
+ * animates all items of one Floatlist parameter, instead of one
+ * track per subchannel (the subchannels are not animatable).
+ *
+ * The parameter itself stays DESC_ANIMATE_OFF, so the Attribute
+ * Manager offers no key buttons for it and Cinema never creates
+ * these tracks by itself. They are driven from code only: keys are
+ * recorded with RecordKey() (or set on the table from GetKeys()),
+ * after which the track plays back like any other track. A track
+ * that Cinema created would interpolate the whole list as one
+ * value, which custom datatypes do not support.
+ */
+class FloatlistTrack {
+
+public:
+
+    /**
+     * Returns the Floatlist track of *node* that animates the
+     * parameter *id*. If there is none and *create* is true, a new
+     * track is created and inserted into *node*.
+     */
+    static CTrack* Find(BaseList2D* node, const DescID& id, Bool create);
+
+    /**
+     * Returns the keys of a Floatlist track, or nullptr if *track*
+     * is not a Floatlist track.
+     */
+    static FloatlistKeyTable* GetKeys(CTrack* track);
+
+    /**
+     * Stores the current values of the parameter *id* of *node* as
+     * a key at *time*, creating the track if necessary.
+     */
+    static Bool RecordKey(BaseList2D* node, const DescID& id, const BaseTime& time);
+
+};
+
+#endif /* CINEMA4DSDK_DATATYPE_FLOATLIST_TRACK_H */
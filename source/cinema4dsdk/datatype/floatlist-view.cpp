@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: sorted views of a Floatlist for binary searches and joins
+ * level: advanced
+ * tags: datatype, algorithm
+ * read-before: floatlist.cpp
+ */
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist-view.h>
+
+FloatlistView::FloatlistView(const FloatlistData& list, Bool byName)
+: m_order(list.GetOrder(byName)), m_ids(list.GetNameIdsR()), m_values(list.GetValuesR()),
+  m_count(0), m_byName(byName) {
+    if (m_order != nullptr)
+        m_count = list.GetCount();
+}
+
+FloatlistView FloatlistView::ByValue(const FloatlistData& list) {
+    return FloatlistView(list, false);
+}
+
+FloatlistView FloatlistView::ByName(const FloatlistData& list) {
+    return FloatlistView(list, true);
+}
+
+Int32 FloatlistView::LowerBound(Float value) const {
+    DebugAssert(!m_byName);
+    Int32 lo = 0, hi = m_count;
+    while (lo < hi) {
+        Int32 mid = lo + (hi - lo) / 2;
+        if (GetValue(mid) < value)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+Int32 FloatlistView::UpperBound(Float value) const {
+    DebugAssert(!m_byName);
+    Int32 lo = 0, hi = m_count;
+    while (lo < hi) {
+        Int32 mid = lo + (hi - lo) / 2;
+        Float x = GetValue(mid);
+        if (value < x || x != x) // NaN is sorted last
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+void FloatlistView::FindNameId(Int32 id, Int32& first, Int32& end) const {
+    DebugAssert(m_byName);
+    Int32 lo = 0, hi = m_count;
+    while (lo < hi) {
+        Int32 mid = lo + (hi - lo) / 2;
+        if (GetNameId(mid) < id)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    first = end = lo;
+    while (end < m_count && GetNameId(end) == id)
+        end++;
+}
@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef CINEMA4DSDK_DATATYPE_FLOATLIST_VIEW_H
+#define CINEMA4DSDK_DATATYPE_FLOATLIST_VIEW_H
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist.h>
+
+/**
+ * A sorted view of the items of a FloatlistData, ordered by value
+ * or by name ID (see FloatlistData::GetOrder()). Positions in the
+ * view are called ranks, GetIndex() maps a rank to the index of the
+ * item in the list.
+ *
+ * The view does not copy anything, it only points to the columns
+ * and the order of the list. It is valid until the list is modified
+ * and cheap to create again afterwards if the list did not change.
+ *
+ *     FloatlistView view = FloatlistView::ByValue(list);
+ *     Int32 first, end;
+ *     view.GetRange(0.1, 1.0, first, end);
+ *     for (Int32 rank=first; rank < end; rank++)
+ *         Use(view.GetIndex(rank));
+ */
+class FloatlistView {
+
+public:
+
+    /**
+     * Return an empty view if the order could not be built.
+     */
+    static FloatlistView ByValue(const FloatlistData& list);
+    static FloatlistView ByName(const FloatlistData& list);
+
+    FloatlistView()
+    : m_order(nullptr), m_ids(nullptr), m_values(nullptr), m_count(0), m_byName(false) { }
+
+    Int32 GetCount() const {
+        return m_count;
+    }
+
+    Bool IsByName() const {
+        return m_byName;
+    }
+
+    Int32 GetIndex(Int32 rank) const {
+        return m_order[rank];
+    }
+
+    Int32 GetNameId(Int32 rank) const {
+        return m_ids[m_order[rank]];
+    }
+
+    Float GetValue(Int32 rank) const {
+        return m_values[m_order[rank]];
+    }
+
+    /**
+     * Value views only. Return the rank of the first item with a
+     * value not less (LowerBound()) or greater (UpperBound()) than
+     * *value*, GetCount() if there is none. O(log n).
+     */
+    Int32 LowerBound(Float value) const;
+    Int32 UpperBound(Float value) const;
+
+    /**
+     * Value views only. Stores the ranks of the items with a value
+     * in [lo, hi] as [*first*, *end*). The items with the *k*
+     * largest values are the ranks from GetCount() - k on.
+     */
+    void GetRange(Float lo, Float hi, Int32& first, Int32& end) const {
+        first = LowerBound(lo);
+        end = Max(UpperBound(hi), first);
+    }
+
+    /**
+     * Name views only. Stores the ranks of the items with the name
+     * ID *id* as [*first*, *end*), which is empty if there is no
+     * such item. O(log n).
+     */
+    void FindNameId(Int32 id, Int32& first, Int32& end) const;
+
+    /**
+     * Name views only. Walks both views at once and calls
+     * `fn(indexA, indexB)` for every pair of items with the same
+     * name, with the indices of the items in their lists. Items
+     * that only exist in one of the lists are skipped. O(n + m),
+     * plus the number of pairs if names occur more than once.
+     * Returns the number of pairs.
+     */
+    template <typename Fn>
+    static Int32 Join(const FloatlistView& a, const FloatlistView& b, Fn fn) {
+        DebugAssert(a.m_byName && b.m_byName);
+        Int32 pairs = 0;
+        Int32 i = 0, j = 0;
+        while (i < a.m_count && j < b.m_count) {
+            Int32 ida = a.GetNameId(i);
+            Int32 idb = b.GetNameId(j);
+            if (ida < idb) {
+                i++;
+                continue;
+            }
+            if (idb < ida) {
+                j++;
+                continue;
+            }
+
+            // Pair every item of the run of equal names in *a* with
+            // every item of the run in *b*.
+            Int32 endA = i, endB = j;
+            while (endA < a.m_count && a.GetNameId(endA) == ida)
+                endA++;
+            while (endB < b.m_count && b.GetNameId(endB) == idb)
+                endB++;
+            for (; i < endA; i++) {
+                for (Int32 k=j; k < endB; k++) {
+                    fn(a.GetIndex(i), b.GetIndex(k));
+                    pairs++;
+                }
+            }
+            j = endB;
+        }
+        return pairs;
+    }
+
+private:
+
+    FloatlistView(const FloatlistData& list, Bool byName);
+
+    const Int32* m_order;
+    const Int32* m_ids;
+    const Float* m_values;
+    Int32 m_count;
+    Bool m_byName;
+
+};
+
+#endif /* CINEMA4DSDK_DATATYPE_FLOATLIST_VIEW_H */
@@ -27,15 +27,18 @@
 #include <c4d.h>
 #include <cinema4dsdk/stringutils.h>
 #include <cinema4dsdk/datatype/floatlist.h>
+#include <cinema4dsdk/datatype/floatlist-codec.h>
+#include <cinema4dsdk/datatype/floatlist-instrumentation.h>
+#include <cinema4dsdk/datatype/floatlist-pool.h>
+#include <cinema4dsdk/datatype/floatlist-selection.h>
 #include "c4d_symbols.h"
 
 static String ToString(const FloatlistData& data, Bool detailed=false) {
     String result = "FloatlistData(" + ToString(data.GetCount()) + ")";
     if (detailed) {
         for (Int32 i=0; i < data.GetCount(); i++) {
-            const auto& item = data[i];
-            result += "\n  #" + ToString(i) + ": " + item.name;
-            result += " = " + ToString(item.value);
+            result += "\n  #" + ToString(i) + ": " + data.GetName(i);
+            result += " = " + ToString(data.GetValue(i));
         }
     }
     return result;
@@ -47,6 +50,121 @@ static String ToString(const FloatlistData* data, Bool detailed=false) {
     return ToString(*data, detailed);
 }
 
+/**
+ * The disk levels of the Floatlist datatype. Cinema passes the
+ * level that the data was written with to ReadData(), so we can
+ * still read files that were saved with an older format.
+ */
+enum {
+    // One String and one Float call per item.
+    FLOATLIST_LEVEL_ITEMS = 1000,
+
+    // The value column as one memory block and all names in a
+    // second block of length-prefixed UTF-8 strings.
+    FLOATLIST_LEVEL_CHUNKED = 1001,
+
+    // Same as FLOATLIST_LEVEL_CHUNKED, but the value block is
+    // encoded with one of the FLOATLIST_ENCODING values.
+    FLOATLIST_LEVEL_ENCODED = 1002,
+
+    // Adds the sidecar path and whether the values were written to
+    // the sidecar instead of the value block.
+    FLOATLIST_LEVEL_SIDECAR = 1003,
+
+    // Adds the stamp of the sidecar file, to detect a sidecar that
+    // was replaced after the scene was saved.
+    FLOATLIST_LEVEL_STAMP = 1004,
+
+    // Adds the encoding of the list itself, which is not the one of
+    // the value block if the values did not compress or the list
+    // uses the default encoding.
+    FLOATLIST_LEVEL_PREFERRED = 1005,
+
+    FLOATLIST_LEVEL_CURRENT = FLOATLIST_LEVEL_PREFERRED,
+};
+
+/**
+ * Lists with at least this many items are decoded lazily when they
+ * are read from a file, see FloatlistData::AssignEncoded().
+ */
+static const Int32 FLOATLIST_LAZY_THRESHOLD = 1024;
+
+/**
+ * The full description of a list only has subchannels for this many
+ * items, see _GetDescription(). Every item is still described when
+ * Cinema asks for its subchannel alone.
+ */
+static const Int32 FLOATLIST_DESCRIPTION_LIMIT = 1024;
+
+/**
+ * The description of a subchannel only depends on the name of its
+ * item, so the containers are created once per name ID and re-used
+ * for every list and every call to _GetDescription(). The Attribute
+ * Manager requests the description on every redraw, changing values
+ * does not create any containers and adding an item only creates
+ * one if its name was not used before. A container is created again
+ * when its name ID was re-used for another name, which is detected
+ * with the serial of the ID.
+ */
+static GeSpinlock g_descLock;
+static BaseContainer* g_descTemplate = nullptr;
+static maxon::BaseArray<BaseContainer*> g_descItems;
+static maxon::BaseArray<UInt32> g_descSerials;
+
+static const BaseContainer* GetItemDescription(Int32 nameId) {
+    const BaseContainer* result = nullptr;
+    g_descLock.Lock();
+
+    // Create the default parameter description that we
+    // will use for each item in the FloatlistData.
+    if (g_descTemplate == nullptr) {
+        g_descTemplate = NewObj(BaseContainer, GetCustomDataTypeDefault(DA_REAL));
+        if (g_descTemplate != nullptr) {
+            g_descTemplate->SetFloat(DESC_MIN, 0.0);
+            g_descTemplate->SetFloat(DESC_MAX, 1.0);
+            g_descTemplate->SetFloat(DESC_STEP, 0.01);
+            g_descTemplate->SetInt32(DESC_UNIT, DESC_UNIT_PERCENT);
+            g_descTemplate->SetInt32(DESC_CUSTOMGUI, CUSTOMGUI_REALSLIDER);
+        }
+    }
+
+    // Name IDs are small consecutive numbers, so they can be used
+    // as indices.
+    Int32 size = (Int32) g_descItems.GetCount();
+    if (g_descTemplate != nullptr && (nameId < size || (g_descSerials.Resize(nameId + 1)
+            && g_descItems.Resize(nameId + 1)))) {
+        for (Int32 i=size; i <= nameId; i++)
+            g_descItems[i] = nullptr;
+
+        UInt32 serial = FloatlistSymbols::GetSerial(nameId);
+        if (g_descItems[nameId] != nullptr && g_descSerials[nameId] != serial)
+            DeleteObj(g_descItems[nameId]);
+
+        if (g_descItems[nameId] == nullptr) {
+            BaseContainer* bc = NewObj(BaseContainer, *g_descTemplate);
+            if (bc != nullptr) {
+                const String& name = FloatlistSymbols::Get(nameId);
+                bc->SetString(DESC_NAME, name);
+                bc->SetString(DESC_SHORT_NAME, name);
+                g_descItems[nameId] = bc;
+                g_descSerials[nameId] = serial;
+            }
+        }
+        result = g_descItems[nameId];
+    }
+
+    g_descLock.Unlock();
+    return result;
+}
+
+static void FreeItemDescriptions() {
+    for (Int32 i=0; i < (Int32) g_descItems.GetCount(); i++)
+        DeleteObj(g_descItems[i]);
+    g_descItems.Flush();
+    g_descSerials.Flush();
+    DeleteObj(g_descTemplate);
+}
+
 
 /**
  * This class implements how Cinema 4D is supposed to treat our
@@ -64,7 +182,8 @@ public:
     static Bool Register() {
         auto data = NewObj(FloatlistDataType);
         Int32 flags = CUSTOMDATATYPE_INFO_HASSUBDESCRIPTION | CUSTOMDATATYPE_INFO_NEEDDATAFORSUBDESC;
-        return RegisterCustomDataTypePlugin("Floatlist", flags, data, 1000);
+        return RegisterCustomDataTypePlugin("Floatlist", flags, data,
+                FLOATLIST_LEVEL_CURRENT);
     }
 
     // CustomDataTypeClass
@@ -74,7 +193,7 @@ public:
     }
 
     virtual CustomDataType* AllocData() {
-        return NewObj(FloatlistData);
+        return FloatlistData::Alloc();
     }
 
     virtual void FreeData(CustomDataType* data) {
@@ -85,112 +204,295 @@ public:
     virtual Bool CopyData(const CustomDataType* src_, CustomDataType* dst_,
                 AliasTrans* trans)
     {
+        FLOATLIST_PROBE_SCOPE(FLOATLIST_PROBE_COPYDATA);
 
         auto src = static_cast<const FloatlistData*>(src_);
         auto dst = static_cast<FloatlistData*>(dst_);
         if (src == nullptr || dst == nullptr)
             return false;
 
-        dst->CopyFrom(*src);
-        return true;
+        // This does not actually copy the items, both lists will
+        // share the same data until one of them is modified.
+        return dst->CopyFrom(*src);
     }
 
     virtual Int32 Compare(const CustomDataType* a_, const CustomDataType* b_) {
+        FLOATLIST_PROBE_SCOPE(FLOATLIST_PROBE_COMPARE);
 
         auto a = static_cast<const FloatlistData*>(a_);
         auto b = static_cast<const FloatlistData*>(b_);
         if (a == nullptr || b == nullptr)
             return -1; // lower than
 
-        // There is not really a good and easy way to compare two
-        // lists as we have here, so we just go by their length.
+        // Lists are ordered by their length first and then by their
+        // first differing item.
 
         Int32 countA = a->GetCount();
         Int32 countB = b->GetCount();
-        if (countA == countB) {
-            // Important Fact: When the value from the Custom GUI is
-            // updated, Cinema first checks if the values equal. If they
-            // do, the original value will be kept. So, if we just say
-            // to Floatlists are equal when they have the same length,
-            // the actual value of each item won't be updated because
-            // the original Floatlist is kept.
-            //
-            // Conclusion: Compare thorougly!
-            //
-            // Since there is no value for just "unequal", we say
-            // if the Floatlists don't equal but we can not tell
-            // if the one is lower or greater, we just use lower.
-
-            static const Float ELLIPSIS = 0.00001;
-            for (Int32 i=0; i < countA; i++) {
-                const auto& itemA = (*a)[i];
-                const auto& itemB = (*b)[i];
-
-                if (itemA.name != itemB.name)
-                    return -1; // lower than
-                if (Abs(itemA.value - itemB.value) > ELLIPSIS)
-                    return -1; // lower than
-            }
-
-            return 0; // equal
+        if (countA != countB)
+            return countA < countB ? -1 : 1;
+
+        // Important Fact: When the value from the Custom GUI is
+        // updated, Cinema first checks if the values equal. If they
+        // do, the original value will be kept. So, if we just say
+        // to Floatlists are equal when they have the same length,
+        // the actual value of each item won't be updated because
+        // the original Floatlist is kept.
+        //
+        // Conclusion: Compare thorougly!
+        //
+        // The hashes can not be used to skip the walk, equal hashes
+        // can collide. Values are compared by their cell in the
+        // TOLERANCE grid, which is transitive unlike their
+        // difference, so this is a total order.
+
+        const Float* valuesA = a->GetValuesR();
+        const Float* valuesB = b->GetValuesR();
+        const Int32* idsA = a->GetNameIdsR();
+        const Int32* idsB = b->GetNameIdsR();
+        if (valuesA == valuesB && idsA == idsB)
+            return 0; // copies that share their data
+
+        for (Int32 i=0; i < countA; i++) {
+            if (idsA[i] != idsB[i])
+                return a->GetName(i).Compare(b->GetName(i)) < 0 ? -1 : 1;
+            Int32 result = FloatlistData::CompareValues(valuesA[i], valuesB[i]);
+            if (result != 0)
+                return result;
         }
-        else if (countA < countB)
-            return -1; // lower than
-        else
-            return 1; // greater than
+
+        return 0; // equal
     }
 
     virtual Bool WriteData(const CustomDataType* data_, HyperFile* hf) {
+        FLOATLIST_PROBE_SCOPE(FLOATLIST_PROBE_WRITEDATA);
 
         auto data = static_cast<const FloatlistData*>(data_);
         if (data == nullptr)
             return false;
 
-        // We first write the number of items, and then each item
-        // separately to the HyperFile.
+        // We first write the number of items, the size of a Float
+        // and the encoding, then the whole value column as one block
+        // of memory and all names in a second block. This is a lot
+        // faster than writing each item separately for long lists.
 
         Int32 count = data->GetCount();
         if (!hf->WriteInt32(count)) return false;
+        if (!hf->WriteInt32(sizeof(Float))) return false;
+
+        // Lists with a sidecar write their values to it, but only
+        // while their document is saved. Any other write (the
+        // clipboard, memory files, ...) stores the values and leaves
+        // out the path, so that it has no effect on the disk and the
+        // list that is read back does not write to our file. If the
+        // sidecar can not be written (eg. the directory is read-only),
+        // the values are stored in the scene like for every other list.
+        Filename sidecar;
+        Bool external = false;
+        UInt64 stamp = 0;
+        if (data->GetSidecar().Content() && FloatlistSidecar::IsSaving(hf->GetDocument())) {
+            sidecar = data->GetSidecar();
+            external = count > 0 && data->WriteSidecar(&stamp);
+            if (count > 0 && !external)
+                GePrint("Floatlist: could not write " + sidecar.GetString() + ", the values are stored in the scene");
+        }
+        if (!hf->WriteFilename(sidecar)) return false;
+        if (!hf->WriteBool(external)) return false;
+        if (!hf->WriteUInt64(stamp)) return false;
+
+        // The encoding of the list is kept as it is, so that a list
+        // whose values did not compress this time tries again the
+        // next time and a list without an encoding of its own keeps
+        // following the default.
+        Int32 encoding = GetWriteEncoding(data);
+        if (!hf->WriteInt32(data->GetEncoding())) return false;
+
+        if (count <= 0) return hf->WriteInt32(FLOATLIST_ENCODING_RAW);
+        if (external) {
+            if (!hf->WriteInt32(encoding)) return false;
+            return WriteNames(data, hf);
+        }
 
-        for (Int32 index=0; index < count; index++) {
-            const auto& item = (*data)[index];
-            if (!hf->WriteString(item.name)) return false;
-            if (!hf->WriteFloat(item.value)) return false;
+        // The raw values can be written directly from the column,
+        // everything else goes through the FloatlistCodec.
+        maxon::BaseArray<UChar> encoded;
+        if (encoding != FLOATLIST_ENCODING_RAW) {
+            encoding = FloatlistCodec::Encode(data->GetValuesR(), count, encoding, encoded);
+            if (encoding == NOTOK) return false;
         }
 
-        return true;
+        if (!hf->WriteInt32(encoding)) return false;
+        if (encoding == FLOATLIST_ENCODING_RAW) {
+            if (!hf->WriteMemory(data->GetValuesR(), count * sizeof(Float)))
+                return false;
+            FLOATLIST_PROBE_BYTES(count * sizeof(Float));
+        }
+        else if (!hf->WriteMemory(encoded.GetFirst(), encoded.GetCount()))
+            return false;
+        else
+            FLOATLIST_PROBE_BYTES(encoded.GetCount());
+
+        return WriteNames(data, hf);
+    }
+
+    /**
+     * Returns the encoding that WriteData() uses for *data*: its own
+     * or, if it has none, the one of the defaults of the datatype.
+     */
+    Int32 GetWriteEncoding(const FloatlistData* data) {
+        Int32 encoding = data->GetEncoding();
+        if (encoding != FLOATLIST_ENCODING_DEFAULT)
+            return encoding;
+        BaseContainer defaults;
+        GetDefaultProperties(defaults);
+        return defaults.GetInt32(FLOATLIST_ENCODING, FLOATLIST_ENCODING_RAW);
+    }
+
+    static Bool WriteNames(const FloatlistData* data, HyperFile* hf) {
+        maxon::BaseArray<Char> names;
+        if (!FloatlistCodec::EncodeNames(data->GetNameIdsR(), data->GetCount(), names))
+            return false;
+        FLOATLIST_PROBE_ADDBYTES(FLOATLIST_PROBE_WRITEDATA, names.GetCount());
+        return hf->WriteMemory(names.GetFirst(), names.GetCount());
     }
 
     virtual Bool ReadData(CustomDataType* data_, HyperFile* hf, Int32 level)
     {
+        FLOATLIST_PROBE_SCOPE(FLOATLIST_PROBE_READDATA);
 
         auto data = static_cast<FloatlistData*>(data_);
         if (data == nullptr)
             return false;
 
+        // Clear all elements in the array so we start from an
+        // empty state.
+        data->Flush();
+
+        if (level < FLOATLIST_LEVEL_CHUNKED)
+            return ReadItems(data, hf);
+        return ReadChunked(data, hf, level);
+    }
+
+    /**
+     * Reads the format of FLOATLIST_LEVEL_ITEMS.
+     */
+    static Bool ReadItems(FloatlistData* data, HyperFile* hf) {
+
         // We need to read the data the way we have previously
         // written it to the HyperFile. If any of the read methods
         // fails, the input data is invalid (eg. the file is corrup).
 
         Int32 count;
         if (!hf->ReadInt32(&count)) return false;
+        if (count < 0 || !data->EnsureCapacity(count)) return false;
 
-        // Clear all elements in the array so we start from an
-        // empty state.
-        data->Flush();
         for (Int32 index=0; index < count; index++) {
 
-            // Create a new item at the end of the BaseArray.
-            auto item = data->Append();
-            if (item == nullptr) return false;
+            // Read the name and value from the file and append
+            // them as a new item to the list.
+            String name;
+            Float value;
+            if (!hf->ReadString(&name)) return false;
+            if (!hf->ReadFloat(&value)) return false;
+            if (!data->Append(name, value)) return false;
 
-            // Read the name and value from the file into the
-            // members of the created item.
-            if (!hf->ReadString(&item->name)) return false;
-            if (!hf->ReadFloat(&item->value)) return false;
+        }
 
+        return true;
+    }
+
+    /**
+     * Reads the formats of FLOATLIST_LEVEL_CHUNKED and later.
+     */
+    static Bool ReadChunked(FloatlistData* data, HyperFile* hf, Int32 level) {
+        Int32 count, floatSize;
+        Int32 encoding = FLOATLIST_ENCODING_RAW;
+        Int32 preferred = FLOATLIST_ENCODING_DEFAULT;
+        Filename sidecar;
+        Bool external = false;
+        UInt64 stamp = 0;
+        if (!hf->ReadInt32(&count)) return false;
+        if (!hf->ReadInt32(&floatSize)) return false;
+        if (level >= FLOATLIST_LEVEL_SIDECAR) {
+            if (!hf->ReadFilename(&sidecar)) return false;
+            if (!hf->ReadBool(&external)) return false;
+        }
+        if (level >= FLOATLIST_LEVEL_STAMP && !hf->ReadUInt64(&stamp)) return false;
+        if (level >= FLOATLIST_LEVEL_PREFERRED && !hf->ReadInt32(&preferred)) return false;
+        if (level >= FLOATLIST_LEVEL_ENCODED && !hf->ReadInt32(&encoding)) return false;
+        if (count < 0 || floatSize != sizeof(Float)) return false;
+
+        // Keep the encoding and sidecar, so that the list is written
+        // the same way the next time. Older files only have the
+        // encoding of the value block.
+        if (level < FLOATLIST_LEVEL_PREFERRED)
+            preferred = encoding;
+        data->SetEncoding(preferred);
+        data->SetSidecar(sidecar);
+        if (count == 0) return true;
+        if (external) return ReadSidecar(data, hf, count, stamp);
+
+        // ReadMemory() allocates the memory for us. The blocks are
+        // handed over to the FloatlistData which frees them.
+        void* memory = nullptr;
+        void* blob = nullptr;
+        Int memorySize = 0;
+        Int blobSize = 0;
+        if (!hf->ReadMemory(&memory, &memorySize) || !hf->ReadMemory(&blob, &blobSize)) {
+            DeleteMem(memory);
+            DeleteMem(blob);
+            return false;
         }
+        FLOATLIST_PROBE_ADDBYTES(FLOATLIST_PROBE_READDATA, memorySize + blobSize);
 
+        // The size of raw values can be checked right away.
+        if (encoding == FLOATLIST_ENCODING_RAW && memorySize != count * (Int) sizeof(Float)) {
+            DeleteMem(memory);
+            DeleteMem(blob);
+            return false;
+        }
+
+        // The values are only decoded when the list is accessed for
+        // the first time. Documents that are
+        // loaded by a render job often contain lists that are never
+        // used. Short lists are decoded immediately, so that we can
+        // still tell Cinema if the data is corrupt.
+        if (!data->AssignEncoded(count, encoding, memory, memorySize, blob, blobSize))
+            return false;
+        if (count < FLOATLIST_LAZY_THRESHOLD)
+            return data->Materialize();
+        return true;
+    }
+
+    /**
+     * Reads the names of a list whose values were written to its
+     * sidecar and maps the sidecar. *stamp* is the stamp of the file
+     * that was written with the scene, 0 for scenes that were saved
+     * before sidecars had a stamp.
+     */
+    static Bool ReadSidecar(FloatlistData* data, HyperFile* hf, Int32 count, UInt64 stamp) {
+        void* blob = nullptr;
+        Int blobSize = 0;
+        if (!hf->ReadMemory(&blob, &blobSize)) return false;
+
+        // The values only exist in the sidecar. If it is missing or
+        // was replaced by another save, the load fails: loading the
+        // names with made-up values would silently overwrite the
+        // sidecar the next time the scene is saved.
+        Filename path = data->GetSidecar();
+        FloatlistSidecar* sidecar = FloatlistSidecar::Open(path);
+        if (sidecar == nullptr || sidecar->GetCount() != count
+                || (stamp != 0 && sidecar->GetStamp() != stamp)) {
+            GePrint("Floatlist: sidecar " + path.GetString() + " is missing or does not match the scene");
+            FloatlistSidecar::Free(sidecar);
+            DeleteMem(blob);
+            return false;
+        }
+
+        if (!data->AssignMapped(count, sidecar, blob, blobSize))
+            return false;
+        if (count < FLOATLIST_LAZY_THRESHOLD)
+            return data->Materialize();
         return true;
     }
 
@@ -198,33 +500,47 @@ public:
                 DESCFLAGS_DESC& flags, const BaseContainer& parentDesc,
                 DescID* unused)
     {
+        FLOATLIST_PROBE_SCOPE(FLOATLIST_PROBE_GETDESCRIPTION);
         if (data_ == nullptr)
             return false;
 
         const auto& data = *static_cast<const FloatlistData*>(data_);
 
-        // Create the default parameter description that we
-        // will use for each item in the FloatlistData.
-        BaseContainer default_ = GetCustomDataTypeDefault(DA_REAL);
-        default_.SetFloat(DESC_MIN, 0.0);
-        default_.SetFloat(DESC_MAX, 1.0);
-        default_.SetFloat(DESC_STEP, 0.01);
-        default_.SetInt32(DESC_UNIT, DESC_UNIT_PERCENT);
-        default_.SetInt32(DESC_CUSTOMGUI, CUSTOMGUI_REALSLIDER);
+        // The description is where the FLOATLIST_ENCODING of the
+        // parameter meets the list that is stored in the node, so a
+        // list that has no encoding of its own takes it from here.
+        // The encoding only affects how the list is written, not its
+        // value.
+        Int32 encoding = parentDesc.GetInt32(FLOATLIST_ENCODING, FLOATLIST_ENCODING_DEFAULT);
+        if (data.GetEncoding() == FLOATLIST_ENCODING_DEFAULT && encoding != FLOATLIST_ENCODING_DEFAULT)
+            const_cast<FloatlistData&>(data).SetEncoding(encoding);
 
         // todo: The parameters are not accessible via XPresso.
 
+        // If Cinema only asks for the description of one subchannel,
+        // we only add that one. Otherwise only the first items get a
+        // subchannel, adding one parameter per item on every redraw
+        // of the Attribute Manager does not scale to long lists.
+        Int32 first = 0;
+        Int32 count = Min(data.GetCount(), FLOATLIST_DESCRIPTION_LIMIT);
+        const DescID* single = desc.GetSingleDescID();
+        if (single != nullptr && single->GetDepth() > 0) {
+            Int32 index = (*single)[single->GetDepth() - 1].id - 1000;
+            first = index;
+            count = (index >= 0 && index < data.GetCount()) ? index + 1 : index;
+        }
+
         // Create a parameter for each entry in the FloatlistData.
-        Int32 count = data.GetCount();
-        for (Int32 i=0; i < count; i++) {
-            const auto& item = data[i];
-            default_.SetString(DESC_NAME, item.name);
-            default_.SetString(DESC_SHORT_NAME, item.name);
+        const Int32* ids = data.GetNameIdsR();
+        for (Int32 i=first; i < count; i++) {
+            const BaseContainer* bc = GetItemDescription(ids[i]);
+            if (bc == nullptr)
+                return false;
 
             // Note: DescID(0) doesn't work, we'll make it similar to the
             // Vector DescIDs and start with 1000 (it's common convention
             // to start with 100 in the Cinema 4D Plugin API)
-            desc.SetParameter(DescID(1000 + i), default_, DESCID_ROOT);
+            desc.SetParameter(DescID(1000 + i), *bc, DESCID_ROOT);
         }
 
         // Tell that we loaded the description.
@@ -235,6 +551,7 @@ public:
     virtual Bool GetParameter(const CustomDataType* data_, const DescID& id,
                 GeData& dest, DESCFLAGS_GET& flags)
     {
+        FLOATLIST_PROBE_SCOPE(FLOATLIST_PROBE_GETPARAMETER);
         if (data_ == nullptr)
             return false;
 
@@ -247,8 +564,7 @@ public:
 
         Int32 count = data.GetCount();
         if (index >= 0 && index < count) {
-            const auto& item = data[index];
-            dest.SetFloat(item.value);
+            dest.SetFloat(data.GetValue(index));
 
             // Tell that the parameter could be retreived successfully.
             flags |= DESCFLAGS_GET_PARAM_GET;
@@ -261,6 +577,7 @@ public:
     virtual Bool SetDParameter(CustomDataType* data_, const DescID& id,
                 const GeData& value, DESCFLAGS_SET& flags)
     {
+        FLOATLIST_PROBE_SCOPE(FLOATLIST_PROBE_SETDPARAMETER);
         if (data_ == nullptr)
             return false;
 
@@ -273,8 +590,7 @@ public:
 
         Int32 count = data.GetCount();
         if (index >= 0 && index < count) {
-            auto& item = data[index];
-            item.value = value.GetFloat();
+            data.SetValue(index, value.GetFloat());
 
             // Tell that the parameter could be set successfully.
             flags |= DESCFLAGS_SET_PARAM_SET;
@@ -291,8 +607,13 @@ public:
     }
 
     virtual void GetDefaultProperties(BaseContainer& data) {
+        // Lists are animated by a FloatlistTrack that is created
+        // from code, see FloatlistTrack::RecordKey().
         data.SetInt32(DESC_ANIMATE, DESC_ANIMATE_OFF);
         data.SetInt32(DESC_CUSTOMGUI, CUSTOMGUI_FLOATLIST);
+        data.SetInt32(FLOATLIST_ENCODING, FLOATLIST_ENCODING_RAW);
+        data.SetInt32(FLOATLIST_ROWS, FLOATLIST_ROWS_DEFAULT);
+        data.SetInt32(FLOATLIST_THROTTLE, FLOATLIST_THROTTLE_DEFAULT);
     }
 
 };
@@ -312,7 +633,11 @@ class FloatlistGui : public iCustomGui {
      */
     enum {
         GROUP_MAIN = 20000,
+        GROUP_ROWS,
+        GROUP_SCROLL,
         TEXT_MULTIPLE,
+        TEXT_RANGE,
+        SLIDER_SCROLL,
         BUTTON_PLUS,
 
         // The start ID for the dynamic widgets.
@@ -328,6 +653,10 @@ class FloatlistGui : public iCustomGui {
         DYNAMIC_REMOVEBUTTON = 2,
         DYNAMIC_ITEMS = 3,
 
+        // Number of rows that are scrolled per step of the mouse
+        // wheel.
+        WHEEL_ROWS = 3,
+
         // A shorthand for the full scalefit flag.
         HV_SCALEFIT = BFH_SCALEFIT | BFV_SCALEFIT,
     };
@@ -347,6 +676,60 @@ class FloatlistGui : public iCustomGui {
      */
     Int32 m_count;
 
+    /**
+     * The maximum number of rows that are displayed at once, from
+     * the FLOATLIST_ROWS property. Only this many rows of widgets
+     * are created, no matter how long the list is. They display the
+     * items from m_first on and are re-used when the list is
+     * scrolled, so the widget IDs from DYNAMIC_START on refer to
+     * rows and not to items.
+     */
+    Int32 m_rows;
+
+    /**
+     * The index of the item displayed in the first row.
+     */
+    Int32 m_first;
+
+    /**
+     * The number of rows that are currently shown, the smaller of
+     * m_rows and m_count.
+     */
+    Int32 m_visible;
+
+    /**
+     * The number of rows that have widgets. Rows from m_visible
+     * to m_capacity are hidden.
+     */
+    Int32 m_capacity;
+
+    /**
+     * The name ID and value that each row displays, used to only
+     * update the widgets that changed. NOTOK as name ID marks rows
+     * that do not display anything yet.
+     */
+    maxon::BaseArray<Int32> m_shownIds;
+    maxon::BaseArray<Float> m_shownValues;
+    maxon::BaseArray<Bool> m_shownDiffers;
+
+    /**
+     * Set when multiple nodes are displayed and the GUI edits all
+     * of their lists through m_selection. m_data is the union of
+     * their items then, m_differs marks the items that do not have
+     * the same value in all lists and m_changed collects the name
+     * IDs of the items whose value was changed but not applied yet.
+     * m_dragging is set while a slider is dragged, only the first
+     * change of a drag adds an undo step. The selection is only
+     * collected again once m_stale was set because the active nodes
+     * changed, see CoreMessage().
+     */
+    Bool m_merged;
+    FloatlistSelection m_selection;
+    Bool m_stale;
+    maxon::BaseArray<Bool> m_differs;
+    maxon::BaseArray<Int32> m_changed;
+    Bool m_dragging;
+
     /**
      * This is just a copy of the data that is used when signaling
      * the parent that the value has changed (we don't want to loose
@@ -354,13 +737,45 @@ class FloatlistGui : public iCustomGui {
      */
     FloatlistData m_data;
 
+    /**
+     * The FLOATLIST_ENCODING from the description of the parameter,
+     * FLOATLIST_ENCODING_DEFAULT if it has none.
+     * It is assigned to the data before it is sent to the parent.
+     */
+    Int32 m_encoding;
+
+    /**
+     * The minimum interval between two updates that are sent to the
+     * parent while a slider is dragged, in milliseconds, from the
+     * FLOATLIST_THROTTLE property. If a change is queued, m_queued
+     * is set and m_queuedMsg is the message to send it with.
+     */
+    Int32 m_throttle;
+    Int32 m_lastSent;
+    Bool m_queued;
+    BaseContainer m_queuedMsg;
+
 public:
 
     FloatlistGui(const BaseContainer& settings, CUSTOMGUIPLUGIN* plugin)
     : super(settings, plugin),
       m_multiple(false),
-      m_count(-2) // initialize to -2, indicates initialization value
-    { }
+      m_count(-2), // initialize to -2, indicates initialization value
+      m_rows(settings.GetInt32(FLOATLIST_ROWS, FLOATLIST_ROWS_DEFAULT)),
+      m_first(0),
+      m_visible(0),
+      m_capacity(0),
+      m_merged(false),
+      m_stale(true),
+      m_dragging(false),
+      m_encoding(settings.GetInt32(FLOATLIST_ENCODING, FLOATLIST_ENCODING_DEFAULT)),
+      m_throttle(settings.GetInt32(FLOATLIST_THROTTLE, FLOATLIST_THROTTLE_DEFAULT)),
+      m_lastSent(0),
+      m_queued(false)
+    {
+        if (m_rows <= 0)
+            m_rows = FLOATLIST_ROWS_DEFAULT;
+    }
 
     /**
      * Informs the parent about the new value the custom GUI
@@ -374,9 +789,21 @@ public:
     }
 
     /**
-     * Rebuilds the UI of the dialog.
+     * Returns true if the list has more items than rows and the
+     * scroll slider is displayed.
+     */
+    Bool IsScrolling() const {
+        return !m_multiple && m_count > m_rows;
+    }
+
+    /**
+     * Rebuilds the UI of the dialog. The layout is only created
+     * from scratch when switching between displaying the items and
+     * displaying multiple values. A change of the number of items
+     * only shows or hides rows, see ResizeRows().
      */
     void Rebuild(const FloatlistData* data) {
+        FLOATLIST_PROBE_SCOPE(FLOATLIST_PROBE_GUI_REBUILD);
         // If we display the actual item but the count didn't change,
         // we do not have to rebuild.
         if (!m_multiple && data->GetCount() == m_count) {
@@ -390,12 +817,24 @@ public:
             return;
         }
 
+        // Items were displayed before, the layout can be kept.
+        if (!m_multiple && m_count >= 0) {
+            ResizeRows(data->GetCount());
+            return;
+        }
+
         // Flush the dialog and re-create the main group.
         LayoutFlushGroup(0);
-        GroupBegin(GROUP_MAIN, HV_SCALEFIT, (m_multiple ? 1 : 3), 0, "", 0);
+        GroupBegin(GROUP_MAIN, HV_SCALEFIT, 1, 0, "", 0);
         GroupBorderNoTitle(BORDER_ROUND);
         GroupBorderSpace(4, 4, 4, 4);
 
+        m_capacity = 0;
+        m_visible = 0;
+        m_shownIds.Flush();
+        m_shownValues.Flush();
+        m_shownDiffers.Flush();
+
         if (m_multiple) {
             String name = GeLoadString(IDS_MULTIPLEVALUES);
             AddStaticText(TEXT_MULTIPLE, BFH_LEFT, 0, 0, name, 0);
@@ -404,16 +843,15 @@ public:
             m_count = -1;
         }
         else {
-            // Create text and sliders for each item in the data.
-            m_count = data->GetCount();
-            Int32 id = DYNAMIC_START;
-            for (Int32 index=0; index < m_count; index++) {
-                auto& item = (*data)[index];
-                AddStaticText(id + DYNAMIC_NAME, BFH_LEFT, 0, 0, item.name, 0);
-                AddEditSlider(id + DYNAMIC_SLIDER, BFH_SCALEFIT);
-                AddButton(id + DYNAMIC_REMOVEBUTTON, 0, 0, 0, "X");
-                id += DYNAMIC_ITEMS;
-            }
+            // The rows are added by ResizeRows().
+            GroupBegin(GROUP_ROWS, BFH_SCALEFIT, 3, 0, "", 0);
+            GroupEnd();
+
+            // The slider replaces a scrollbar for long lists.
+            GroupBegin(GROUP_SCROLL, BFH_SCALEFIT, 2, 0, "", 0);
+            AddStaticText(TEXT_RANGE, BFH_LEFT, 0, 0, "", 0);
+            AddSlider(SLIDER_SCROLL, BFH_SCALEFIT);
+            GroupEnd();
 
             GroupEnd();
 
@@ -421,11 +859,71 @@ public:
             GroupBegin(0, BFH_SCALEFIT, 0, 1, "", 0);
             AddButton(BUTTON_PLUS, BFH_RIGHT, 0, 0, "+");
             GroupEnd();
+
+            m_count = 0;
+            ResizeRows(data->GetCount());
         }
 
         LayoutChanged(0);
     }
 
+    /**
+     * Adapts the rows to a new number of items. Rows that are not
+     * needed anymore are hidden instead of being destroyed and are
+     * shown again when the list grows. Only if more rows are needed
+     * than were ever created, the row group is re-created with
+     * twice the capacity (up to m_rows).
+     */
+    void ResizeRows(Int32 count) {
+        m_count = count;
+        Int32 visible = Min(count, m_rows);
+
+        if (visible > m_capacity) {
+            Int32 capacity = Max<Int32>(m_capacity, 4);
+            while (capacity < visible)
+                capacity *= 2;
+            capacity = Min(capacity, m_rows);
+
+            LayoutFlushGroup(GROUP_ROWS);
+            Int32 id = DYNAMIC_START;
+            for (Int32 row=0; row < capacity; row++) {
+                AddStaticText(id + DYNAMIC_NAME, BFH_LEFT | BFH_SCALE, 0, 0, "", 0);
+                AddEditSlider(id + DYNAMIC_SLIDER, BFH_SCALEFIT);
+                AddButton(id + DYNAMIC_REMOVEBUTTON, 0, 0, 0, "X");
+                id += DYNAMIC_ITEMS;
+            }
+
+            // The new widgets are all empty and visible.
+            if (!m_shownIds.Resize(capacity) || !m_shownValues.Resize(capacity)
+                    || !m_shownDiffers.Resize(capacity))
+                capacity = 0;
+            for (Int32 row=0; row < capacity; row++)
+                m_shownIds[row] = NOTOK;
+            m_capacity = capacity;
+            m_visible = capacity;
+            visible = Min(visible, capacity);
+        }
+
+        // Hide or show the rows between the old and new number of
+        // visible rows.
+        for (Int32 row=visible; row < m_visible; row++)
+            HideRow(row, true);
+        for (Int32 row=m_visible; row < visible; row++)
+            HideRow(row, false);
+        m_visible = visible;
+
+        HideElement(GROUP_SCROLL, !IsScrolling());
+        m_first = ClampFirst(m_first);
+        LayoutChanged(GROUP_MAIN);
+    }
+
+    void HideRow(Int32 row, Bool hide) {
+        Int32 id = DYNAMIC_START + row * DYNAMIC_ITEMS;
+        HideElement(id + DYNAMIC_NAME, hide);
+        HideElement(id + DYNAMIC_SLIDER, hide);
+        HideElement(id + DYNAMIC_REMOVEBUTTON, hide);
+    }
+
     /**
      * Updates the values in the Dialog.
      */
@@ -434,29 +932,172 @@ public:
             return;
         DebugAssert(data != nullptr);
 
-        Int32 count = data->GetCount();
-        for (Int32 i=0; i < count; i++) {
+        m_data = *data;
+        UpdateRows();
+    }
 
-            const auto& item = (*data)[i];
+    /**
+     * Returns *first* limited to the valid range of first items
+     * for the current number of items and rows.
+     */
+    Int32 ClampFirst(Int32 first) const {
+        return ClampValue<Int32>(first, 0, Max<Int32>(m_count - m_visible, 0));
+    }
+
+    /**
+     * Fills the visible rows with the names and values of the items
+     * starting at m_first. Each row remembers the name ID and value
+     * it displays, so only the widgets whose content changed are
+     * touched. Appending an item or changing a single value thus
+     * updates one row, while inserting or erasing an item updates
+     * the rows from that item to the end of the visible window.
+     */
+    void UpdateRows() {
+        Int32 count = Min(m_data.GetCount(), m_count);
+        const Float* values = m_data.GetValuesR();
+        Bool renamed = false;
+        for (Int32 row=0; row < m_visible && m_first + row < count; row++) {
+
+            // Calculate the ID of the widgets for the current row
+            // and compare the item with what the row displays.
+            Int32 index = m_first + row;
+            Int32 id = DYNAMIC_START + row * DYNAMIC_ITEMS;
+            Int32 nameId = m_data.GetNameId(index);
+            Bool fresh = m_shownIds[row] == NOTOK;
+            if (nameId != m_shownIds[row]) {
+                SetString(id + DYNAMIC_NAME, m_data.GetName(index));
+                m_shownIds[row] = nameId;
+                renamed = true;
+            }
+            // Values that differ between the merged lists are shown
+            // as a tristate slider.
+            Bool differs = m_merged && m_differs[index];
+            if (fresh || values[index] != m_shownValues[row] || differs != m_shownDiffers[row]) {
+                SetPercent(id + DYNAMIC_SLIDER, values[index], 0.0, 100.0, 1.0, differs);
+                m_shownValues[row] = values[index];
+                m_shownDiffers[row] = differs;
+            }
+        }
 
-            // Calculate the ID of the slider for the current
-            // element of the Floatlist and set the value to
-            // the dialog.
-            Int32 id = DYNAMIC_START + i * DYNAMIC_ITEMS + DYNAMIC_SLIDER;
-            SetPercent(id, item.value);
+        if (IsScrolling()) {
+            SetInt32(SLIDER_SCROLL, m_first, 0, m_count - m_visible);
+            SetString(TEXT_RANGE, GeLoadString(IDS_FLOATLIST_RANGE,
+                    String::IntToString(m_first + 1),
+                    String::IntToString(m_first + m_visible),
+                    String::IntToString(m_count)));
         }
 
-        m_data = *data;
+        // The new names can be wider than the ones that were
+        // displayed before.
+        if (renamed)
+            LayoutChanged(GROUP_ROWS);
+    }
+
+    /**
+     * Scrolls the list so that the item at *first* is displayed
+     * in the first row. Returns false if the list did not move.
+     */
+    Bool ScrollTo(Int32 first) {
+        first = ClampFirst(first);
+        if (first == m_first)
+            return false;
+        m_first = first;
+        UpdateRows();
+        return true;
+    }
+
+    /**
+     * Sends the current data to the parent right away, eg. when
+     * the mouse is released after dragging a slider. Drops changes
+     * that are still queued since they are part of the data.
+     */
+    void CommitValueChanged(const BaseContainer& msg) {
+        m_queued = false;
+        SetTimer(0);
+        if (m_merged) {
+            // The changed values are written to all lists at once.
+            Bool undo = !m_dragging;
+            m_dragging = msg.GetBool(BFM_ACTION_INDRAG);
+            m_selection.SetValues(m_data, m_changed.GetFirst(), (Int32) m_changed.GetCount(), undo);
+            m_changed.Flush();
+        }
+        else {
+            if (m_encoding != FLOATLIST_ENCODING_DEFAULT)
+                m_data.SetEncoding(m_encoding);
+            GeData data(CUSTOMDATATYPE_FLOATLIST, m_data);
+            SendValueChanged(msg, data);
+        }
+        m_lastSent = GeGetTimer();
+    }
+
+    /**
+     * Sends the data if the last update is at least m_throttle
+     * milliseconds ago, otherwise starts a timer that sends it once
+     * the interval has passed. Every update the parent receives
+     * makes Cinema compare and copy the data, add an undo step and
+     * re-evaluate the scene, so collecting the changes of a drag
+     * keeps the viewport responsive.
+     */
+    void QueueValueChanged(const BaseContainer& msg) {
+        m_queuedMsg = msg;
+        m_queued = true;
+        if (GeGetTimer() - m_lastSent >= m_throttle)
+            FlushValueChanged();
+        else
+            SetTimer(m_throttle);
+    }
+
+    void FlushValueChanged() {
+        if (m_queued)
+            CommitValueChanged(m_queuedMsg);
+        else
+            SetTimer(0);
+    }
+
+    /**
+     * Merges the items of the lists of all selected nodes into
+     * m_data. The lists are only looked up again if the selection
+     * changed since the last call. Returns false if the lists can
+     * not be found, eg. because the GUI is not displayed in the
+     * Attribute Manager.
+     */
+    Bool MergeSelection() {
+        m_changed.Flush();
+        // The gadget ID is the ID of the parameter, see BFM_ACTION_ID.
+        if (m_stale) {
+            m_selection.Collect(GetActiveDocument(), GetId());
+            m_stale = false;
+        }
+        if (m_selection.GetCount() >= 2 && m_selection.Merge(m_data, m_differs))
+            return true;
+        m_differs.Flush();
+        return false;
     }
 
     // iCustomGui
 
     virtual Bool SetData(const TriState<GeData>& tristate) {
+        FLOATLIST_PROBE_SCOPE(FLOATLIST_PROBE_GUI_SETDATA);
         FloatlistData* temp = nullptr;
 
+        // The parent does not know about queued changes yet and
+        // would reset the sliders to the last value it received.
+        if (m_queued)
+            return true;
+
         // GetTri() returns true if any of the values added
         // to the tristate differed and a special tristate has
-        // to be displayed in the UI.
+        // to be displayed in the UI. The TriState only gives us
+        // the first value, so we look up the lists of all selected
+        // nodes to display the union of their items.
+        m_merged = tristate.GetTri() && MergeSelection();
+        if (m_merged) {
+            m_multiple = false;
+            Rebuild(&m_data);
+            UpdateRows();
+            return true;
+        }
+
         if (m_multiple && tristate.GetTri()) {
             // Nothing to do since we are still displaying multiple
             // values as info text in the dialog.
@@ -479,6 +1120,28 @@ public:
         return true;
     }
 
+    virtual Int32 Message(const BaseContainer& msg, BaseContainer& result) {
+        // Scroll long lists with the mouse wheel. The event is passed
+        // on at either end of the list so that the Attribute Manager
+        // scrolls instead.
+        if (msg.GetId() == BFM_INPUT && IsScrolling()
+                && msg.GetInt32(BFM_INPUT_DEVICE) == BFM_INPUT_MOUSE
+                && msg.GetInt32(BFM_INPUT_CHANNEL) == BFM_INPUT_MOUSEWHEEL) {
+            Int32 steps = msg.GetInt32(BFM_INPUT_VALUE) / 120;
+            if (ScrollTo(m_first - steps * WHEEL_ROWS))
+                return true;
+        }
+        return super::Message(msg, result);
+    }
+
+    virtual Bool CoreMessage(Int32 id, const BaseContainer& msg) {
+        // EVMSG_CHANGE is also sent for every value we change, so the
+        // active nodes are compared before the selection is dropped.
+        if (id == EVMSG_CHANGE && !m_stale && !m_selection.IsCurrent(GetActiveDocument()))
+            m_stale = true;
+        return super::CoreMessage(id, msg);
+    }
+
     virtual Bool Command(Int32 id, const BaseContainer& msg) {
         String name;
         Bool updateValue = false;
@@ -487,24 +1150,39 @@ public:
         switch (id) {
             case BUTTON_PLUS:
                 if (RenameDialog(&name)) {
-                    auto item = m_data.Append();
-                    if (item != nullptr) {
-                        item->name = name;
-                        item->value = 0.0;
+                    // Names must be unique in the list, otherwise
+                    // the subchannels can not be told apart. Merged
+                    // lists only receive the item if they lack it.
+                    if (m_merged)
+                        m_selection.Append(name, 0.0);
+                    else if (m_data.FindName(name) != NOTOK)
+                        MessageDialog(GeLoadString(IDS_FLOATLIST_DUPLICATENAME, name));
+                    else if (m_data.Append(name, 0.0)) {
+                        // Scroll to the new item once the list is
+                        // displayed again.
+                        m_first = Max<Int32>(count + 1 - m_rows, 0);
                         updateValue = true;
                     }
                 }
                 break;
+
+            case SLIDER_SCROLL: {
+                Int32 first;
+                GetInt32(SLIDER_SCROLL, first);
+                ScrollTo(first);
+                break;
+            }
         }
 
-        // Check if the changed parameter is one of the items of
+        // Check if the changed parameter is one of the rows of
         // the dynamic dialog group.
-        if (id >= DYNAMIC_START && id < DYNAMIC_START + count * DYNAMIC_ITEMS) {
+        if (id >= DYNAMIC_START && id < DYNAMIC_START + m_visible * DYNAMIC_ITEMS) {
 
             // Then calculate the kind of the item that was pressed
-            // and the index of the row.
+            // and the row, which displays the item at m_first + row.
             Int32 kind = (id - DYNAMIC_START) % DYNAMIC_ITEMS;
-            Int32 index = (id - DYNAMIC_START - kind) / DYNAMIC_ITEMS;
+            Int32 row = (id - DYNAMIC_START - kind) / DYNAMIC_ITEMS;
+            Int32 index = m_first + row;
 
             // We only want to do some of the stuff if the accessed row
             // is not out of the bounds (just to be safe).
@@ -517,28 +1195,43 @@ public:
 
                     // Assign it to the item and make sure the parent
                     // is notified about the changed data.
-                    auto& item = m_data[index];
-                    item.value = value;
+                    m_data.SetValue(index, value);
+                    if (m_merged) {
+                        m_differs[index] = false;
+                        m_changed.Append(m_data.GetNameId(index));
+                    }
                     updateValue = true;
                 }
 
                 // Or remove the item if the button was pressed.
                 if (kind == DYNAMIC_REMOVEBUTTON) {
-                    m_data.Erase(index);
-                    updateValue = true;
+                    if (m_merged)
+                        m_selection.Erase(m_data.GetNameId(index));
+                    else {
+                        m_data.Erase(index);
+                        updateValue = true;
+                    }
                 }
             }
         }
 
         // Update the value stored by the holder of the Custom GUI (ie.
         // the node or the dialog value) if that is requested.
+        // While a slider is dragged, the changes are collected and
+        // sent at most once per m_throttle milliseconds.
         if (updateValue) {
-            GeData data(CUSTOMDATATYPE_FLOATLIST, m_data);
-            SendValueChanged(msg, data);
+            if (m_throttle > 0 && msg.GetBool(BFM_ACTION_INDRAG))
+                QueueValueChanged(msg);
+            else
+                CommitValueChanged(msg);
         }
         return true;
     }
 
+    virtual void Timer(const BaseContainer& msg) {
+        FlushValueChanged();
+    }
+
 };
 
 /**
@@ -603,6 +1296,18 @@ public:
         return "FLOATLIST";
     }
 
+    virtual CustomProperty* GetProperties() {
+        // The properties that can be specified for a FLOATLIST
+        // parameter in a description resource.
+        static CustomProperty props[] = {
+            { CUSTOMTYPE_LONG, FLOATLIST_ENCODING, "ENCODING" },
+            { CUSTOMTYPE_LONG, FLOATLIST_ROWS, "ROWS" },
+            { CUSTOMTYPE_LONG, FLOATLIST_THROTTLE, "THROTTLE" },
+            { CUSTOMTYPE_END, 0, nullptr },
+        };
+        return props;
+    }
+
     virtual Int32 GetResourceDataType(Int32*& table) {
         // Report the IDs of the data types that this GUI is
         // compatible with. We are only compatible with the
@@ -622,6 +1327,12 @@ public:
  * Called from `src/main.cpp` on `PluginStart()`. This function registers
  * the Floatlist custom datatype and GUI to Cinema 4D.
  */
+extern Bool Register_FloatlistTrack(); // floatlist-track.cpp
+extern Bool Register_FloatlistSidecar(); // floatlist-sidecar.cpp
+extern Bool Register_FloatlistBenchmark(); // floatlist-benchmark.cpp
+extern void Free_FloatlistBenchmark(); // floatlist-benchmark.cpp
+extern Bool Register_FloatlistInstrumentation(); // floatlist-instrumentation.cpp
+
 Bool Register_Datatype_Floatlist() {
     if (!FloatlistDataType::Register()) {
         GePrint("DEBUG: Could not register FloatlistDataType");
@@ -631,6 +1342,33 @@ Bool Register_Datatype_Floatlist() {
         GePrint("DEBUG: Could not register FloatlistGuiData");
         return false;
     }
+    if (!Register_FloatlistTrack()) {
+        GePrint("DEBUG: Could not register the Floatlist track");
+        return false;
+    }
+    if (!Register_FloatlistSidecar()) {
+        GePrint("DEBUG: Could not register the Floatlist sidecar hook");
+        return false;
+    }
+    if (!Register_FloatlistBenchmark()) {
+        GePrint("DEBUG: Could not register the Floatlist benchmark");
+        return false;
+    }
+    if (!Register_FloatlistInstrumentation()) {
+        GePrint("DEBUG: Could not register the Floatlist instrumentation");
+        return false;
+    }
     return true;
 }
 
+/**
+ * Called from `src/main.cpp` on `PluginEnd()`. Releases the memory
+ * that is shared between all FloatlistData instances.
+ */
+void Free_Datatype_Floatlist() {
+    Free_FloatlistBenchmark();
+    FloatlistPool::Free();
+    FreeItemDescriptions();
+    FloatlistSymbols::Free();
+}
+
@@ -23,7 +23,11 @@
 #ifndef CINEMA4DSDK_CUSTOMGUI_FLOATLIST_H
 #define CINEMA4DSDK_CUSTOMGUI_FLOATLIST_H
 
+#include <atomic>
 #include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist-sidecar.h>
+#include <cinema4dsdk/datatype/floatlist-smallarray.h>
+#include <cinema4dsdk/datatype/floatlist-symbols.h>
 
 /**
  * This is the Plugin ID of the custom data type.
@@ -31,6 +35,56 @@
 static const Int32 CUSTOMDATATYPE_FLOATLIST = 1031955;
 static const Int32 CUSTOMGUI_FLOATLIST = 1031955;
 
+/**
+ * ID of the description property that selects how the values of
+ * a Floatlist parameter are stored in files. Can be set in the
+ * description resource with `FLOATLIST MY_LIST { ENCODING 3; }`
+ * or on the FloatlistData itself with SetEncoding(). The encoding
+ * is carried by the FloatlistData (copies and loaded lists keep
+ * it), lists that never got one use the default of the datatype.
+ */
+static const Int32 FLOATLIST_ENCODING = 10000;
+
+enum {
+    // The list has no encoding of its own, WriteData() uses the
+    // FLOATLIST_ENCODING of the datatype defaults. Never written.
+    FLOATLIST_ENCODING_DEFAULT = -1,
+
+    // Every value as a full Float (default).
+    FLOATLIST_ENCODING_RAW = 0,
+
+    // Lossless, differences of neighbouring values as variable
+    // length integers. Good for smooth ramps.
+    FLOATLIST_ENCODING_DELTA = 1,
+
+    // Lossless, runs of equal values. Good for masks that are
+    // mostly 0 or 1.
+    FLOATLIST_ENCODING_RLE = 2,
+
+    // Lossy, values are rounded to a grid so that the error is
+    // less than FloatlistData::TOLERANCE. Very compact for ramps
+    // and masks alike.
+    FLOATLIST_ENCODING_QUANTIZED = 3,
+};
+
+/**
+ * ID of the description property that sets the number of rows the
+ * FloatlistGui displays at once, `FLOATLIST MY_LIST { ROWS 10; }`.
+ * Longer lists are scrolled and only the visible rows have widgets.
+ */
+static const Int32 FLOATLIST_ROWS = 10001;
+static const Int32 FLOATLIST_ROWS_DEFAULT = 16;
+
+/**
+ * ID of the description property that sets the minimum interval in
+ * milliseconds between two updates the FloatlistGui sends while a
+ * slider is dragged, `FLOATLIST MY_LIST { THROTTLE 100; }`. The
+ * final value is always sent when the slider is released. 0 sends
+ * every change.
+ */
+static const Int32 FLOATLIST_THROTTLE = 10002;
+static const Int32 FLOATLIST_THROTTLE_DEFAULT = 50;
+
 /**
  * This class reflects the data that is being stored by the
  * custom data type and modifiable by the custom GUI. We will
@@ -38,78 +92,688 @@ static const Int32 CUSTOMGUI_FLOATLIST = 1031955;
  *
  * It is the same as the SplineData or the PriorityData but
  * specialized for our new custom GUI.
+ *
+ * The names and values are stored in two separate columns
+ * (structure of arrays) instead of one array of pairs. Passes
+ * that only touch the values (comparing, updating the sliders,
+ * evaluation) can then run over one contiguous block of Floats
+ * without striding over the names.
+ *
+ * The names are not stored as String objects but as IDs into
+ * the FloatlistSymbols table. Each list additionally keeps a
+ * small hash index from name ID to item index so that items can
+ * be found by name in constant time.
+ *
+ * Copies of a FloatlistData share their data until one of them
+ * is modified, since Cinema copies custom data very often (undo,
+ * GeData, cloning documents) while most copies are never changed.
+ *
+ * Very large lists can keep their values in a sidecar file next
+ * to the scene, see SetSidecar().
  */
 class FloatlistData : public CustomDataType {
 
 public:
+
+    /**
+     * Two values that differ by no more than this are considered
+     * equal when comparing lists.
+     */
+    static const Float TOLERANCE;
+
+    /**
+     * Orders two values the way FloatlistDataType::Compare() does.
+     * Values are equal if they fall into the same cell of a grid of
+     * TOLERANCE, so they are never more than TOLERANCE apart. Unlike
+     * comparing their difference this is transitive. NaN is equal to
+     * NaN and greater than all other values.
+     */
+    static Int32 CompareValues(Float a, Float b);
+
+    /**
+     * A reference to a single entry of the list. Since the name
+     * and value live in different arrays, this is not an actual
+     * element of the storage but a pair of references. It is
+     * invalidated by any call that changes the number of items
+     * and by copying the list. Use SetName() to rename an item.
+     */
     struct Item {
-        String name;
-        Float value;
+        const String& name;
+        Float& value;
+
+        Item(const String& name_, Float& value_) : name(name_), value(value_) { }
+    };
+
+    /**
+     * Read-only counterpart of the Item structure.
+     */
+    struct ConstItem {
+        const String& name;
+        const Float& value;
+
+        ConstItem(const String& name_, const Float& value_)
+        : name(name_), value(value_) { }
     };
 
 private:
-    maxon::BaseArray<Item> items;
+
+    /**
+     * Lists with up to this many items keep them inside the payload
+     * and have no hash index, so they need a single allocation.
+     */
+    static const Int SMALL_LIST = 8;
+
+    /**
+     * The actual storage of the list. It is reference counted and
+     * shared between copies of a FloatlistData, so that copying a
+     * list is O(1). It is only duplicated when a list that shares
+     * its payload is modified (copy-on-write).
+     */
+    struct Payload {
+
+        std::atomic<Int32> refs;
+
+        /**
+         * The value column, stored inside the payload for small
+         * lists. Empty while the values are mapped from a sidecar,
+         * use Values() to access them.
+         */
+        FloatlistSmallArray<Float, SMALL_LIST> values;
+
+        /**
+         * The mapped sidecar file that holds the values instead of
+         * the value column, or nullptr. Any change to the number of
+         * items copies the values back into the column, see Unmap().
+         */
+        FloatlistSidecar* sidecar;
+
+        /**
+         * The name column, index-aligned with the values. Each
+         * element is an ID returned by FloatlistSymbols::Intern()
+         * and holds a reference to its name, see ~Payload().
+         */
+        FloatlistSmallArray<Int32, SMALL_LIST> ids;
+
+        /**
+         * Open addressing hash index from name ID to item index with
+         * linear probing. Every slot contains the item index plus one
+         * or zero if it is unused. The number of slots is a power of
+         * two and at least twice the number of items. Empty for lists
+         * that never had more than SMALL_LIST items, FindNameId()
+         * scans the names of these.
+         */
+        maxon::BaseArray<Int32> slots;
+
+        /**
+         * Hash of the content, the sum of ItemHash() over all items.
+         * Updated on every modification through the API, but marked
+         * dirty when the values were handed out for writing with
+         * GetValuesW() or operator [] since these can be changed
+         * without us knowing.
+         */
+        std::atomic<UInt64> hash;
+        std::atomic<Bool> hashDirty;
+
+        /**
+         * The value block that was read from a file but not decoded
+         * yet, see FloatlistData::AssignEncoded(). It is decoded into
+         * the value column by Materialize() on the first access. The
+         * names are always decoded right away.
+         */
+        std::atomic<Bool> pending;
+        GeSpinlock pendingLock;
+        Int32 pendingCount;
+        Int32 pendingEncoding;
+        void* pendingValues;
+        Int pendingValuesSize;
+
+        /**
+         * The item indices sorted by value and by name ID, see
+         * FloatlistData::GetOrder(). Each order is built on the
+         * first request. Every modification invalidates the value
+         * order, the name order is only invalidated together with
+         * the name index.
+         */
+        maxon::BaseArray<Int32> valueOrder;
+        maxon::BaseArray<Int32> nameOrder;
+        std::atomic<Bool> valueOrderValid;
+        std::atomic<Bool> nameOrderValid;
+        GeSpinlock orderLock;
+
+        Payload()
+        : refs(1), values(), sidecar(nullptr), ids(), slots(), hash(0), hashDirty(false),
+          pending(false), pendingLock(), pendingCount(0),
+          pendingEncoding(FLOATLIST_ENCODING_RAW), pendingValues(nullptr),
+          pendingValuesSize(0),
+          valueOrder(), nameOrder(), valueOrderValid(false), nameOrderValid(false),
+          orderLock() { }
+
+        ~Payload() {
+            FloatlistSymbols::Release(ids.GetFirst(), (Int32) ids.GetCount());
+            DeleteMem(pendingValues);
+            FloatlistSidecar::Free(sidecar);
+        }
+
+        Int32 GetCount() const {
+            return (Int32) ids.GetCount();
+        }
+
+        Float* Values() {
+            return sidecar ? sidecar->GetValues() : values.GetFirst();
+        }
+
+        const Float* Values() const {
+            return sidecar ? sidecar->GetValues() : values.GetFirst();
+        }
+
+        /**
+         * Must be called after modifying values in place, so that
+         * a mapped sidecar writes them back when the list is saved.
+         */
+        void SetDirty(Int32 first, Int32 count) {
+            if (sidecar) sidecar->SetDirty(first, count);
+        }
+
+        /**
+         * Copies the values of a mapped sidecar into the value
+         * column and releases the mapping. Returns false on a memory
+         * error, in which case the values stay mapped.
+         */
+        Bool Unmap();
+
+        Bool CopyFrom(const Payload& other);
+        Bool IndexReserve(Int32 count);
+        void IndexInsert(Int32 index);
+        void IndexRemove(Int32 index);
+        void IndexRebuild();
+        Int32 FindNameId(Int32 id) const;
+
+        /**
+         * Returns the value or name order, building it if needed.
+         * Safe to be called from multiple threads. Returns nullptr
+         * on a memory error.
+         */
+        const Int32* GetOrder(Bool byName);
+
+        UInt64 ItemHash(Int32 index) const {
+            return FloatlistData::ItemHash(index, ids[index], Values()[index]);
+        }
+
+        void HashAdd(Int32 index) {
+            if (!hashDirty) hash += ItemHash(index);
+        }
+
+        void HashRemove(Int32 index) {
+            if (!hashDirty) hash -= ItemHash(index);
+        }
+
+        UInt64 GetHash();
+
+        /**
+         * Decodes the pending values if there are any. Safe to be
+         * called from multiple threads. Returns false if this call
+         * found the blocks to be corrupt, the payload is empty in
+         * that case.
+         */
+        Bool Materialize();
+
+    };
+
+    /**
+     * The payload of the list. Can be nullptr if the list is
+     * empty.
+     */
+    Payload* payload;
+
+    /**
+     * One of the FLOATLIST_ENCODING values, used when the list is
+     * written to a file. FLOATLIST_ENCODING_DEFAULT until it is set.
+     */
+    Int32 encoding;
+
+    /**
+     * The file that the values are written to when the list is
+     * saved, or an empty Filename to store them in the scene.
+     */
+    Filename sidecar;
+
+    /**
+     * The value that operator [] refers to when the list can not be
+     * detached. It belongs to this list, so the item stays valid as
+     * long as the list and no other list or thread shares it.
+     */
+    Float scratch;
+
+    static UInt32 HashId(Int32 id) {
+        return (UInt32) id * 2654435761u;
+    }
+
+    /**
+     * Hashes a single item. The value is quantized to the grid of
+     * CompareValues() before it is hashed, so items that compare
+     * equal have the same hash.
+     */
+    static UInt64 ItemHash(Int32 index, Int32 id, Float value);
+
+    /**
+     * Returns the payload after decoding pending data that was read
+     * from a file (see AssignEncoded()). Every method that reads the
+     * items goes through this.
+     */
+    Payload* Touch() const {
+        if (payload != nullptr && payload->pending)
+            payload->Materialize();
+        return payload;
+    }
+
+    /**
+     * Drops the reference to the payload and frees it if this was
+     * the last reference.
+     */
+    void Release();
+
+    /**
+     * Makes sure the payload is allocated and not shared with any
+     * other list so it can be modified. Must be called by every
+     * method that changes the list. Returns false on a memory error
+     * in which case the list is unchanged.
+     */
+    Bool Detach();
+
+    /**
+     * Interns the *count* names of a block read from a file into the
+     * name column of a new payload and frees the block. Releases the
+     * payload and returns false if that fails.
+     */
+    Bool AssignNames(Int32 count, void* names, Int namesSize);
 
 public:
 
-    FloatlistData() : items() { }
+    FloatlistData()
+    : payload(nullptr), encoding(FLOATLIST_ENCODING_DEFAULT), sidecar(), scratch(0.0) { }
 
-    FloatlistData(const FloatlistData& other) : items() {
-        items.CopyFrom(other.items);
+    FloatlistData(const FloatlistData& other)
+    : payload(other.payload), encoding(other.encoding), sidecar(), scratch(0.0) {
+        if (payload != nullptr)
+            payload->refs++;
+    }
+
+    ~FloatlistData() {
+        Release();
     }
 
     FloatlistData& operator = (const FloatlistData& other) {
-        items.Flush();
-        items.CopyFrom(other.items);
+        CopyFrom(other);
         return *this;
     }
 
-    Item& operator [] (Int32 i) {
-        return items[i];
-    }
+    /**
+     * Returns a writable reference to the item at *i*. This detaches
+     * the list from other lists that share its data. If that fails
+     * (out of memory), the item refers to a scratch value of this
+     * list that is reset to zero and not part of its items, writing
+     * to it has no effect. Use SetValue() to find out about such
+     * failures.
+     */
+    Item operator [] (Int32 i);
 
-    const Item& operator [] (Int32 i) const {
-        return items[i];
+    ConstItem operator [] (Int32 i) const {
+        Payload* p = Touch();
+        return ConstItem(FloatlistSymbols::Get(p->ids[i]), p->Values()[i]);
     }
 
-    Item* Append() {
-        return items.Append();
-    }
+    /**
+     * Appends a new item to the end of the list. Returns false
+     * if the memory could not be allocated, in which case the
+     * list stays unchanged. Names do not need to be unique, but
+     * FindName() will only report the first item of a name.
+     */
+    Bool Append(const String& name, Float value=0.0);
 
-    Bool Pop() {
-        return items.Pop();
+    /**
+     * Same as Append(), but takes a name ID that was returned
+     * by FloatlistSymbols::Intern(). The list takes its own
+     * reference to the name.
+     */
+    Bool AppendId(Int32 id, Float value=0.0);
+
+    /**
+     * Replaces the content of the list with *count* items from the
+     * specified columns. Both arrays are copied with a single memory
+     * copy and the index and hash are built once. The list takes
+     * its own references to the names. Returns false on a memory
+     * error, the list is empty in that case.
+     */
+    Bool Assign(const Int32* ids, const Float* values, Int32 count);
+
+    /**
+     * Replaces the content of the list with *count* items that are
+     * still encoded as read from a file, the value block encoded
+     * with *encoding* and the names as written by
+     * FloatlistCodec::EncodeNames(). The blocks must be allocated
+     * with NewMem() and are owned by the list afterwards, even if
+     * the method fails.
+     *
+     * Decoding is deferred until the items are accessed for the
+     * first time, so lists that are loaded but never used cost next
+     * to nothing. Copies made in between share the undecoded data.
+     * The names are interned right away though, so that the method
+     * fails if the name block is corrupt or the name table is full.
+     */
+    Bool AssignEncoded(Int32 count, Int32 encoding, void* values, Int valuesSize,
+                       void* names, Int namesSize);
+
+    /**
+     * Same as AssignEncoded(), but the values are read from the
+     * mapped *values* sidecar which must contain exactly *count*
+     * values. The list takes ownership of the sidecar and the names
+     * block, even if the method fails.
+     */
+    Bool AssignMapped(Int32 count, FloatlistSidecar* values, void* names, Int namesSize);
+
+    /**
+     * Decodes the data assigned with AssignEncoded() if that did not
+     * already happen. Returns false if the data was corrupt, in which
+     * case the list is empty afterwards. Call this when all items are
+     * needed anyway or to check a list after loading.
+     */
+    Bool Materialize() const {
+        return payload == nullptr || payload->Materialize();
     }
 
-    void Erase(Int32 index) {
-        items.Erase(index);
+    /**
+     * Returns true if the list still holds data that needs to be
+     * decoded on the first access.
+     */
+    Bool IsPending() const {
+        return payload != nullptr && payload->pending;
     }
 
+    Bool Pop();
+
+    void Erase(Int32 index);
+
     Int32 GetCount() const {
-        return items.GetCount();
+        return Touch() ? payload->GetCount() : 0;
     }
 
+    /**
+     * Makes sure that at least *count* items can be stored
+     * without re-allocating the columns.
+     */
+    Bool EnsureCapacity(Int32 count);
+
     void Flush() {
-        items.Flush();
+        Release();
     }
 
-    void CopyFrom(const FloatlistData& other) {
-        items.CopyFrom(other.items);
+    /**
+     * Makes this list share the data of *other*. This is O(1),
+     * the data is only duplicated when one of the lists is
+     * modified afterwards. The sidecar of *other* is not copied,
+     * see SetSidecar().
+     */
+    Bool CopyFrom(const FloatlistData& other);
+
+    Bool CopyTo(FloatlistData& other) const {
+        return other.CopyFrom(*this);
+    }
+
+    Int32 GetEncoding() const {
+        return encoding;
+    }
+
+    /**
+     * Sets the encoding that is used for the values when the list
+     * is written to a file. Does not change the values in memory.
+     * FLOATLIST_ENCODING_DEFAULT uses the default of the datatype.
+     */
+    void SetEncoding(Int32 encoding_) {
+        encoding = encoding_;
+    }
+
+    const Filename& GetSidecar() const {
+        return sidecar;
     }
 
-    void CopyTo(FloatlistData& other) const {
-        other.items.CopyFrom(items);
+    /**
+     * Sets the file that the values are stored in when the list is
+     * written to a scene, instead of storing them in the scene
+     * itself. Pass an empty Filename to store them in the scene
+     * again. Meant for lists with millions of values that are
+     * shared by many scenes or render jobs.
+     *
+     * When the list is loaded again, the sidecar is mapped into
+     * memory instead of being read, so only the pages that are
+     * actually accessed are loaded and they are shared with other
+     * processes that map the same file.
+     *
+     * The file is only written while the document that contains the
+     * list is saved, which the Floatlist scene hook marks (see
+     * FloatlistSidecar::BeginSave()). Lists that are written outside
+     * of a save store their values inline and do not keep the
+     * sidecar. Loading a scene fails if its sidecar is missing or
+     * was replaced by another save.
+     *
+     * The sidecar belongs to this list alone. Copies of it (duplicated
+     * objects, the clipboard, undo, values passed to SetParameter())
+     * do not inherit it and store their values in the scene, otherwise
+     * every copy would write its own values to the same file. Set the
+     * sidecar on the list that is stored in the node.
+     */
+    void SetSidecar(const Filename& path) {
+        sidecar = path;
     }
 
-    static FloatlistData* Alloc() {
-        return NewObj(FloatlistData);
+    /**
+     * Returns true if the values are currently read from a mapped
+     * sidecar file.
+     */
+    Bool IsMapped() const {
+        return payload != nullptr && payload->sidecar != nullptr;
     }
 
-    static void Free(FloatlistData* ptr) { // todo: add &
-        if (ptr == nullptr)
-            DebugStop();
-        DeleteObj(ptr);
+    /**
+     * Writes the values to the sidecar file set with SetSidecar().
+     * The file is replaced by a new one, never modified in place, as
+     * other processes can have it mapped. Lists that are mapped from
+     * that file write nothing if they were not modified and the file
+     * was not replaced since. The stamp of the file is stored in
+     * *stamp*, see FloatlistSidecar::Write(). Returns false if no
+     * sidecar is set or the file could not be written.
+     */
+    Bool WriteSidecar(UInt64* stamp=nullptr) const;
+
+    /**
+     * Returns true if this list currently shares its data with
+     * another list.
+     */
+    Bool IsShared() const {
+        return payload != nullptr && payload->refs > 1;
     }
 
+    /**
+     * Returns a read-only pointer to the value column. The
+     * pointer is valid for GetCount() elements and until the
+     * list is modified. Can be nullptr if the list is empty.
+     */
+    const Float* GetValuesR() const {
+        return Touch() ? payload->Values() : nullptr;
+    }
+
+    /**
+     * Returns a writable pointer to the value column. The same
+     * rules as for GetValuesR() apply. This detaches the list from
+     * other lists that share its data. Prefer SetValue() for single
+     * values, since writing through the pointer requires the hash
+     * to be recomputed.
+     */
+    Float* GetValuesW() {
+        if (!Detach())
+            return nullptr;
+        payload->hashDirty = true;
+        payload->SetDirty(0, payload->GetCount());
+        return payload->Values();
+    }
+
+    /**
+     * Returns a read-only pointer to the name ID column.
+     */
+    const Int32* GetNameIdsR() const {
+        return Touch() ? payload->ids.GetFirst() : nullptr;
+    }
+
+    Int32 GetNameId(Int32 i) const {
+        return Touch()->ids[i];
+    }
+
+    const String& GetName(Int32 i) const {
+        return FloatlistSymbols::Get(Touch()->ids[i]);
+    }
+
+    Float GetValue(Int32 i) const {
+        return Touch()->Values()[i];
+    }
+
+    /**
+     * Renames the item at *i*. Returns false if the name could
+     * not be interned.
+     */
+    Bool SetName(Int32 i, const String& name);
+
+    Bool SetValue(Int32 i, Float value);
+
+    /**
+     * Copies the values of the *count* items starting at *first* to
+     * *out*. Returns false if the range is out of bounds.
+     */
+    Bool GetValues(Int32 first, Int32 count, Float* out) const;
+
+    /**
+     * Copies the values of the *count* items at *indices* to *out*.
+     * Returns false if an index is out of bounds, in which case
+     * *out* is only partially filled.
+     */
+    Bool GetValues(const Int32* indices, Int32 count, Float* out) const;
+
+    /**
+     * Sets the values of the *count* items starting at *first* from
+     * *values* with a single detach. Returns false if the range is
+     * out of bounds or on a memory error.
+     */
+    Bool SetValues(Int32 first, Int32 count, const Float* values);
+
+    /**
+     * Sets the values of the *count* items at *indices* from
+     * *values*. Returns false if an index is out of bounds, in which
+     * case the values before it were already set.
+     */
+    Bool SetValues(const Int32* indices, Int32 count, const Float* values);
+
+    /**
+     * Whole-list arithmetic, see FloatlistKernels. The operations
+     * with a second list match the items by index (the first items
+     * up to the length of the shorter list) or, if *byName* is true,
+     * by name, in which case items without a match in *other* keep
+     * their value. Return false on a memory error.
+     */
+    Bool Add(const FloatlistData& other, Bool byName=false);
+    Bool Mul(const FloatlistData& other, Bool byName=false);
+    Bool Lerp(const FloatlistData& other, Float t, Bool byName=false);
+
+    /**
+     * value = value * scale + offset
+     */
+    Bool Affine(Float scale, Float offset=0.0);
+
+    /**
+     * Limits the values to [lo, hi], by default the range of the
+     * subchannel descriptions.
+     */
+    Bool Clamp(Float lo=0.0, Float hi=1.0);
+
+    /**
+     * Scales the values so that they sum up to one. Returns false
+     * if the sum is zero.
+     */
+    Bool Normalize();
+
+    Float GetSum() const;
+
+    /**
+     * Return the smallest and largest value, 0.0 for an empty list.
+     */
+    Float GetMin() const;
+    Float GetMax() const;
+
+    /**
+     * Replaces every value by `fn(value)` in a single pass over the
+     * value column. *fn* can be a function pointer or a lambda.
+     */
+    template <typename Fn>
+    Bool Apply(Fn fn) {
+        Int32 count = GetCount();
+        if (count <= 0)
+            return true;
+        Float* values = GetValuesW();
+        if (values == nullptr)
+            return false;
+        for (Int32 i=0; i < count; i++)
+            values[i] = fn(values[i]);
+        return true;
+    }
+
+    /**
+     * Returns a 64 bit hash of the names and values in the list.
+     * Lists that are equal in terms of FloatlistDataType::Compare()
+     * have the same hash, so lists with different hashes are known
+     * to be different. Equal hashes do not prove that the lists are
+     * equal, they can collide. This is O(1) unless the values were
+     * modified through GetValuesW() or operator [].
+     */
+    UInt64 GetHash() const {
+        return Touch() ? payload->GetHash() : 0;
+    }
+
+    /**
+     * Returns the index of the first item with the specified
+     * name or NOTOK if there is no such item.
+     */
+    Int32 FindName(const String& name) const {
+        Int32 id = FloatlistSymbols::Find(name);
+        return id == NOTOK ? NOTOK : FindNameId(id);
+    }
+
+    /**
+     * Returns the index of the first item with the specified
+     * name ID or NOTOK if there is no such item.
+     */
+    Int32 FindNameId(Int32 id) const {
+        return Touch() ? payload->FindNameId(id) : NOTOK;
+    }
+
+    /**
+     * Returns the indices of the items sorted by value or, if
+     * *byName* is true, by name ID (the order in which the names
+     * were interned, not alphabetical). Items with equal keys keep
+     * their relative order. The order is kept with the list and
+     * only rebuilt after the list was modified, so repeated calls
+     * on an unchanged list are O(1). The same rules as for
+     * GetValuesR() apply to the pointer. See FloatlistView for
+     * searching in the orders.
+     */
+    const Int32* GetOrder(Bool byName=false) const {
+        return Touch() ? payload->GetOrder(byName) : nullptr;
+    }
+
+    /**
+     * Allocate and free lists through the FloatlistPool, which
+     * re-uses freed instances.
+     */
+    static FloatlistData* Alloc();
+
+    static void Free(FloatlistData* ptr); // todo: add &
+
     static FloatlistData* Get(const GeData& data) {
         auto temp = data.GetCustomDataType(CUSTOMDATATYPE_FLOATLIST);
         return static_cast<FloatlistData*>(temp);
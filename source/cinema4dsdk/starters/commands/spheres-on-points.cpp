@@ -21,8 +21,10 @@
  *
  * description: This plugin command demonstrates how to access points
  *    of spline or polygon objects. It positions a sphere primitive
- *    object on each selected point of an object.
- * tags: command simple muchdoc point-object selections undos
+ *    object on each selected point of an object. A second command
+ *    creates a single polygon object with all spheres instead, which
+ *    scales to meshes with millions of points.
+ * tags: command simple muchdoc point-object selections undos modeling threads
  * level: beginner
  * read-before: create-cube.cpp group-objects.cpp
  */
@@ -30,11 +32,124 @@
 #include <c4d.h>
 
 static const Int32 PLUGIN_ID = 1031057;
+static const Int32 PLUGIN_ID_MERGED = 1031058;
+
+/**
+ * The number of segments of the spheres in the merged mode. Each
+ * sphere of the default primitive has hundreds of points, which
+ * adds up quickly with a sphere per point. With 8 segments a sphere
+ * still has about 50 points, so a mesh with 1,000,000 selected
+ * points becomes an object with about 50,000,000 points.
+ */
+static const Int32 MERGED_SEGMENTS = 8;
+
+/**
+ * The minimum number of spheres a thread copies in the merged mode.
+ * Below that, starting a thread costs more than it saves.
+ */
+static const Int32 SPHERES_PER_THREAD = 4096;
+static const Int32 MAX_THREADS = 64;
+
+/**
+ * Stores the indices of the selected points of a point object with
+ * *count* points in *indices*, or of all points if none is selected.
+ * A BaseSelect stores ranges of selected elements, walking these is
+ * much faster than asking IsSelected() for each point when only a
+ * few points of a large mesh are selected.
+ */
+static Bool GetSelectedPoints(const BaseSelect* selection, Int32 count,
+                              maxon::BaseArray<Int32>& indices)
+{
+    Int32 selcount = selection ? selection->GetCount() : 0;
+    if (!indices.EnsureCapacity(selcount > 0 ? selcount : count))
+        return false; // memory error
+
+    // If no point is selected at all, we will use all points.
+    if (selcount <= 0) {
+        for (Int32 i=0; i < count; i++)
+            indices.Append(i);
+        return true;
+    }
+
+    Int32 seg = 0, a, b;
+    while (selection->GetRange(seg++, count, &a, &b)) {
+        for (Int32 i=a; i <= b; i++)
+            indices.Append(i);
+    }
+    return true;
+}
+
+/**
+ * Copies the sphere *proto* to the points *indices[first]* to
+ * *indices[end - 1]* of the merged object. Each sphere writes to
+ * its own part of the point and polygon arrays, so the copies can
+ * be made by multiple threads at once.
+ */
+struct MergedSpheres {
+    const Vector* ppoints;
+    const CPolygon* ppolys;
+    Int32 pcnt;
+    Int32 vcnt;
+    const Vector* points;
+    const Int32* indices;
+    Vector* dpoints;
+    CPolygon* dpolys;
+
+    void Copy(Int32 first, Int32 end) const {
+        for (Int32 k=first; k < end; k++) {
+            const Vector& off = points[indices[k]];
+            Vector* dp = dpoints + (Int) k * pcnt;
+            for (Int32 j=0; j < pcnt; j++)
+                dp[j] = ppoints[j] + off;
+
+            const Int32 base = k * pcnt;
+            CPolygon* dv = dpolys + (Int) k * vcnt;
+            for (Int32 j=0; j < vcnt; j++) {
+                const CPolygon& p = ppolys[j];
+                dv[j] = CPolygon(p.a + base, p.b + base, p.c + base, p.d + base);
+            }
+        }
+    }
+};
+
+class MergedSpheresThread : public C4DThread {
+
+public:
+
+    MergedSpheresThread() : m_job(nullptr), m_first(0), m_end(0) { }
+
+    void Init(const MergedSpheres* job, Int32 first, Int32 end) {
+        m_job = job;
+        m_first = first;
+        m_end = end;
+    }
+
+    //| C4DThread Overrides
+
+    virtual void Main() {
+        m_job->Copy(m_first, m_end);
+    }
+
+    virtual const Char* GetThreadName() {
+        return "SpheresOnPoints";
+    }
+
+private:
+
+    const MergedSpheres* m_job;
+    Int32 m_first;
+    Int32 m_end;
+
+};
 
 class SpheresOnPointsCommand : public CommandData {
 
 public:
 
+    // With *merged* set to true, the command creates a single
+    // polygon object that contains all spheres.
+    SpheresOnPointsCommand(Bool merged) : m_merged(merged) { }
+
     //| CommandData Overrides
 
     // Called when the user invoked the command from the
@@ -46,22 +161,47 @@ public:
     // enabled (showing a checkmark)?
     virtual Int32 GetState(BaseDocument* doc);
 
+private:
+
+    // Creates one polygon object with a sphere on each of the
+    // *count* points at *indices*. Returns nullptr on failure.
+    PolygonObject* CreateMergedSpheres(const Vector* points, const Int32* indices, Int32 count);
+
+    Bool m_merged;
+
 };
 
 Bool Register_Starter_Command_SpheresOnPoints() {
     String help_string("C++ SDK Example Command Plugin: Generates spheres on "
                        "the selected points of an object. Works with "
                        "point/polygon objects only.");
-    CommandData* plugin_command = NewObj(SpheresOnPointsCommand);
+    CommandData* plugin_command = NewObj(SpheresOnPointsCommand, false);
     if (!plugin_command) return false;
 
-    return RegisterCommandPlugin(
+    Bool success = RegisterCommandPlugin(
             PLUGIN_ID,
             "starters/commands/Spheres on Points",
             PLUGINFLAG_COMMAND_HOTKEY,
             nullptr,
             help_string,
             plugin_command);
+    if (!success) return false;
+
+    // The same command class is registered a second time for the
+    // merged mode. Cinema 4D takes the ownership of each instance.
+    String merged_help("C++ SDK Example Command Plugin: Generates a single "
+                       "polygon object with a low-poly sphere on each "
+                       "selected point of an object.");
+    plugin_command = NewObj(SpheresOnPointsCommand, true);
+    if (!plugin_command) return false;
+
+    return RegisterCommandPlugin(
+            PLUGIN_ID_MERGED,
+            "starters/commands/Spheres on Points (Merged)",
+            PLUGINFLAG_COMMAND_HOTKEY,
+            nullptr,
+            merged_help,
+            plugin_command);
 }
 
 Bool SpheresOnPointsCommand::Execute(BaseDocument* doc) {
@@ -79,47 +219,55 @@ Bool SpheresOnPointsCommand::Execute(BaseDocument* doc) {
     const Vector* points = op->GetPointR();
     if (count <= 0 || !points) return false; // application error
 
-    // Retrieve the point selection and the number of selected
-    // points.
-    const BaseSelect* selection = op->GetPointS();
-    Int32 selcount = selection ? selection->GetCount() : 0;
+    // Collect the indices of the points we want a sphere on.
+    maxon::BaseArray<Int32> indices;
+    if (!GetSelectedPoints(op->GetPointS(), count, indices))
+        return false; // memory error
+
+    if (m_merged) {
+        PolygonObject* mesh = CreateMergedSpheres(points, indices.GetFirst(), (Int32) indices.GetCount());
+        if (!mesh) return false;
+
+        // A single object means a single undo entry, no matter
+        // how many points there are.
+        doc->StartUndo();
+        mesh->InsertUnder(op);
+        doc->AddUndo(UNDOTYPE_NEW, mesh);
+        doc->EndUndo();
+        EventAdd();
+        return true;
+    }
 
     Bool success = true;
 
-    // Start a new undo step and iterate over all points in
-    // the object.
+    // Start a new undo step and iterate over the points we
+    // collected.
     doc->StartUndo();
-    for (Int32 i=0; i < count; i++) {
-        // We only want to create spheres on selected points.
-        // However, if no point is selected at all, we will use
-        // all points.
-        Bool is_selected = selcount <= 0 || selection->IsSelected(i);
-        if (is_selected) {
-            // Allocate a new sphere primitive.
-            BaseObject* sphere = BaseObject::Alloc(Osphere);
-            if (!sphere) {
-                // Memory error, break out of the loop.
-                success = false;
-                break;
-            }
-
-            // Insert the sphere under the selected object.
-            doc->AddUndo(UNDOTYPE_NEW, sphere);
-            sphere->InsertUnder(op);
-
-            // And move it to the points' position.
-            Matrix matrix;
-            matrix.off = points[i];
-            sphere->SetMl(matrix);
-
-            // Send a message to the object that it was added
-            // to the document just recently. (Info: the sphere
-            // adds a Phong Tag to itself on this message, the
-            // same applies for many other primitive objects)
-            // Generally, message should always be sent when
-            // inserting a new object.
-            sphere->Message(MSG_MENUPREPARE);
+    for (Int32 k=0; k < indices.GetCount(); k++) {
+        // Allocate a new sphere primitive.
+        BaseObject* sphere = BaseObject::Alloc(Osphere);
+        if (!sphere) {
+            // Memory error, break out of the loop.
+            success = false;
+            break;
         }
+
+        // Insert the sphere under the selected object.
+        doc->AddUndo(UNDOTYPE_NEW, sphere);
+        sphere->InsertUnder(op);
+
+        // And move it to the points' position.
+        Matrix matrix;
+        matrix.off = points[indices[k]];
+        sphere->SetMl(matrix);
+
+        // Send a message to the object that it was added
+        // to the document just recently. (Info: the sphere
+        // adds a Phong Tag to itself on this message, the
+        // same applies for many other primitive objects)
+        // Generally, message should always be sent when
+        // inserting a new object.
+        sphere->Message(MSG_MENUPREPARE);
     }
 
     // Tear down everything.
@@ -128,6 +276,97 @@ Bool SpheresOnPointsCommand::Execute(BaseDocument* doc) {
     return success;
 }
 
+PolygonObject* SpheresOnPointsCommand::CreateMergedSpheres(
+        const Vector* points, const Int32* indices, Int32 count)
+{
+    if (count <= 0) return nullptr;
+
+    // Let Cinema create the polygons of a sphere primitive, we
+    // will copy them for every point. The primitive must be in
+    // a document to be converted.
+    AutoAlloc<BaseDocument> temp;
+    BaseObject* sphere = BaseObject::Alloc(Osphere);
+    if (!temp || !sphere) {
+        BaseObject::Free(sphere);
+        return nullptr; // memory error
+    }
+    sphere->SetParameter(DescID(PRIM_SPHERE_SUB), GeData(MERGED_SEGMENTS), DESCFLAGS_SET_0);
+    sphere->Message(MSG_MENUPREPARE);
+    temp->InsertObject(sphere, nullptr, nullptr);
+
+    ModelingCommandData mcd;
+    mcd.doc = temp;
+    mcd.op = sphere;
+    if (!SendModelingCommand(MCOMMAND_CURRENTSTATETOOBJECT, mcd)) return nullptr;
+    if (!mcd.result || mcd.result->GetCount() <= 0) return nullptr;
+
+    // We own the object that the command returned.
+    BaseObject* result = static_cast<BaseObject*>(mcd.result->GetIndex(0));
+    if (!result || !result->IsInstanceOf(Opolygon)) {
+        BaseObject::Free(result);
+        return nullptr;
+    }
+    AutoFree<PolygonObject> proto(static_cast<PolygonObject*>(result));
+
+    // Check that the merged object does not exceed the number of
+    // points and polygons an object can have.
+    const Int32 pcnt = proto->GetPointCount();
+    const Int32 vcnt = proto->GetPolygonCount();
+    if ((Int64) pcnt * count > LIMIT<Int32>::MAX || (Int64) vcnt * count > LIMIT<Int32>::MAX) {
+        GePrint("Spheres on Points: too many points for a single object.");
+        return nullptr;
+    }
+
+    PolygonObject* mesh = PolygonObject::Alloc(pcnt * count, vcnt * count);
+    if (!mesh) return nullptr; // memory error
+    mesh->SetName("Spheres");
+
+    // Copy the sphere once per point. The points are moved to the
+    // position of the point and the polygons refer to the points
+    // of their own copy.
+    MergedSpheres job;
+    job.ppoints = proto->GetPointR();
+    job.ppolys = proto->GetPolygonR();
+    job.pcnt = pcnt;
+    job.vcnt = vcnt;
+    job.points = points;
+    job.indices = indices;
+    job.dpoints = mesh->GetPointW();
+    job.dpolys = mesh->GetPolygonW();
+
+    // Large selections are split into one chunk per thread. Nothing
+    // touches the document until all threads are done.
+    MergedSpheresThread threads[MAX_THREADS];
+    Int32 threadCount = Min(Min(GeGetCurrentThreadCount(), MAX_THREADS), count / SPHERES_PER_THREAD);
+    if (threadCount <= 1) {
+        job.Copy(0, count);
+    }
+    else {
+        for (Int32 t=0; t < threadCount; t++) {
+            Int32 first = (Int32) ((Int) count * t / threadCount);
+            Int32 end = (Int32) ((Int) count * (t + 1) / threadCount);
+            threads[t].Init(&job, first, end);
+
+            // If a thread can not be started, we copy its chunk
+            // ourselves.
+            if (!threads[t].Start())
+                job.Copy(first, end);
+        }
+        for (Int32 t=0; t < threadCount; t++)
+            threads[t].Wait(false);
+    }
+
+    // Keep the smooth shading of the primitive.
+    BaseTag* phong = proto->GetTag(Tphong);
+    if (phong) {
+        BaseTag* clone = static_cast<BaseTag*>(phong->GetClone(COPYFLAGS_0, nullptr));
+        if (clone) mesh->InsertTag(clone);
+    }
+
+    mesh->Message(MSG_UPDATE);
+    return mesh;
+}
+
 Int32 SpheresOnPointsCommand::GetState(BaseDocument* doc) {
     if (!doc) return 0;
 
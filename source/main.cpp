@@ -22,10 +22,59 @@
  * description: registers all Cinema 4D SDK plugins
  */
 
+#include <cstdlib>
+#include <cstring>
 #include <c4d.h>
 
 extern Bool Register_Starters(); // src/starters/starters.cpp
 extern Bool Register_Datatype_Floatlist(); // src/datatype/floatlist.cpp
+extern void Free_Datatype_Floatlist(); // src/datatype/floatlist.cpp
+extern void ParseFloatlistBenchmarkArgs(C4DPL_CommandLineArgs* args); // src/datatype/floatlist-benchmark.cpp
+extern void Report_FloatlistInstrumentation(Bool reset); // src/datatype/floatlist-instrumentation.cpp
+
+/**
+ * The commands passed with `-cinema4dsdk-command <id>` on the command
+ * line, run when Cinema has finished starting. With
+ * `-cinema4dsdk-quit`, Cinema is closed afterwards. This allows the
+ * examples to be run and timed without any user interaction.
+ */
+static maxon::BaseArray<Int32> g_commands;
+static Bool g_quit = false;
+
+// The ID of Cinema's own "Quit" command in the Command Manager. The
+// SDK headers have no symbol for it.
+static const Int32 IDM_QUIT = 12104;
+
+static void ParseCommandLine(C4DPL_CommandLineArgs* args) {
+    for (Int32 i=0; i < args->argc; i++) {
+        const char* arg = args->argv[i];
+        if (!arg) continue;
+
+        // Arguments that we handle are set to nullptr so that
+        // Cinema does not complain about them.
+        if (strcmp(arg, "-cinema4dsdk-command") == 0 && i + 1 < args->argc && args->argv[i + 1]) {
+            Int32 id = (Int32) atoi(args->argv[i + 1]);
+            if (id <= 0 || !g_commands.Append(id))
+                GePrint("cinema4dsdk: invalid command " + String(args->argv[i + 1]));
+            args->argv[i] = nullptr;
+            args->argv[++i] = nullptr;
+        }
+        else if (strcmp(arg, "-cinema4dsdk-quit") == 0) {
+            g_quit = true;
+            args->argv[i] = nullptr;
+        }
+    }
+}
+
+static void RunCommandLine() {
+    for (Int32 i=0; i < g_commands.GetCount(); i++) {
+        GePrint("cinema4dsdk: running command " + String::IntToString(g_commands[i]));
+        CallCommand(g_commands[i]);
+    }
+    g_commands.Flush();
+    if (g_quit)
+        CallCommand(IDM_QUIT);
+}
 
 Bool PluginStart() {
     Register_Starters();
@@ -40,10 +89,24 @@ Bool PluginMessage(Int32 kind, void* pData) {
         // parameter descriptions and loading resource strings.
         case C4DPL_INIT_SYS:
             return ::resource.Init();
+
+        case C4DPL_COMMANDLINEARGS:
+            ParseCommandLine(static_cast<C4DPL_CommandLineArgs*>(pData));
+            ParseFloatlistBenchmarkArgs(static_cast<C4DPL_CommandLineArgs*>(pData));
+            break;
+
+        case C4DPL_PROGRAM_STARTED:
+            RunCommandLine();
+            break;
+
+        case C4DPL_ENDACTIVITY:
+            Report_FloatlistInstrumentation(true);
+            break;
     }
     return true;
 }
 
 void PluginEnd() {
+    Free_Datatype_Floatlist();
 }
 
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: checks that every mode of MSG_FLOATLIST_BATCH has the
+ *    same effect as the per-item calls
+ */
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist.h>
+#include <cinema4dsdk/datatype/floatlist-batch.h>
+#include "test.h"
+
+static Float BatchDouble(Float value, void* userdata) {
+    return value * *static_cast<Float*>(userdata);
+}
+
+int main() {
+    // FloatlistBatch::Execute() is what a node calls when it handles
+    // MSG_FLOATLIST_BATCH.
+    const Int32 count = 100;
+    FloatlistData list;
+    for (Int32 i=0; i < count; i++) {
+        if (!list.Append("batch" + String::IntToString(i), (Float) i))
+            return 1; // memory error
+    }
+
+    Float values[4];
+    const Int32 indices[4] = { 3, 97, 0, 50 };
+
+    FloatlistBatchMsg msg;
+    msg.mode = FloatlistBatchMsg::MODE_GET;
+    msg.first = 10;
+    msg.count = 4;
+    msg.values = values;
+    TestCheck(FloatlistBatch::Execute(list, msg) && msg.handled && msg.result
+              && values[0] == 10.0 && values[3] == 13.0, "Batch.Get (range)");
+
+    msg.indices = indices;
+    TestCheck(FloatlistBatch::Execute(list, msg) && values[0] == 3.0 && values[1] == 97.0
+              && values[2] == 0.0 && values[3] == 50.0, "Batch.Get (indices)");
+
+    // The copy shares the items, the batch must detach it.
+    FloatlistData copy(list);
+    for (Int32 i=0; i < 4; i++)
+        values[i] = -1.0 - i;
+    msg.mode = FloatlistBatchMsg::MODE_SET;
+    TestCheck(FloatlistBatch::Execute(copy, msg) && copy.GetValue(97) == -2.0
+              && copy.GetValue(50) == -4.0 && list.GetValue(97) == 97.0, "Batch.Set (indices)");
+
+    msg.indices = nullptr;
+    msg.first = count - 4;
+    TestCheck(FloatlistBatch::Execute(copy, msg) && copy.GetValue(count - 4) == -1.0
+              && copy.GetValue(count - 1) == -4.0, "Batch.Set (range)");
+
+    Float factor = 2.0;
+    msg.mode = FloatlistBatchMsg::MODE_APPLY;
+    msg.fn = BatchDouble;
+    msg.userdata = &factor;
+    Bool applied = FloatlistBatch::Execute(list, msg);
+    for (Int32 i=0; applied && i < count; i++)
+        applied = list.GetValue(i) == 2.0 * i;
+    TestCheck(applied, "Batch.Apply");
+
+    // Requests out of range fail but are still handled.
+    msg.mode = FloatlistBatchMsg::MODE_GET;
+    msg.first = count - 2;
+    msg.handled = false;
+    TestCheck(!FloatlistBatch::Execute(list, msg) && msg.handled && !msg.result,
+              "Batch.Get (out of range)");
+    return TestResult();
+}
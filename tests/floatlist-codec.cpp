@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: checks that every encoding of FloatlistCodec restores
+ *    the values and never takes more room than RAW
+ */
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist.h>
+#include <cinema4dsdk/datatype/floatlist-codec.h>
+#include "test.h"
+
+static void CheckCodec(const String& label, const Float* values, Int32 count) {
+    // Every encoding must restore the values (closer than the
+    // tolerance for QUANTIZED) and must never take more room than RAW.
+    maxon::BaseArray<UChar> encoded;
+    maxon::BaseArray<Float> decoded;
+    if (!TestCheck(decoded.Resize(count), "Codec." + label + " (memory)"))
+        return;
+    for (Int32 encoding=FLOATLIST_ENCODING_RAW; encoding <= FLOATLIST_ENCODING_QUANTIZED; encoding++) {
+        String name = "Codec." + label + " (encoding " + String::IntToString(encoding) + ")";
+        Int32 used = FloatlistCodec::Encode(values, count, encoding, encoded);
+        if (!TestCheck(used != NOTOK && FloatlistCodec::Decode(encoded.GetFirst(),
+                encoded.GetCount(), used, decoded.GetFirst(), count), name + " decodes"))
+            continue;
+        TestCheck((Int) encoded.GetCount() <= (Int) count * (Int) sizeof(Float),
+                  name + " is not larger than RAW");
+
+        Bool lossy = used == FLOATLIST_ENCODING_QUANTIZED;
+        Int32 differs = NOTOK;
+        for (Int32 i=0; differs == NOTOK && i < count; i++) {
+            Float error = Abs(decoded[i] - values[i]);
+            if (lossy ? !(error < FloatlistData::TOLERANCE) : error != 0.0)
+                differs = i;
+        }
+        TestCheck(differs == NOTOK, name + " restores the values");
+    }
+}
+
+int main() {
+    // A ramp compresses well with DELTA, a sine column with many
+    // distinct values does not and must fall back to RAW.
+    const Int32 count = 10000;
+    maxon::BaseArray<Float> ramp, sine;
+    if (!ramp.Resize(count) || !sine.Resize(count))
+        return 1; // memory error
+    for (Int32 i=0; i < count; i++) {
+        ramp[i] = (Float) i / count;
+        sine[i] = Sin((Float) i * 0.37) * 1000.0;
+    }
+
+    CheckCodec("Ramp", ramp.GetFirst(), count);
+    CheckCodec("Sine", sine.GetFirst(), count);
+
+    // Corrupt blocks must be rejected instead of read past.
+    maxon::BaseArray<UChar> encoded;
+    maxon::BaseArray<Float> decoded;
+    Int32 used = FloatlistCodec::Encode(ramp.GetFirst(), count, FLOATLIST_ENCODING_DELTA, encoded);
+    TestCheck(used != NOTOK && decoded.Resize(count) && !FloatlistCodec::Decode(
+            encoded.GetFirst(), encoded.GetCount() / 2, used, decoded.GetFirst(), count),
+            "Codec.Truncated is rejected");
+
+    // Deltas that run past the grid of QUANTIZED must be rejected
+    // without overflowing the sums: the marker, then two deltas of
+    // 2^61 (zigzag tokens of 2^62).
+    const UChar huge[] = { 0, 0, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40,
+                           0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x40 };
+    TestCheck(!FloatlistCodec::Decode(huge, sizeof(huge), FLOATLIST_ENCODING_QUANTIZED,
+            decoded.GetFirst(), 2), "Codec.Overflow is rejected");
+    return TestResult();
+}
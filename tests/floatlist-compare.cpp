@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: checks that the items of Floatlists are compared as a
+ *    total order and that equal lists have equal hashes
+ */
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist.h>
+#include "test.h"
+
+int main() {
+    const Float tol = FloatlistData::TOLERANCE;
+    const Float nan = std::nan("");
+
+    // Values closer than the TOLERANCE can still be different, but
+    // the result never contradicts itself.
+    Float a = 0.0, b = tol * 0.4, c = tol * 0.8;
+    TestCheck(FloatlistData::CompareValues(a, b) == 0 && FloatlistData::CompareValues(b, c) != 0
+              && FloatlistData::CompareValues(a, c) != 0, "Compare.Values (transitive)");
+    TestCheck(FloatlistData::CompareValues(b, c) == -FloatlistData::CompareValues(c, b),
+              "Compare.Values (antisymmetric)");
+    TestCheck(FloatlistData::CompareValues(nan, nan) == 0 && FloatlistData::CompareValues(nan, 1e300) == 1
+              && FloatlistData::CompareValues(-1e300, nan) == -1, "Compare.Values (NaN)");
+    TestCheck(FloatlistData::CompareValues(1e300, 2e300) == -1, "Compare.Values (large)");
+
+    // Lists with the same items that do not share their data.
+    FloatlistData x, y;
+    for (Int32 i=0; i < 100; i++) {
+        x.Append("item" + String::IntToString(i), i * 0.01);
+        y.Append("item" + String::IntToString(i), i * 0.01 + tol * 0.01);
+    }
+    x.Append("nan", nan);
+    y.Append("nan", nan);
+    TestCheck(x.GetHash() == y.GetHash(), "Compare.Hash (equal lists)");
+    y.SetValue(50, 0.5 + tol * 2.0);
+    TestCheck(x.GetHash() != y.GetHash(), "Compare.Hash (different lists)");
+    return TestResult();
+}
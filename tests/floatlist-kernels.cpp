@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: checks the Floatlist kernels against plain loops and
+ *    that the vectors and the scalar tail treat NaN the same
+ */
+
+#include <cmath>
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist-kernels.h>
+#include "test.h"
+
+int main() {
+    GePrint(String("Instruction set: ") + FloatlistKernels::GetInstructionSet());
+
+    // Odd sizes, so that every kernel also runs the scalar tail.
+    const Int count = 37;
+    Float a[count], b[count], dst[count];
+    for (Int i=0; i < count; i++) {
+        a[i] = Sin((Float) i) * 10.0;
+        b[i] = Cos((Float) i * 0.5);
+    }
+
+    Bool ok = true;
+    FloatlistKernels::Lerp(dst, a, b, 0.25, count);
+    for (Int i=0; i < count; i++)
+        ok = ok && dst[i] == a[i] + (b[i] - a[i]) * 0.25;
+    TestCheck(ok, "Kernels.Lerp");
+
+    ok = true;
+    FloatlistKernels::Clamp(dst, a, -1.0, 2.0, count);
+    for (Int i=0; i < count; i++)
+        ok = ok && dst[i] == (a[i] < -1.0 ? -1.0 : (a[i] > 2.0 ? 2.0 : a[i]));
+    TestCheck(ok, "Kernels.Clamp");
+
+    Float lo = a[0], hi = a[0], sum = 0.0;
+    for (Int i=0; i < count; i++) {
+        lo = a[i] < lo ? a[i] : lo;
+        hi = a[i] > hi ? a[i] : hi;
+        sum += a[i];
+    }
+    TestCheck(FloatlistKernels::Min(a, count) == lo && FloatlistKernels::Max(a, count) == hi,
+              "Kernels.Min/Max");
+    TestCheck(Abs(FloatlistKernels::Sum(a, count) - sum) < 1e-9, "Kernels.Sum");
+
+    // NaN is clamped to *lo* in the vectors and the tail alike.
+    const Float nan = std::nan("");
+    for (Int i=0; i < count; i++)
+        b[i] = nan;
+    ok = true;
+    FloatlistKernels::Clamp(dst, b, -1.0, 2.0, count);
+    for (Int i=0; i < count; i++)
+        ok = ok && dst[i] == -1.0;
+    TestCheck(ok, "Kernels.Clamp (NaN)");
+
+    // A leading NaN is replaced by the next value of its lane.
+    a[0] = nan;
+    a[1] = nan;
+    lo = a[2], hi = a[2];
+    for (Int i=2; i < count; i++) {
+        lo = a[i] < lo ? a[i] : lo;
+        hi = a[i] > hi ? a[i] : hi;
+    }
+    TestCheck(FloatlistKernels::Min(a, count) == lo && FloatlistKernels::Max(a, count) == hi,
+              "Kernels.Min/Max (NaN)");
+    return TestResult();
+}
@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: saves a document with a sidecar through the scene hook
+ *    and checks that a missing or replaced sidecar fails the load
+ */
+
+#include <c4d.h>
+#include <c4d_headless.h>
+#include <cinema4dsdk/datatype/floatlist.h>
+#include "test.h"
+
+static const Int32 ID_LIST = 1000;
+
+/**
+ * Returns the list that is stored in the container of *op*.
+ */
+static FloatlistData* GetList(BaseObject* op) {
+    const GeData* data = op->GetDataInstance()->GetDataPointer(ID_LIST);
+    if (!data) return nullptr;
+    return static_cast<FloatlistData*>(data->GetCustomDataType(CUSTOMDATATYPE_FLOATLIST));
+}
+
+int main(int argc, char** argv) {
+    headless::SetConsoleEcho(false);
+    if (!headless::Startup(argc, argv))
+        return 1;
+    headless::SetConsoleEcho(true);
+
+    Filename dir = Filename(String(argv[0])).GetDirectory();
+    Filename scene = dir + Filename("floatlist-sidecar.c4d");
+    Filename path = dir + Filename("floatlist-sidecar.flv");
+    GeFKill(scene);
+    GeFKill(path);
+
+    BaseDocument* doc = GetActiveDocument();
+    TestCheck(doc && doc->FindSceneHook(ID_FLOATLISTSAVEHOOK) != nullptr, "SceneHook");
+
+    // The list must be gone before Shutdown() frees the names.
+    const Int32 count = 2000;
+    BaseObject* op = BaseObject::Alloc(Onull);
+    if (!op) return 1;
+    doc->InsertObject(op, nullptr, nullptr);
+    {
+        FloatlistData list;
+        for (Int32 i=0; i < count; i++) {
+            if (!list.Append("sidecar" + String::IntToString(i), (Float) i * 0.5))
+                return 1; // memory error
+        }
+        op->SetParameter(DescID(ID_LIST), GeData(CUSTOMDATATYPE_FLOATLIST, list), DESCFLAGS_SET_0);
+    }
+
+    // The sidecar is set on the list in the container, copies of a
+    // list do not keep it.
+    FloatlistData* stored = GetList(op);
+    if (!stored) return 1;
+    stored->SetSidecar(path);
+
+    // Nothing marks the save but the scene hook.
+    Bool saved = SaveDocument(doc, scene, SAVEDOCUMENTFLAGS_0, FORMAT_C4DEXPORT);
+    TestCheck(saved && GeFExist(path) && !FloatlistSidecar::IsSaving(doc), "SaveDocument");
+
+    BaseDocument* loaded = LoadDocument(scene, SCENEFILTER_OBJECTS, nullptr);
+    FloatlistData* read = loaded && loaded->GetFirstObject() ? GetList(loaded->GetFirstObject()) : nullptr;
+    Bool same = read && read->IsMapped() && read->GetCount() == count;
+    for (Int32 i=0; same && i < count; i++)
+        same = read->GetValue(i) == (Float) i * 0.5 && read->GetName(i) == "sidecar" + String::IntToString(i);
+    TestCheck(same, "LoadDocument");
+
+    // Saving the loaded document again leaves the file as it is.
+    TestCheck(loaded && SaveDocument(loaded, scene, SAVEDOCUMENTFLAGS_0, FORMAT_C4DEXPORT)
+              && read->IsMapped(), "SaveDocument (mapped)");
+    BaseDocument::Free(loaded);
+
+    // Another save replaces the sidecar, the scene does not match it
+    // anymore.
+    maxon::BaseArray<Float> zeros;
+    if (!zeros.Resize(count)) return 1;
+    for (Int32 i=0; i < count; i++)
+        zeros[i] = 0.0;
+    FloatlistSidecar::Write(path, zeros.GetFirst(), count);
+    loaded = LoadDocument(scene, SCENEFILTER_OBJECTS, nullptr);
+    TestCheck(loaded == nullptr, "LoadDocument (replaced sidecar)");
+    BaseDocument::Free(loaded);
+
+    GeFKill(path);
+    loaded = LoadDocument(scene, SCENEFILTER_OBJECTS, nullptr);
+    TestCheck(loaded == nullptr, "LoadDocument (missing sidecar)");
+    BaseDocument::Free(loaded);
+
+    GeFKill(scene);
+    headless::Shutdown();
+    return TestResult();
+}
@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: checks the reference counting of the Floatlist symbol
+ *    table and that released IDs are re-used
+ */
+
+#include <c4d.h>
+#include <cinema4dsdk/datatype/floatlist.h>
+#include "test.h"
+
+static String Name(const Char* prefix, Int32 i) {
+    return String(prefix) + String::IntToString(i);
+}
+
+int main() {
+    const Int32 count = 2000;
+    Int32 ids[count];
+    for (Int32 i=0; i < count; i++)
+        ids[i] = FloatlistSymbols::Intern(Name("a", i));
+    Int32 highWater = FloatlistSymbols::GetCount();
+
+    // Interning a name again returns the same ID with another
+    // reference, which keeps the name alive after the first one
+    // was released.
+    Int32 again = FloatlistSymbols::Intern(Name("a", 5));
+    TestCheck(again == ids[5], "Symbols.Intern (same name)");
+    FloatlistSymbols::Release(ids, count);
+    TestCheck(FloatlistSymbols::GetLiveCount() == 1 && FloatlistSymbols::Find(Name("a", 5)) == again
+              && FloatlistSymbols::Find(Name("a", 7)) == NOTOK, "Symbols.Release");
+
+    Int32 released = ids[7];
+    UInt32 serial = FloatlistSymbols::GetSerial(released);
+    FloatlistSymbols::Release(again);
+    for (Int32 i=0; i < count; i++)
+        ids[i] = FloatlistSymbols::Intern(Name("b", i));
+    Bool found = true;
+    for (Int32 i=0; found && i < count; i++)
+        found = FloatlistSymbols::Find(Name("b", i)) == ids[i] && FloatlistSymbols::Get(ids[i]) == Name("b", i);
+    TestCheck(FloatlistSymbols::GetCount() == highWater && found, "Symbols.Intern (re-used IDs)");
+    TestCheck(FloatlistSymbols::GetSerial(released) != serial, "Symbols.GetSerial");
+
+    // Lists hold their own references.
+    {
+        FloatlistData list;
+        list.Append(Name("c", 0));
+        FloatlistData copy(list);
+        list.SetName(0, Name("c", 1));
+        TestCheck(FloatlistSymbols::Find(Name("c", 0)) != NOTOK
+                  && FloatlistSymbols::Find(Name("c", 1)) != NOTOK, "Symbols.FloatlistData");
+    }
+    TestCheck(FloatlistSymbols::Find(Name("c", 0)) == NOTOK
+              && FloatlistSymbols::Find(Name("c", 1)) == NOTOK, "Symbols.FloatlistData (released)");
+
+    FloatlistSymbols::Release(ids, count);
+    TestCheck(FloatlistSymbols::GetLiveCount() == 0, "Symbols.GetLiveCount");
+    FloatlistSymbols::Free();
+    return TestResult();
+}
@@ -0,0 +1,50 @@
+/**
+ * Copyright (c) 2014  Niklas Rosenstein
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ * description: the checks shared by the tests of the headless build,
+ *    each test is a program that returns 1 if any check failed
+ */
+
+#ifndef CINEMA4DSDK_TESTS_TEST_H
+#define CINEMA4DSDK_TESTS_TEST_H
+
+#include <c4d.h>
+
+/**
+ * Prints *name* and whether the check passed and remembers a
+ * failure for TestResult().
+ */
+inline Bool TestCheck(Bool ok, const String& name) {
+    static Bool failed = false;
+    if (!ok) failed = true;
+    if (name.GetLength() > 0)
+        GePrint("  " + name + (ok ? ": ok" : ": FAILED"));
+    return !failed;
+}
+
+/**
+ * The exit code of the test program, 1 if any check failed.
+ */
+inline int TestResult() {
+    return TestCheck(true, String()) ? 0 : 1;
+}
+
+#endif /* CINEMA4DSDK_TESTS_TEST_H */